@@ -0,0 +1,69 @@
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <limits>
+
+#include <vk2s/Device.hpp>
+
+// measures the CPU cost of recording commands through instance-level (loader trampoline) and device-level function pointers
+void dispatch(const uint32_t commandNum, const uint32_t iterationNum)
+{
+    try
+    {
+        vk2s::Device device(vk2s::Device::Extensions::useNothing(), vk2s::Device::Headless{});
+
+        for (const auto& phase : device.getStartupPhases())
+        {
+            std::cout << "startup " << phase.name << ": " << std::chrono::duration<double, std::milli>(phase.duration).count() << " ms\n";
+        }
+
+        vk::BufferCreateInfo ci({}, sizeof(uint32_t) * 4, vk::BufferUsageFlagBits::eTransferDst);
+        UniqueHandle<vk2s::Buffer> buffer = device.create<vk2s::Buffer>(ci, vk::MemoryPropertyFlagBits::eDeviceLocal);
+        const vk::Buffer vkBuffer         = buffer->getVkBuffer().get();
+
+        UniqueHandle<vk2s::Command> command   = device.create<vk2s::Command>();
+        const vk::CommandBuffer commandBuffer = command->getVkCommandBuffer().get();
+
+        // the default dispatcher has only instance-level pointers, every command goes through the loader trampoline
+        const auto& instanceDispatcher = VULKAN_HPP_DEFAULT_DISPATCHER;
+        // the pointers of the Device (used by Command) call the driver directly
+        const vk2s::VulkanDispatchLoader& deviceDispatcher = device.getVkDispatcher();
+
+        const auto measure = [&](const auto& dispatcher)
+        {
+            double best = std::numeric_limits<double>::max();
+            for (uint32_t i = 0; i < iterationNum; ++i)
+            {
+                commandBuffer.reset({}, dispatcher);
+                commandBuffer.begin(vk::CommandBufferBeginInfo(vk::CommandBufferUsageFlagBits::eOneTimeSubmit), dispatcher);
+
+                const auto begin = std::chrono::steady_clock::now();
+                for (uint32_t c = 0; c < commandNum; ++c)
+                {
+                    commandBuffer.fillBuffer(vkBuffer, (c % 4) * sizeof(uint32_t), sizeof(uint32_t), c, dispatcher);
+                }
+                const auto end = std::chrono::steady_clock::now();
+
+                commandBuffer.end(dispatcher);
+                best = std::min(best, std::chrono::duration<double, std::nano>(end - begin).count() / commandNum);
+            }
+
+            return best;
+        };
+
+        // warm up both paths once
+        measure(instanceDispatcher);
+        measure(deviceDispatcher);
+
+        const double instanceNs = measure(instanceDispatcher);
+        const double deviceNs   = measure(deviceDispatcher);
+
+        std::cout << "instance-level dispatch: " << instanceNs << " ns / command\n";
+        std::cout << "device-level dispatch  : " << deviceNs << " ns / command\n";
+        std::cout << "saved                  : " << instanceNs - deviceNs << " ns / command (" << (1. - deviceNs / instanceNs) * 100. << " %)\n";
+    }
+    catch (std::exception& e)
+    {
+        std::cerr << e.what() << "\n";
+    }
+}
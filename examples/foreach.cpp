@@ -0,0 +1,91 @@
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <limits>
+#include <vector>
+
+#include <vk2s/SlotMap.hpp>
+
+namespace
+{
+    // stand-in for a small vk2s object
+    struct Object
+    {
+        uint64_t value;
+        uint64_t padding[3];
+    };
+}  // namespace
+
+// measures Pool::forEach at several occupancy ratios against iterating the live handles with get()
+void poolForEach(const uint32_t objectNum, const uint32_t passNum)
+{
+    constexpr double kLiveRatios[] = { 1.0, 0.25, 0.05, 0.01 };
+
+    std::mt19937 engine(0);
+
+    for (const double liveRatio : kLiveRatios)
+    {
+        Pool<Object, 32> pool;
+
+        std::vector<Handle<Object, 32>> handles;
+        handles.reserve(objectNum);
+        for (uint32_t i = 0; i < objectNum; ++i)
+        {
+            handles.emplace_back(pool.allocate(Object{ .value = i }));
+        }
+
+        // release randomly chosen objects so that the live ones are scattered over every page
+        std::shuffle(handles.begin(), handles.end(), engine);
+        const auto liveNum = static_cast<size_t>(objectNum * liveRatio);
+        for (size_t i = liveNum; i < handles.size(); ++i)
+        {
+            pool.deallocate(handles[i]);
+        }
+        handles.resize(liveNum);
+
+        const auto measure = [&](const auto& iterate)
+        {
+            uint64_t sum  = 0;
+            double best   = std::numeric_limits<double>::max();
+            for (uint32_t pass = 0; pass < passNum; ++pass)
+            {
+                const auto begin = std::chrono::steady_clock::now();
+                sum += iterate();
+                const auto end = std::chrono::steady_clock::now();
+                best = std::min(best, std::chrono::duration<double, std::milli>(end - begin).count());
+            }
+
+            // keep the sum alive
+            if (sum == 0 && liveNum != 0)
+            {
+                std::cerr << "unexpected sum\n";
+            }
+
+            return best;
+        };
+
+        const double forEachMs = measure(
+            [&]()
+            {
+                uint64_t sum = 0;
+                pool.forEach([&](Object& object) { sum += object.value + 1; });
+                return sum;
+            });
+
+        // handles sorted by slot, the best case for get()
+        std::sort(handles.begin(), handles.end(), [](const auto& a, const auto& b) { return (a.getRawID() & 0xFFFFFFFF) < (b.getRawID() & 0xFFFFFFFF); });
+        const double handleMs = measure(
+            [&]()
+            {
+                uint64_t sum = 0;
+                for (const auto& handle : handles)
+                {
+                    sum += handle.get().value + 1;
+                }
+                return sum;
+            });
+
+        std::cout << static_cast<int>(liveRatio * 100) << "% live (" << liveNum << " / " << objectNum << "): forEach " << forEachMs << " ms, handles " << handleMs << " ms\n";
+    }
+}
@@ -8,6 +8,14 @@ void pathtracing(const uint32_t windowWidth, const uint32_t windowHeight, const
 
 void rasterize(const uint32_t windowWidth, const uint32_t windowHeight, const uint32_t frameCount);
 
+void dispatch(const uint32_t commandNum, const uint32_t iterationNum);
+
+void poolStress(const uint32_t threadNum, const uint32_t iterationNum);
+
+void poolForEach(const uint32_t objectNum, const uint32_t passNum);
+
+void poolBatch(const uint32_t threadNum, const uint32_t batchSize);
+
 int main()
 {
     constexpr uint32_t kWidth = 1000;
@@ -15,6 +23,14 @@ int main()
     constexpr uint32_t kFrameCount = 3;
 
     //rasterize(kWidth, kHeight, kFrameCount);
+
+    //dispatch(100000, 10);
+
+    //poolStress(8, 100000);
+
+    //poolForEach(1000000, 50);
+
+    //poolBatch(8, 1024);
     
     pathtracing(kWidth, kHeight, kFrameCount);
 
@@ -1,5 +1,7 @@
 #include <iostream>
 
+#include <vk2s/TransientAllocator.hpp>
+
 #include "utility.hpp"
 
 struct SceneUB  // std140
@@ -45,6 +47,7 @@ void pathtracing(const uint32_t windowWidth, const uint32_t windowHeight, const
 
         device.initImGui(window.get(), renderpass.get());
 
+        vk2s::GeometryArena arena(device, sizeof(vk2s::Vertex));
         std::vector<MeshInstance> meshInstances;
         Handle<vk2s::Buffer> materialBuffer;
         Handle<vk2s::Buffer> emitterBuffer;
@@ -53,23 +56,12 @@ void pathtracing(const uint32_t windowWidth, const uint32_t windowHeight, const
         std::vector<Handle<vk2s::Image>> materialTextures;
         auto sampler = device.create<vk2s::Sampler>(vk::SamplerCreateInfo());
 
-        load("../../examples/resources/model/CornellBox/CornellBox-Sphere.obj", device, meshInstances, materialBuffer, materialTextures, emitterBuffer, triEmitterBuffer, infiniteEmitterBuffer);
-        //load("../../examples/resources/model/SanMiguel/san-miguel.obj", device, meshInstances, materialBuffer, materialTextures, emitterBuffer, triEmitterBuffer, infiniteEmitterBuffer);
-        //load("../../examples/resources/model/WhiteFurneceTest/test.obj", device, meshInstances, materialBuffer, materialTextures, emitterBuffer, triEmitterBuffer, infiniteEmitterBuffer);
+        load("../../examples/resources/model/CornellBox/CornellBox-Sphere.obj", device, arena, meshInstances, materialBuffer, materialTextures, emitterBuffer, triEmitterBuffer, infiniteEmitterBuffer);
+        //load("../../examples/resources/model/SanMiguel/san-miguel.obj", device, arena, meshInstances, materialBuffer, materialTextures, emitterBuffer, triEmitterBuffer, infiniteEmitterBuffer);
+        //load("../../examples/resources/model/WhiteFurneceTest/test.obj", device, arena, meshInstances, materialBuffer, materialTextures, emitterBuffer, triEmitterBuffer, infiniteEmitterBuffer);
 
-        // create scene UB
-        Handle<vk2s::DynamicBuffer> sceneBuffer;
-        {
-            const auto size = sizeof(SceneUB) * frameCount;
-            sceneBuffer     = device.create<vk2s::DynamicBuffer>(vk::BufferCreateInfo({}, size, vk::BufferUsageFlagBits::eUniformBuffer), vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent, frameCount);
-        }
-
-        // create filter (compute) UB
-        Handle<vk2s::DynamicBuffer> filterBuffer;
-        {
-            const auto ubSize = sizeof(FilterUB) * frameCount;
-            filterBuffer      = device.create<vk2s::DynamicBuffer>(vk::BufferCreateInfo({}, ubSize, vk::BufferUsageFlagBits::eUniformBuffer), vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent, frameCount);
-        }
+        // per-frame scene and filter (compute) UBs
+        vk2s::TransientAllocator frameAllocator(device, vk::BufferUsageFlagBits::eUniformBuffer, 64 * 1024, std::max(sizeof(SceneUB), sizeof(FilterUB)));
 
         // create instance mapping UB
         Handle<vk2s::Buffer> instanceMapBuffer;
@@ -80,10 +72,10 @@ void pathtracing(const uint32_t windowWidth, const uint32_t windowHeight, const
 
             for (int i = 0; i < meshInstances.size(); ++i)
             {
-                const auto& mesh      = meshInstances[i];
+                const auto geometry   = arena.get(meshInstances[i].geometry);
                 auto& mapping         = meshMappings.emplace_back();
-                mapping.VBAddress     = mesh.vertexBuffer->getVkDeviceAddress();
-                mapping.IBAddress     = mesh.indexBuffer->getVkDeviceAddress();
+                mapping.VBAddress     = geometry.vertices.getVkDeviceAddress();
+                mapping.IBAddress     = geometry.indices.getVkDeviceAddress();
                 mapping.materialIndex = i;  // WARNING: simple
             }
 
@@ -131,7 +123,8 @@ void pathtracing(const uint32_t windowWidth, const uint32_t windowHeight, const
         // create BLAS
         for (auto& mesh : meshInstances)
         {
-            mesh.blas = device.create<vk2s::AccelerationStructure>(mesh.hostMesh.vertices.size(), sizeof(vk2s::Vertex), mesh.vertexBuffer.get(), mesh.hostMesh.indices.size() / 3, mesh.indexBuffer.get(), true);
+            const auto geometry = arena.get(mesh.geometry);
+            mesh.blas           = device.create<vk2s::AccelerationStructure>(geometry.vertices.count, sizeof(vk2s::Vertex), geometry.vertices.getVkDeviceAddress(), geometry.indices.count / 3, geometry.indices.getVkDeviceAddress(), true);
         }
 
         // deploy instances
@@ -332,11 +325,21 @@ void pathtracing(const uint32_t windowWidth, const uint32_t windowHeight, const
 
         auto computePipeline = device.create<vk2s::Pipeline>(cpi);
 
+        {
+            const auto stats = device.getPipelineCache().getStatistics();
+            std::cout << "pipeline cache: " << stats.cacheHitNum << " / " << stats.pipelineNum << " hits, "
+                      << std::chrono::duration<double, std::milli>(stats.hitTime + stats.missTime).count() << " ms creation, "
+                      << std::chrono::duration<double, std::milli>(stats.getEstimatedSavedTime()).count() << " ms saved (estimated)\n";
+
+            // memory usage versus budget after loading the scene
+            device.getMemoryAllocator().writeJson(std::cout);
+        }
+
         // create bindgroup
         auto bindGroup = device.create<vk2s::BindGroup>(bindLayout.get());
         bindGroup->bind(0, tlas.get());
         bindGroup->bind(1, vk::DescriptorType::eStorageImage, resultImage);
-        bindGroup->bind(2, vk::DescriptorType::eUniformBufferDynamic, sceneBuffer.get());
+        bindGroup->bind(2, vk::DescriptorType::eUniformBufferDynamic, frameAllocator.getBuffer().get());
         bindGroup->bind(3, vk::DescriptorType::eStorageBuffer, instanceMapBuffer.get());
         bindGroup->bind(4, vk::DescriptorType::eStorageBuffer, materialBuffer.get());
         if (!materialTextures.empty())
@@ -350,7 +353,7 @@ void pathtracing(const uint32_t windowWidth, const uint32_t windowHeight, const
 
         auto computeBindGroup = device.create<vk2s::BindGroup>(computeBindLayout.get());
         computeBindGroup->bind(0, vk::DescriptorType::eStorageImage, resultImage);
-        computeBindGroup->bind(1, vk::DescriptorType::eUniformBufferDynamic, filterBuffer.get());
+        computeBindGroup->bind(1, vk::DescriptorType::eUniformBufferDynamic, frameAllocator.getBuffer().get());
         computeBindGroup->bind(2, vk::DescriptorType::eStorageImage, computeResultImage);
 
         // create commands and sync objects
@@ -496,6 +499,8 @@ void pathtracing(const uint32_t windowWidth, const uint32_t windowHeight, const
             // wait and reset fence
             fences[now]->wait();
 
+            vk2s::TransientAllocator::Allocation sceneAllocation;
+            vk2s::TransientAllocator::Allocation filterAllocation;
             {  // write data
                 //clamp spp
                 inputSpp = std::min(kMaxSpp, std::max(1, inputSpp));
@@ -518,8 +523,9 @@ void pathtracing(const uint32_t windowWidth, const uint32_t windowHeight, const
                     .padding    = { 0.f },
                 };
 
-                sceneBuffer->write(&sceneUBO, sizeof(SceneUB), now * sceneBuffer->getBlockSize());
-                filterBuffer->write(&filterUBO, sizeof(FilterUB), now * filterBuffer->getBlockSize());
+                frameAllocator.beginFrame();
+                sceneAllocation  = frameAllocator.push(sceneUBO);
+                filterAllocation = frameAllocator.push(filterUBO);
             }
 
             // acquire next image from swapchain(window)
@@ -546,7 +552,7 @@ void pathtracing(const uint32_t windowWidth, const uint32_t windowHeight, const
 
             {  // trace ray
                 command->setPipeline(raytracePipeline);
-                command->setBindGroup(0, bindGroup.get(), { static_cast<uint32_t>(now * sceneBuffer->getBlockSize()) });
+                command->setBindGroup(0, bindGroup.get(), { sceneAllocation.getDynamicOffset() });
                 command->traceRays(shaderBindingTable.get(), windowWidth, windowHeight, 1);
             }
 
@@ -557,7 +563,7 @@ void pathtracing(const uint32_t windowWidth, const uint32_t windowHeight, const
 
                 command->imagePipelineBarrier(imgBarrier, vk::PipelineStageFlagBits::eRayTracingShaderKHR, vk::PipelineStageFlagBits::eComputeShader);
                 command->setPipeline(computePipeline);
-                command->setBindGroup(0, computeBindGroup.get(), { static_cast<uint32_t>(now * filterBuffer->getBlockSize()) });
+                command->setBindGroup(0, computeBindGroup.get(), { filterAllocation.getDynamicOffset() });
                 command->dispatch(windowWidth / 16 + 1, windowHeight / 16 + 1, 1);
             }
 
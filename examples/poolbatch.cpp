@@ -0,0 +1,180 @@
+#include <iostream>
+#include <atomic>
+#include <functional>
+#include <stdexcept>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include <vk2s/SlotMap.hpp>
+
+namespace
+{
+    // counts the live objects, throws on construction if asked to
+    struct Counted
+    {
+        Counted(std::atomic<int64_t>& liveNum, const uint32_t value, const bool fail = false)
+            : pLiveNum(&liveNum)
+            , value(value)
+        {
+            if (fail)
+            {
+                throw std::runtime_error("construction failed");
+            }
+            pLiveNum->fetch_add(1, std::memory_order_relaxed);
+        }
+
+        ~Counted()
+        {
+            pLiveNum->fetch_sub(1, std::memory_order_relaxed);
+        }
+
+        std::atomic<int64_t>* pLiveNum;
+        uint32_t value;
+    };
+
+    using CountedPool   = Pool<Counted, 64>;
+    using CountedHandle = Handle<Counted, 64>;
+
+    // whether every handle points to a live object holding first + its index
+    bool checkValues(const std::vector<CountedHandle>& handles, const uint32_t first)
+    {
+        for (uint32_t i = 0; i < handles.size(); ++i)
+        {
+            if (!handles[i] || handles[i]->value != first + i)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    void report(const char* name, const bool passed, bool& allPassed)
+    {
+        std::cout << name << ": " << (passed ? "passed" : "FAILED") << "\n";
+        allPassed &= passed;
+    }
+}  // namespace
+
+// checks Pool::allocateBatch / deallocateBatch: round trips, shrink, throwing constructors and concurrent batches mixed with single allocations
+void poolBatch(const uint32_t threadNum, const uint32_t batchSize)
+{
+    bool passed = true;
+
+    // round trip: the freed slots are reused by the next batch without growing the pool
+    {
+        std::atomic<int64_t> liveNum = 0;
+        CountedPool pool;
+
+        auto handles         = pool.allocateBatch(batchSize, [&](const size_t i) { return std::make_tuple(std::ref(liveNum), static_cast<uint32_t>(i)); });
+        bool ok              = checkValues(handles, 0) && liveNum == batchSize;
+        const size_t pageNum = pool.getStatistics().pageNum;
+        ok &= pool.deallocateBatch(handles) == batchSize && liveNum == 0;
+
+        handles = pool.allocateBatch(batchSize, [&](const size_t i) { return std::make_tuple(std::ref(liveNum), static_cast<uint32_t>(i + batchSize)); });
+        ok &= checkValues(handles, batchSize) && pool.getStatistics().pageNum == pageNum;
+
+        // handles already released are skipped
+        auto copies = handles;
+        ok &= pool.deallocateBatch(handles) == batchSize && pool.deallocateBatch(copies) == 0 && liveNum == 0;
+
+        report("batch round trip", ok, passed);
+    }
+
+    // shrink: emptied pages are released and the next batch allocates pages again, live handles stay valid
+    {
+        std::atomic<int64_t> liveNum = 0;
+        CountedPool pool;
+
+        auto kept     = pool.allocateBatch(batchSize, [&](const size_t i) { return std::make_tuple(std::ref(liveNum), static_cast<uint32_t>(i)); });
+        auto released = pool.allocateBatch(batchSize, [&](const size_t i) { return std::make_tuple(std::ref(liveNum), static_cast<uint32_t>(i)); });
+        pool.deallocateBatch(released);
+
+        bool ok = pool.shrink() > 0 && checkValues(kept, 0);
+
+        auto added = pool.allocateBatch(batchSize, [&](const size_t i) { return std::make_tuple(std::ref(liveNum), static_cast<uint32_t>(i + batchSize)); });
+        ok &= checkValues(kept, 0) && checkValues(added, batchSize) && liveNum == 2 * batchSize;
+
+        pool.deallocateBatch(kept);
+        pool.deallocateBatch(added);
+        ok &= liveNum == 0 && pool.getStatistics().liveObjectNum == 0;
+
+        report("batch with shrink", ok, passed);
+    }
+
+    // throwing constructor: the objects built by the batch are released and every reserved slot is returned
+    {
+        std::atomic<int64_t> liveNum = 0;
+        CountedPool pool;
+
+        const uint32_t failAt = batchSize / 2;
+        bool thrown           = false;
+        try
+        {
+            pool.allocateBatch(batchSize, [&](const size_t i) { return std::make_tuple(std::ref(liveNum), static_cast<uint32_t>(i), i == failAt); });
+        }
+        catch (const std::runtime_error&)
+        {
+            thrown = true;
+        }
+
+        bool ok = thrown && liveNum == 0 && pool.getStatistics().liveObjectNum == 0;
+
+        // the returned slots fill the same pages
+        const size_t pageNum = pool.getStatistics().pageNum;
+        auto handles         = pool.allocateBatch(batchSize, [&](const size_t i) { return std::make_tuple(std::ref(liveNum), static_cast<uint32_t>(i)); });
+        ok &= checkValues(handles, 0) && pool.getStatistics().pageNum == pageNum;
+        pool.deallocateBatch(handles);
+
+        report("batch with throwing constructor", ok, passed);
+    }
+
+    // concurrent batches mixed with single allocations
+    {
+        std::atomic<int64_t> liveNum = 0;
+        std::atomic<uint32_t> failedNum = 0;
+        CountedPool pool;
+
+        std::vector<std::thread> threads;
+        for (uint32_t t = 0; t < threadNum; ++t)
+        {
+            threads.emplace_back(
+                [&, t]()
+                {
+                    for (uint32_t round = 0; round < 16; ++round)
+                    {
+                        const uint32_t first = (t * 16 + round) * batchSize;
+                        auto handles         = pool.allocateBatch(batchSize, [&](const size_t i) { return std::make_tuple(std::ref(liveNum), static_cast<uint32_t>(first + i)); });
+
+                        std::vector<CountedHandle> singles;
+                        for (uint32_t i = 0; i < batchSize; ++i)
+                        {
+                            singles.emplace_back(pool.allocate(liveNum, first + i));
+                        }
+
+                        if (!checkValues(handles, first) || !checkValues(singles, first))
+                        {
+                            failedNum.fetch_add(1, std::memory_order_relaxed);
+                        }
+
+                        // release the batch one by one and the singles at once
+                        for (auto& handle : handles)
+                        {
+                            pool.deallocate(handle);
+                        }
+                        pool.deallocateBatch(singles);
+                    }
+                });
+        }
+
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+
+        report("concurrent batches", failedNum == 0 && liveNum == 0 && pool.getStatistics().liveObjectNum == 0, passed);
+    }
+
+    std::cout << "pool batch (" << threadNum << " threads, " << batchSize << " objects / batch): " << (passed ? "passed" : "FAILED") << "\n";
+}
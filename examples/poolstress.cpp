@@ -0,0 +1,208 @@
+#include <iostream>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include <vk2s/Device.hpp>
+
+namespace
+{
+    // counts the live objects to detect objects destroyed twice (or never)
+    struct Tracked
+    {
+        Tracked(std::atomic<int64_t>& liveNum, const uint32_t value)
+            : pLiveNum(&liveNum)
+            , value(value)
+        {
+            pLiveNum->fetch_add(1, std::memory_order_relaxed);
+        }
+
+        ~Tracked()
+        {
+            pLiveNum->fetch_sub(1, std::memory_order_relaxed);
+        }
+
+        std::atomic<int64_t>* pLiveNum;
+        uint32_t value;
+    };
+
+    // runs the function on threadNum threads released at the same time
+    template <typename Func>
+    void runThreads(const uint32_t threadNum, Func&& func)
+    {
+        std::atomic<bool> start = false;
+        std::vector<std::thread> threads;
+        threads.reserve(threadNum);
+        for (uint32_t t = 0; t < threadNum; ++t)
+        {
+            threads.emplace_back(
+                [&, t]()
+                {
+                    while (!start.load(std::memory_order_acquire))
+                    {
+                        std::this_thread::yield();
+                    }
+                    func(t);
+                });
+        }
+
+        start.store(true, std::memory_order_release);
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+    }
+}  // namespace
+
+// creates and destroys objects from several threads at once, checking the Pool and the Device for lost or doubly destroyed objects
+void poolStress(const uint32_t threadNum, const uint32_t iterationNum)
+{
+    bool passed = true;
+
+    // Pool: every thread allocates, checks and deallocates its own objects
+    {
+        std::atomic<int64_t> liveNum = 0;
+        std::atomic<uint32_t> corruptNum = 0;
+        Pool<Tracked, 64> pool;
+
+        const auto begin = std::chrono::steady_clock::now();
+        runThreads(threadNum,
+                   [&](const uint32_t t)
+                   {
+                       std::vector<Handle<Tracked, 64>> handles;
+                       for (uint32_t i = 0; i < iterationNum; ++i)
+                       {
+                           const uint32_t value = t * iterationNum + i;
+                           handles.emplace_back(pool.allocate(liveNum, value));
+
+                           // release in bursts to grow and reuse the pages concurrently
+                           if (handles.size() >= 256 || i + 1 == iterationNum)
+                           {
+                               const uint32_t first = value + 1 - static_cast<uint32_t>(handles.size());
+                               for (uint32_t j = 0; auto& handle : handles)
+                               {
+                                   if (handle->value != first + j)
+                                   {
+                                       corruptNum.fetch_add(1, std::memory_order_relaxed);
+                                   }
+                                   pool.deallocate(handle);
+                                   ++j;
+                               }
+                               handles.clear();
+                           }
+                       }
+                   });
+        const auto end = std::chrono::steady_clock::now();
+
+        std::cout << "pool alloc/dealloc: " << std::chrono::duration<double, std::nano>(end - begin).count() / (static_cast<double>(threadNum) * iterationNum) << " ns / object\n";
+        if (liveNum != 0 || corruptNum != 0 || pool.getStatistics().liveObjectNum != 0)
+        {
+            std::cerr << "pool alloc/dealloc: FAILED (live " << liveNum.load() << ", corrupt " << corruptNum.load() << ")\n";
+            passed = false;
+        }
+    }
+
+    // Pool: every thread releases the same handles, each object must be destroyed exactly once
+    {
+        std::atomic<int64_t> liveNum = 0;
+        std::atomic<uint32_t> releasedNum = 0;
+        Pool<Tracked, 64> pool;
+
+        std::vector<Handle<Tracked, 64>> shared;
+        shared.reserve(iterationNum);
+        for (uint32_t i = 0; i < iterationNum; ++i)
+        {
+            shared.emplace_back(pool.allocate(liveNum, i));
+        }
+
+        runThreads(threadNum,
+                   [&](const uint32_t t)
+                   {
+                       for (auto handle : shared)
+                       {
+                           if (pool.deallocate(handle))
+                           {
+                               releasedNum.fetch_add(1, std::memory_order_relaxed);
+                           }
+                       }
+                   });
+
+        if (liveNum != 0 || releasedNum != iterationNum)
+        {
+            std::cerr << "pool racing release: FAILED (live " << liveNum.load() << ", released " << releasedNum.load() << " / " << iterationNum << ")\n";
+            passed = false;
+        }
+    }
+
+    // Device: every thread creates Buffers and Commands, submits and destroys them (directly and deferred)
+    try
+    {
+        vk2s::Device device(vk2s::Device::Extensions::useNothing(), vk2s::Device::Headless{});
+
+        constexpr uint32_t kWordNum = 16;
+        std::atomic<uint32_t> mismatchNum = 0;
+
+        runThreads(threadNum,
+                   [&](const uint32_t t)
+                   {
+                       // the shared command pools can't be used from several threads, so each thread records from the pool of its own worker index
+                       UniqueHandle<vk2s::Command> command = device.create<vk2s::Command>(vk2s::QueueType::eCompute, 0u, t);
+                       for (uint32_t i = 0; i < iterationNum / 64 + 1; ++i)
+                       {
+                           vk::BufferCreateInfo ci({}, sizeof(uint32_t) * kWordNum, vk::BufferUsageFlagBits::eTransferDst);
+                           Handle<vk2s::Buffer> buffer = device.create<vk2s::Buffer>(ci, vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
+
+                           const uint32_t value = t * iterationNum + i;
+                           // the previous (unwaited) recording must be retired before resetting
+                           device.waitSubmission(command->getLastSubmissionIndex());
+                           command->reset();
+                           command->begin(true);
+                           command->fillBuffer(buffer.get(), 0, VK_WHOLE_SIZE, value);
+                           command->end();
+                           command->execute();
+
+                           if (i % 2 == 0)
+                           {
+                               device.waitSubmission(command->getLastSubmissionIndex());
+                               buffer->read(
+                                   [&](const void* p)
+                                   {
+                                       for (uint32_t w = 0; w < kWordNum; ++w)
+                                       {
+                                           if (static_cast<const uint32_t*>(p)[w] != value)
+                                           {
+                                               mismatchNum.fetch_add(1, std::memory_order_relaxed);
+                                           }
+                                       }
+                                   },
+                                   sizeof(uint32_t) * kWordNum);
+                               device.destroy(buffer);
+                           }
+                           else
+                           {
+                               // released by a later execute of any thread
+                               device.destroyDeferred(buffer);
+                           }
+                       }
+
+                       device.waitSubmission(command->getLastSubmissionIndex());
+                   });
+
+        device.waitIdle();
+        device.releaseRetiredObjects();
+
+        if (mismatchNum != 0 || device.getPoolStatistics<vk2s::Buffer>().liveObjectNum != 0)
+        {
+            std::cerr << "device create/submit/destroy: FAILED (mismatch " << mismatchNum.load() << ", live " << device.getPoolStatistics<vk2s::Buffer>().liveObjectNum << ")\n";
+            passed = false;
+        }
+    }
+    catch (std::exception& e)
+    {
+        std::cerr << e.what() << "\n";
+        passed = false;
+    }
+
+    std::cout << "pool stress (" << threadNum << " threads): " << (passed ? "passed" : "FAILED") << "\n";
+}
@@ -54,15 +54,30 @@ void rasterize(uint32_t windowWidth, uint32_t windowHeight, const uint32_t frame
         device.initImGui(window.get(), renderpass.get());
 
         // load meshes and materials
+        vk2s::GeometryArena arena(device, sizeof(vk2s::Vertex));
         std::vector<MeshInstance> meshInstances;
         Handle<vk2s::Buffer> materialBuffer;
         Handle<vk2s::Buffer> emitterBuffer;
         Handle<vk2s::Buffer> triEmitterBuffer;
         Handle<vk2s::Buffer> infiniteEmitterBuffer;
         std::vector<Handle<vk2s::Image>> materialTextures;
-        auto sampler = device.create<vk2s::Sampler>(vk::SamplerCreateInfo());
-
-        load("../../examples/resources/model/CornellBox/CornellBox-Sphere.obj", device, meshInstances, materialBuffer, materialTextures, emitterBuffer, triEmitterBuffer, infiniteEmitterBuffer);
+        // trilinear filtering over the mip chains of the textures
+        vk::SamplerCreateInfo samplerInfo;
+        samplerInfo.magFilter  = vk::Filter::eLinear;
+        samplerInfo.minFilter  = vk::Filter::eLinear;
+        samplerInfo.mipmapMode = vk::SamplerMipmapMode::eLinear;
+        samplerInfo.maxLod     = VK_LOD_CLAMP_NONE;
+        auto sampler           = device.create<vk2s::Sampler>(samplerInfo);
+
+        load("../../examples/resources/model/CornellBox/CornellBox-Sphere.obj", device, arena, meshInstances, materialBuffer, materialTextures, emitterBuffer, triEmitterBuffer, infiniteEmitterBuffer);
+
+        // the arena is never compacted here, so the slices are resolved once instead of per draw
+        std::vector<vk2s::GeometryArena::Mesh> meshGeometries;
+        meshGeometries.reserve(meshInstances.size());
+        for (const auto& mesh : meshInstances)
+        {
+            meshGeometries.emplace_back(arena.get(mesh.geometry));
+        }
 
         // craete shaders
         auto vertexShader   = device.create<vk2s::Shader>("../../examples/shaders/rasterize/vertex.vert", "main");
@@ -193,6 +208,10 @@ void rasterize(uint32_t windowWidth, uint32_t windowHeight, const uint32_t frame
             const auto& lookAt = camera.getLookAt();
             ImGui::Text("pos = (%lf, %lf, %lf)", pos.x, pos.y, pos.z);
             ImGui::Text("lookat = (%lf, %lf, %lf)", lookAt.x, lookAt.y, lookAt.z);
+            for (const auto& result : device.getProfiler().getResults())
+            {
+                ImGui::Text("%s = %lf ms (avg %lf ms)", result.name.c_str(), result.lastMs, result.averageMs);
+            }
 
             ImGui::End();
 
@@ -231,6 +250,7 @@ void rasterize(uint32_t windowWidth, uint32_t windowHeight, const uint32_t frame
             }
 
             fences[now]->reset();
+            device.getProfiler().beginFrame();
 
             {  // write data
                 SceneUB sceneUBO{
@@ -250,18 +270,33 @@ void rasterize(uint32_t windowWidth, uint32_t windowHeight, const uint32_t frame
             command->setPipeline(graphicsPipeline);
             command->setBindGroup(0, sceneBindGroup.get(), { now * static_cast<uint32_t>(sceneBuffer->getBlockSize()) });
 
-            for (uint32_t i = 0; auto& mesh : meshInstances)
+            command->beginProfileScope("meshes", true);
+            // meshes sharing an arena block are drawn without rebinding
+            const vk2s::Buffer* pBoundVB = nullptr;
+            const vk2s::Buffer* pBoundIB = nullptr;
+            for (uint32_t i = 0; const auto& geometry : meshGeometries)
             {
                 command->setBindGroup(1, materialBindGroups[i].get());
-                command->bindVertexBuffer(mesh.vertexBuffer.get());
-                command->bindIndexBuffer(mesh.indexBuffer.get());
+                if (pBoundVB != &geometry.vertices.buffer.get())
+                {
+                    command->bindVertexBuffer(geometry.vertices.buffer.get());
+                    pBoundVB = &geometry.vertices.buffer.get();
+                }
+                if (pBoundIB != &geometry.indices.buffer.get())
+                {
+                    command->bindIndexBuffer(geometry.indices.buffer.get());
+                    pBoundIB = &geometry.indices.buffer.get();
+                }
 
-                command->drawIndexed(mesh.hostMesh.indices.size(), 1, 0, 0, 1);
+                command->drawIndexed(geometry.indices.count, 1, geometry.indices.getFirstElement(), geometry.vertices.getFirstElement(), 1);
 
                 ++i;
             }
+            command->endProfileScope();
 
+            command->beginProfileScope("imgui");
             command->drawImGui();
+            command->endProfileScope();
             command->endRenderPass();
 
             // end writing commands
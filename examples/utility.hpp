@@ -1,5 +1,6 @@
 
 #include <vk2s/Device.hpp>
+#include <vk2s/GeometryArena.hpp>
 #include <vk2s/Scene.hpp>
 #include <vk2s/Camera.hpp>
 
@@ -30,13 +31,12 @@ struct EmitterUB
 struct MeshInstance
 {
     vk2s::Mesh hostMesh;
-    Handle<vk2s::Buffer> vertexBuffer;
-    Handle<vk2s::Buffer> indexBuffer;
+    vk2s::GeometryArena::MeshID geometry;
 
-    Handle<vk2s::AccelerationStructure> blas;
+    CompactHandle<vk2s::AccelerationStructure> blas;
 };
 
-inline void load(std::string_view path, vk2s::Device& device, std::vector<MeshInstance>& meshInstances, Handle<vk2s::Buffer>& materialUB, std::vector<Handle<vk2s::Image>>& materialTextures, Handle<vk2s::Buffer>& emitterUB,
+inline void load(std::string_view path, vk2s::Device& device, vk2s::GeometryArena& arena, std::vector<MeshInstance>& meshInstances, Handle<vk2s::Buffer>& materialUB, std::vector<Handle<vk2s::Image>>& materialTextures, Handle<vk2s::Buffer>& emitterUB,
                  Handle<vk2s::Buffer>& triEmitterUB, Handle<vk2s::Buffer>& infiniteEmitterUB)
 {
     //std::vector<vk2s::Mesh> hostMeshes;
@@ -56,31 +56,17 @@ inline void load(std::string_view path, vk2s::Device& device, std::vector<MeshIn
     meshInstances.resize(hostMeshes.size());
     for (size_t i = 0; i < meshInstances.size(); ++i)
     {
-        auto& mesh           = meshInstances[i];
-        mesh.hostMesh        = hostMeshes[i];
-        const auto& hostMesh = meshInstances[i].hostMesh;
-
-        {  // vertex buffer
-            const auto vbSize  = hostMesh.vertices.size() * sizeof(vk2s::Vertex);
-            const auto vbUsage = vk::BufferUsageFlagBits::eVertexBuffer | vk::BufferUsageFlagBits::eAccelerationStructureBuildInputReadOnlyKHR | vk::BufferUsageFlagBits::eShaderDeviceAddress | vk::BufferUsageFlagBits::eStorageBuffer;
-            vk::BufferCreateInfo ci({}, vbSize, vbUsage);
-            vk::MemoryPropertyFlags fb = vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent;
-
-            mesh.vertexBuffer = device.create<vk2s::Buffer>(ci, fb);
-            mesh.vertexBuffer->write(hostMesh.vertices.data(), vbSize);
-        }
-
-        {  // index buffer
-
-            const auto ibSize  = hostMesh.indices.size() * sizeof(uint32_t);
-            const auto ibUsage = vk::BufferUsageFlagBits::eIndexBuffer | vk::BufferUsageFlagBits::eAccelerationStructureBuildInputReadOnlyKHR | vk::BufferUsageFlagBits::eShaderDeviceAddress | vk::BufferUsageFlagBits::eStorageBuffer;
+        meshInstances[i].hostMesh = hostMeshes[i];
+    }
 
-            vk::BufferCreateInfo ci({}, ibSize, ibUsage);
-            vk::MemoryPropertyFlags fb = vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent;
+    // geometry and textures are uploaded in a single submission
+    auto& uploader = device.getUploader();
 
-            mesh.indexBuffer = device.create<vk2s::Buffer>(ci, fb);
-            mesh.indexBuffer->write(hostMesh.indices.data(), ibSize);
-        }
+    // pack all vertices / indices into the arena (device local, written through the uploader)
+    for (auto& mesh : meshInstances)
+    {
+        const auto& hostMesh = mesh.hostMesh;
+        mesh.geometry        = arena.add(hostMesh.vertices.data(), static_cast<uint32_t>(hostMesh.vertices.size()), hostMesh.indices.data(), static_cast<uint32_t>(hostMesh.indices.size()));
     }
 
     // materials
@@ -95,6 +81,11 @@ inline void load(std::string_view path, vk2s::Device& device, std::vector<MeshIn
 
     std::vector<vk2s::Texture> textures = scene.getTextures();
 
+    // every texture is uploaded by a single batch (texels of the host textures are kept until then)
+    std::vector<vk2s::Uploader::ImageUpload> textureUploads;
+    textureUploads.reserve(textures.size() + 1);
+    const uint8_t dummyData[4] = { 255, 0, 255, 255 };
+
     for (const auto& hostTex : textures)
     {
         auto& tex       = materialTextures.emplace_back();
@@ -105,13 +96,13 @@ inline void load(std::string_view path, vk2s::Device& device, std::vector<MeshIn
         ci.extent        = vk::Extent3D(hostTex.width, hostTex.height, 1);
         ci.format        = vk::Format::eR8G8B8A8Srgb;
         ci.imageType     = vk::ImageType::e2D;
-        ci.mipLevels     = 1;
-        ci.usage         = vk::ImageUsageFlagBits::eSampled | vk::ImageUsageFlagBits::eTransferDst;
+        ci.mipLevels     = vk2s::Image::calcMipLevels(hostTex.width, hostTex.height);  // generated by the uploader
+        ci.usage         = vk::ImageUsageFlagBits::eSampled | vk::ImageUsageFlagBits::eTransferDst | vk::ImageUsageFlagBits::eTransferSrc;
         ci.initialLayout = vk::ImageLayout::eUndefined;
 
         tex = device.create<vk2s::Image>(ci, vk::MemoryPropertyFlagBits::eDeviceLocal, size, vk::ImageAspectFlagBits::eColor);
 
-        tex->write(hostTex.pData, size);
+        textureUploads.emplace_back(vk2s::Uploader::ImageUpload{ .image = tex, .pData = hostTex.pData, .size = size });
     }
 
     // if textures are empty, add dummy texture
@@ -133,10 +124,11 @@ inline void load(std::string_view path, vk2s::Device& device, std::vector<MeshIn
 
         dummyTex = device.create<vk2s::Image>(ci, vk::MemoryPropertyFlagBits::eDeviceLocal, size, vk::ImageAspectFlagBits::eColor);
 
-        uint8_t dummyData[4] = { 255, 0, 255, 255 };
-        dummyTex->write(dummyData, size);
+        textureUploads.emplace_back(vk2s::Uploader::ImageUpload{ .image = dummyTex, .pData = dummyData, .size = size });
     }
 
+    uploader.uploadBatch(textureUploads);
+
     // emitter
     std::vector<vk2s::TriEmitter> triEmitters = scene.getTriEmitters();
 
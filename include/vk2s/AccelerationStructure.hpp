@@ -44,6 +44,11 @@ namespace vk2s
          */
         AccelerationStructure(Device& device, const uint32_t vertexNum, const uint32_t vertexStride, Buffer& vertexBuffer, const uint32_t faceNum, Buffer& indexBuffer, const bool motion = false, const Handle<Command>& buildCommand = Handle<Command>());
 
+        /**
+         * @brief  create as BLAS from the device addresses of the vertices and indices (e.g. GeometryArena::Slice::getVkDeviceAddress())
+         */
+        AccelerationStructure(Device& device, const uint32_t vertexNum, const uint32_t vertexStride, const vk::DeviceAddress vertexAddress, const uint32_t faceNum, const vk::DeviceAddress indexAddress, const bool motion = false, const Handle<Command>& buildCommand = Handle<Command>());
+
         /**
          * @brief  create as TLAS
          */
@@ -65,6 +70,11 @@ namespace vk2s
          */
         void build(const uint32_t vertexNum, const uint32_t vertexStride, Buffer& vertexBuffer, const uint32_t faceNum, Buffer& indexBuffer, const bool motion = false, const Handle<Command>& buildCommand = Handle<Command>());
 
+        /**
+         * @brief  build this AS as BLAS from the device addresses of the vertices and indices
+         */
+        void build(const uint32_t vertexNum, const uint32_t vertexStride, const vk::DeviceAddress vertexAddress, const uint32_t faceNum, const vk::DeviceAddress indexAddress, const bool motion = false, const Handle<Command>& buildCommand = Handle<Command>());
+
         /**
          * @brief  build this AS as TLAS
          */
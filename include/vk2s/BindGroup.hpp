@@ -41,8 +41,10 @@ namespace vk2s
     public:  // methods
         /**
          * @brief  constructor
+         *
+         * @param transient if true, the descriptor set is allocated from the per-frame pools of the Device and is valid only until Device::advanceTransientDescriptorPools() retires the frame
          */
-        BindGroup(Device& device, BindLayout& layout);
+        BindGroup(Device& device, BindLayout& layout, const bool transient = false);
 
         /**
          * @brief  destructor
@@ -93,6 +95,8 @@ namespace vk2s
         vk::DescriptorSet mDescriptorSet;
         //! Index of allocated pool (see Device implementation)
         size_t mPoolIndex;
+        //! whether the descriptor set is allocated from the per-frame pools (never deallocated individually)
+        bool mTransient;
         //! capacity when descriptor set is allocated (see Device implementation)
         DescriptorPoolAllocationInfo mAllocationInfo;
         //! cache information written to each binding (reflected collectively)
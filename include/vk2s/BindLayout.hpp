@@ -62,6 +62,11 @@ namespace vk2s
             return accelerationStructureNum + combinedImageSamplerNum + sampledImageNum + samplerNum + storageBufferNum + storageImageNum + uniformBufferNum + uniformBufferDynamicNum;
         }
 
+        /**
+         * @brief  equality operator overload (used as the key of descriptor pool buckets)
+         */
+        bool operator==(const DescriptorPoolAllocationInfo&) const = default;
+
         //! each elements allocation num
         uint32_t accelerationStructureNum = 0;
         uint32_t combinedImageSamplerNum  = 0;
@@ -14,6 +14,7 @@
 #endif
 
 #include "Macro.hpp"
+#include "MemoryAllocator.hpp"
 
 #include <functional>
 
@@ -42,7 +43,7 @@ namespace vk2s
         NONMOVABLE(Buffer);
 
         /**
-         * @brief  writes data to buffer
+         * @brief  writes data to buffer (memcpy to the persistently mapped memory, flushed if not host coherent)
          * 
          * @param pSrc pointer to copy source memory area
          * @param size size of copy source memory area
@@ -51,7 +52,7 @@ namespace vk2s
         void write(const void* pSrc, const size_t size, const size_t offset = 0);
 
         /**
-         * @brief  maps buffer information to CPU for reading
+         * @brief  passes the persistently mapped memory to readFunc (invalidated first if not host coherent)
          * @detail TODO: std::function is slow
          * 
          * @param readFunc function object to process from mapped memory
@@ -60,15 +61,47 @@ namespace vk2s
          */
         void read(const std::function<void(const void*)>& readFunc, const size_t size, const size_t offset = 0);
 
+        /**
+         * @brief  get the host pointer to the buffer, mapped once at creation and stable for its lifetime (nullptr if not host visible)
+         * @detail writes through it need flush() and reads need invalidate() unless isHostCoherent()
+         */
+        void* getMappedPointer() const;
+
+        /**
+         * @brief  whether the buffer memory needs no flush() / invalidate()
+         */
+        bool isHostCoherent() const;
+
+        /**
+         * @brief  make host writes to the range visible to the device (does nothing if host coherent)
+         *
+         * @param offset offset from the beginning of the buffer
+         * @param size size of the range (VK_WHOLE_SIZE to the end of the buffer)
+         */
+        void flush(const vk::DeviceSize offset = 0, const vk::DeviceSize size = VK_WHOLE_SIZE);
+
+        /**
+         * @brief  make device writes to the range visible to the host (does nothing if host coherent)
+         *
+         * @param offset offset from the beginning of the buffer
+         * @param size size of the range (VK_WHOLE_SIZE to the end of the buffer)
+         */
+        void invalidate(const vk::DeviceSize offset = 0, const vk::DeviceSize size = VK_WHOLE_SIZE);
+
         /**
          * @brief  get vulkan internal handle
          */
         const vk::UniqueBuffer& getVkBuffer();
 
         /**
-         * @brief  get vulkan device memory
+         * @brief  get vulkan device memory (shared with other resources, see getMemoryAllocation() for the range)
+         */
+        vk::DeviceMemory getVkDeviceMemory() const;
+
+        /**
+         * @brief  get the range of device memory bound to this buffer
          */
-        const vk::UniqueDeviceMemory& getVkDeviceMemory();
+        const MemoryAllocation& getMemoryAllocation() const;
 
         /**
          * @brief  get size of vulkan device memory
@@ -89,10 +122,10 @@ namespace vk2s
         //! reference to device
         Device& mDevice;
 
+        //! device memory bound to the buffer (declared first to be released after the buffer)
+        MemoryAllocation mMemory;
         //! vulkan buffer handle
         vk::UniqueBuffer mBuffer;
-        //! vulkan device memory 
-        vk::UniqueDeviceMemory mMemory;
         //! size of vulkan device memory
         vk::DeviceSize mSize;
         //! offset of vulkan device memory
@@ -17,6 +17,9 @@
 #include "SlotMap.hpp"
 
 #include <optional>
+#include <string_view>
+#include <utility>
+#include <vector>
 
 namespace vk2s
 {
@@ -32,6 +35,51 @@ namespace vk2s
     class ShaderBindingTable;
     class Window;
 
+#if VK_HEADER_VERSION >= 301
+    //! table of vulkan function pointers (each Device loads its own, see Device::getVkDispatcher())
+    using VulkanDispatchLoader = vk::detail::DispatchLoaderDynamic;
+#else
+    //! table of vulkan function pointers (each Device loads its own, see Device::getVkDispatcher())
+    using VulkanDispatchLoader = vk::DispatchLoaderDynamic;
+#endif
+
+    /**
+     * @brief  type of the device queue a Command is submitted to
+     */
+    enum class QueueType : uint8_t
+    {
+        //! queue supporting graphics (and compute, transfer) commands
+        eGraphics,
+        //! compute-only queue if available (falls back to the graphics queue)
+        eCompute,
+        //! transfer-only queue if available (falls back to the compute-only or graphics queue)
+        eTransfer,
+    };
+
+    /**
+     * @brief  semaphore waited on by a submission
+     */
+    struct SemaphoreWait
+    {
+        //! semaphore to wait on
+        Handle<Semaphore> semaphore;
+        //! value to wait for (timeline semaphore only, ignored for binary semaphores)
+        uint64_t value = 0;
+        //! stages of this submission that wait on the semaphore
+        vk::PipelineStageFlags stage = vk::PipelineStageFlagBits::eAllCommands;
+    };
+
+    /**
+     * @brief  semaphore signaled by a submission
+     */
+    struct SemaphoreSignal
+    {
+        //! semaphore to signal
+        Handle<Semaphore> semaphore;
+        //! value to set (timeline semaphore only, ignored for binary semaphores)
+        uint64_t value = 0;
+    };
+
     /**
      * @brief  Command class, write and execute commands to the GPU
      */
@@ -40,8 +88,20 @@ namespace vk2s
     public:  // methods
         /**
          * @brief  constructor
+         *
+         * @param queueType queue to submit the command to (allocated from the command pool of its queue family)
          */
-        Command(Device& device);
+        Command(Device& device, const QueueType queueType = QueueType::eGraphics);
+
+        /**
+         * @brief  constructor (allocated from the command pool of the worker for the frame, see Device::resetWorkerCommandPools())
+         * @detail must be recorded only by the thread acting as the worker, can be destroyed on any thread
+         *
+         * @param queueType queue to submit the command to
+         * @param frameIndex index of the frame (in flight) the command is recorded for
+         * @param workerIndex index of the worker recording the command (one thread at a time per index, e.g. the index of a job system thread)
+         */
+        Command(Device& device, const QueueType queueType, const uint32_t frameIndex, const uint32_t workerIndex);
 
         /**
          * @brief  destructor
@@ -103,13 +163,17 @@ namespace vk2s
 
         /**
          * @brief  set VertexBuffer
+         *
+         * @param offset byte offset of the first vertex in the buffer (e.g. GeometryArena::Slice::offset)
          */
-        void bindVertexBuffer(Buffer& vertexBuffer);
+        void bindVertexBuffer(Buffer& vertexBuffer, const vk::DeviceSize offset = 0);
 
         /**
          * @brief  set IndexBuffer
+         *
+         * @param offset byte offset of the first index in the buffer (e.g. GeometryArena::Slice::offset)
          */
-        void bindIndexBuffer(Buffer& indexBuffer);
+        void bindIndexBuffer(Buffer& indexBuffer, const vk::DeviceSize offset = 0);
 
         /**
          * @brief  drawing with specified settings (without index)
@@ -172,14 +236,55 @@ namespace vk2s
         void imagePipelineBarrier(const vk::ImageMemoryBarrier barrier, const vk::PipelineStageFlags from, const vk::PipelineStageFlags to);
 
         /**
-         * @brief  transitioning the internal layout of an Image 
+         * @brief  transitioning the internal layout of an Image (every mip level and array layer)
          */
         void transitionImageLayout(Image& image, const vk::ImageLayout from, const vk::ImageLayout to);
 
         /**
-         * @brief  copy Buffer contents to Image
+         * @brief  transitioning the internal layout of the subresources of an Image
          */
-        void copyBufferToImage(Buffer& buffer, Image& image, const uint32_t width, const uint32_t height);
+        void transitionImageLayout(Image& image, const vk::ImageLayout from, const vk::ImageLayout to, const vk::ImageSubresourceRange& range);
+
+        /**
+         * @brief  release the ownership of Buffer to the queue family of dstQueue (record in the command of the source queue)
+         * @detail the submission must signal a Semaphore the acquiring submission waits on, does nothing if both queues belong to the same family
+         */
+        void releaseBufferOwnership(Buffer& buffer, const QueueType dstQueue, const vk::AccessFlags srcAccess, const vk::PipelineStageFlags srcStage);
+
+        /**
+         * @brief  acquire the ownership of Buffer from the queue family of srcQueue (record in the command of the destination queue)
+         * @detail records a normal memory barrier if both queues belong to the same family
+         */
+        void acquireBufferOwnership(Buffer& buffer, const QueueType srcQueue, const vk::AccessFlags dstAccess, const vk::PipelineStageFlags dstStage);
+
+        /**
+         * @brief  release the ownership of Image to the queue family of dstQueue with a layout transition (record in the command of the source queue)
+         * @detail the layouts must be identical to those passed to acquireImageOwnership(), does nothing if both queues belong to the same family
+         */
+        void releaseImageOwnership(Image& image, const QueueType dstQueue, const vk::ImageLayout from, const vk::ImageLayout to, const vk::AccessFlags srcAccess, const vk::PipelineStageFlags srcStage);
+
+        /**
+         * @brief  acquire the ownership of Image from the queue family of srcQueue with a layout transition (record in the command of the destination queue)
+         * @detail records a normal image barrier (including the layout transition) if both queues belong to the same family
+         */
+        void acquireImageOwnership(Image& image, const QueueType srcQueue, const vk::ImageLayout from, const vk::ImageLayout to, const vk::AccessFlags dstAccess, const vk::PipelineStageFlags dstStage);
+
+        /**
+         * @brief  copy Buffer contents to a mip level of Image (in eTransferDstOptimal)
+         *
+         * @param width width of the mip level
+         * @param height height of the mip level
+         * @param bufferOffset offset of the tightly packed texels in the buffer
+         */
+        void copyBufferToImage(Buffer& buffer, Image& image, const uint32_t width, const uint32_t height, const uint32_t mipLevel = 0, const vk::DeviceSize bufferOffset = 0);
+
+        /**
+         * @brief  generate every mip level of Image from the first level by blits (the first layer only)
+         * @detail every level must be in eTransferDstOptimal and the Image needs vk::ImageUsageFlagBits::eTransferSrc,
+         *         sRGB formats are filtered in linear space, every level is left in finalLayout
+         *         throws std::runtime_error if the format doesn't support blits
+         */
+        void generateMipmaps(Image& image, const vk::ImageLayout finalLayout = vk::ImageLayout::eShaderReadOnlyOptimal);
 
         /**
          * @brief  copy Image contents to Buffer
@@ -211,30 +316,72 @@ namespace vk2s
          */
         void drawImGui();
 
+        /**
+         * @brief  begin a named scope measured by the Profiler of Device (also emits a VK_EXT_debug_utils label)
+         * @detail scopes can be nested and must be ended in the same command and frame (see Profiler::beginFrame())
+         *         pipeline statistics are ignored for scopes nested in another scope with statistics and on queues without graphics support,
+         *         a scope with statistics must not straddle a render pass boundary
+         *
+         * @param pipelineStatistics whether to also count pipeline statistics (vertices, shader invocations, ...)
+         */
+        void beginProfileScope(std::string_view name, const bool pipelineStatistics = false);
+
+        /**
+         * @brief  end the innermost scope begun by beginProfileScope()
+         */
+        void endProfileScope();
+
         /**
          * @brief  Execute the instructions written 
+         * @detail also signals the submission timeline of Device and releases retired objects passed to Device::destroyDeferred()
          */
         void execute(const Handle<Fence>& signalFence = Handle<Fence>(), const Handle<Semaphore>& waitSem = Handle<Semaphore>(), const Handle<Semaphore>& signalSem = Handle<Semaphore>());
 
+        /**
+         * @brief  Execute the instructions written, waiting on and signaling multiple (binary or timeline) semaphores
+         * @detail also signals the submission timeline of Device and releases retired objects passed to Device::destroyDeferred()
+         */
+        void execute(const vk::ArrayProxy<const SemaphoreWait>& waits, const vk::ArrayProxy<const SemaphoreSignal>& signals, const Handle<Fence>& signalFence = Handle<Fence>());
+
+        /**
+         * @brief  get the index of the latest submission of this command (0 if never submitted, see Device::waitSubmission())
+         */
+        uint64_t getLastSubmissionIndex() const;
+
         /**
          * @brief  get vulkan internal handle
          */
         const vk::UniqueCommandBuffer& getVkCommandBuffer();
 
+        /**
+         * @brief  get the type of the queue this command is submitted to
+         */
+        QueueType getQueueType() const;
+
     private:  // methods
         /**
          * @brief  internal implementation of transitionImageLayout function
          */
-        inline void transitionLayoutInternal(vk::Image image, vk::ImageAspectFlags flag, const vk::ImageLayout from, const vk::ImageLayout to);
+        inline void transitionLayoutInternal(vk::Image image, const vk::ImageSubresourceRange& range, const vk::ImageLayout from, const vk::ImageLayout to);
 
     private:  // member variables
         //! reference to device
         Device& mDevice;
+        //! device-level function pointers of mDevice used to record and submit (skips the loader trampolines)
+        const VulkanDispatchLoader& mDispatcher;
 
+        //! type of the queue this command is submitted to
+        QueueType mQueueType;
         //! vulkan command buffer handle
         vk::UniqueCommandBuffer mCommandBuffer;
+        //! index of the worker command pool the command buffer was allocated from (if allocated from the pool of a worker)
+        std::optional<size_t> mWorkerPoolIndex;
         //! Pipeline currently set
         Handle<Pipeline> mNowPipeline;
+        //! index of the latest submission of this command (0 if never submitted)
+        uint64_t mLastSubmissionIndex;
+        //! index in the Profiler and whether pipeline statistics were requested for each open profile scope
+        std::vector<std::pair<uint32_t, bool>> mProfileScopes;
     };
 }  // namespace vk2s
 
@@ -0,0 +1,191 @@
+/*****************************************************************/ /**
+ * @file   DescriptorAllocator.hpp
+ * @brief  header file of DescriptorAllocator class
+ *
+ * @author agent
+ * @date   October 2026
+ *********************************************************************/
+#ifndef VK2S_INCLUDE_DESCRIPTORALLOCATOR_HPP_
+#define VK2S_INCLUDE_DESCRIPTORALLOCATOR_HPP_
+
+#ifndef VULKAN_HPP_DISPATCH_LOADER_DYNAMIC
+#define VULKAN_HPP_DISPATCH_LOADER_DYNAMIC 1
+#include <vulkan/vulkan.hpp>
+#endif
+
+#include "BindLayout.hpp"
+#include "Macro.hpp"
+
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace vk2s
+{
+    /**
+     * @brief  class that allocates descriptor sets from descriptor pools bucketed by DescriptorPoolAllocationInfo
+     * @detail every pool of a bucket holds sets of the same size only, so a pool with a free slot always fits the request
+     *         pools with free slots are kept in a free list per bucket (allocation and deallocation are O(1))
+     *         transient sets are allocated linearly from pools that are reset wholesale (vkResetDescriptorPool) once the GPU has retired the frame
+     *         a single mutex guards the pools, so BindGroups can be created and destroyed on worker threads (writing to a set is up to its owner)
+     */
+    class DescriptorAllocator
+    {
+    public:  // types
+        /**
+         * @brief  usage statistics of the allocator
+         */
+        struct Statistics
+        {
+            //! number of buckets (distinct DescriptorPoolAllocationInfo)
+            size_t bucketNum = 0;
+            //! number of descriptor pools for persistent sets
+            size_t poolNum = 0;
+            //! number of live persistent sets
+            size_t setNum = 0;
+            //! number of descriptor pools for transient sets (in use, retired and free)
+            size_t transientPoolNum = 0;
+        };
+
+    public:  // methods
+        /**
+         * @brief  constructor
+         *
+         * @param device vulkan logical device
+         * @param useAccelerationStructure whether transient pools hold acceleration structure descriptors (needs VK_KHR_acceleration_structure)
+         */
+        DescriptorAllocator(vk::Device device, const bool useAccelerationStructure);
+
+        /**
+         * @brief  destructor
+         */
+        ~DescriptorAllocator();
+
+        NONCOPYABLE(DescriptorAllocator);
+        NONMOVABLE(DescriptorAllocator);
+
+        /**
+         * @brief  allocate a descriptor set that lives until deallocate() is called
+         *
+         * @return descriptor set and the index of the pool it was allocated from (pass it to deallocate())
+         */
+        std::pair<vk::DescriptorSet, size_t> allocate(const vk::DescriptorSetLayout& layout, const DescriptorPoolAllocationInfo& allocInfo);
+
+        /**
+         * @brief  return a descriptor set allocated by allocate() to its pool
+         */
+        void deallocate(const vk::DescriptorSet& set, const size_t poolIndex);
+
+        /**
+         * @brief  allocate a descriptor set that is valid until the frame is retired (never deallocated individually)
+         */
+        vk::DescriptorSet allocateTransient(const vk::DescriptorSetLayout& layout, const DescriptorPoolAllocationInfo& allocInfo);
+
+        /**
+         * @brief  retire the transient sets allocated so far and reset the transient pools whose submissions have been retired by the GPU
+         *
+         * @param submissionIndex index of the latest submission that may use the transient sets allocated so far
+         * @param completedSubmissionIndex index of the latest submission retired by the GPU
+         */
+        void advanceFrame(const uint64_t submissionIndex, const uint64_t completedSubmissionIndex);
+
+        /**
+         * @brief  get the usage statistics
+         */
+        Statistics getStatistics() const;
+
+        //! number of sets in the first pool of each bucket (doubled for each new pool)
+        constexpr static uint32_t kInitialSetNum = 16;
+        //! maximum number of sets in a pool of a bucket
+        constexpr static uint32_t kMaxSetNum = 256;
+        //! number of sets (and descriptors of each type) in a transient pool
+        constexpr static uint32_t kTransientSetNum = 1024;
+
+    private:  // types
+        /**
+         * @brief  hash of DescriptorPoolAllocationInfo to be used as the key of buckets
+         */
+        struct AllocationInfoHash
+        {
+            size_t operator()(const DescriptorPoolAllocationInfo& info) const noexcept;
+        };
+
+        /**
+         * @brief  descriptor pool for persistent sets and its current allocation status
+         */
+        struct DescriptorPool
+        {
+            vk::UniqueDescriptorPool descriptorPool;
+            //! number of sets that can still be allocated
+            uint32_t freeSetNum;
+            //! whether the pool is in the free list of its bucket
+            bool listed;
+            //! key of the bucket the pool belongs to
+            DescriptorPoolAllocationInfo key;
+        };
+
+        /**
+         * @brief  pools of the same DescriptorPoolAllocationInfo
+         */
+        struct Bucket
+        {
+            //! indices of the pools with free slots
+            std::vector<size_t> freePools;
+            //! number of sets in the next pool
+            uint32_t nextSetNum = kInitialSetNum;
+        };
+
+        /**
+         * @brief  descriptor pool for transient sets and its remaining capacity
+         */
+        struct TransientPool
+        {
+            vk::UniqueDescriptorPool descriptorPool;
+            //! number of descriptors of each type the pool was created with
+            DescriptorPoolAllocationInfo capacity;
+            //! number of descriptors of each type that can still be allocated
+            DescriptorPoolAllocationInfo now;
+            //! number of sets that can still be allocated
+            uint32_t setNum;
+        };
+
+    private:  // methods
+        /**
+         * @brief  create a descriptor pool holding the specified number of descriptors of each type and maxSets sets
+         */
+        vk::UniqueDescriptorPool createVkDescriptorPool(const DescriptorPoolAllocationInfo& descriptorNum, const uint32_t maxSets, const vk::DescriptorPoolCreateFlags flags);
+
+        /**
+         * @brief  whether the transient pool has enough capacity for the request
+         */
+        static bool fits(const TransientPool& pool, const DescriptorPoolAllocationInfo& allocInfo);
+
+    private:  // member variables
+        //! vulkan logical device
+        vk::Device mDevice;
+        //! whether transient pools hold acceleration structure descriptors
+        bool mUseAccelerationStructure;
+
+        //! guards every member below
+        mutable std::mutex mMutex;
+
+        //! pools for persistent sets (indices are stable)
+        std::vector<DescriptorPool> mPools;
+        //! buckets for each DescriptorPoolAllocationInfo
+        std::unordered_map<DescriptorPoolAllocationInfo, Bucket, AllocationInfoHash> mBuckets;
+        //! number of live persistent sets
+        size_t mSetNum;
+
+        //! transient pools used by the current frame (allocates from the last one)
+        std::vector<TransientPool> mTransientPools;
+        //! transient pools waiting for the submission index to be retired
+        std::deque<std::pair<uint64_t, TransientPool>> mRetiredTransientPools;
+        //! reset transient pools ready to be reused
+        std::vector<TransientPool> mFreeTransientPools;
+    };
+}  // namespace vk2s
+
+#endif
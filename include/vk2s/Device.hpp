@@ -10,6 +10,12 @@
 #define VK2S_INCLUDE_DEVICE_HPP_
 
 #include "SlotMap.hpp"
+#include "PoolResource.hpp"
+#include "MemoryAllocator.hpp"
+#include "DescriptorAllocator.hpp"
+#include "PipelineCache.hpp"
+#include "Profiler.hpp"
+#include "Uploader.hpp"
 #include "Macro.hpp"
 
 #define VULKAN_HPP_DISPATCH_LOADER_DYNAMIC 1
@@ -32,10 +38,21 @@
 #include "ShaderBindingTable.hpp"
 
 #include <optional>
+#include <chrono>
+#include <string_view>
 #include <array>
+#include <atomic>
 #include <utility>
 #include <tuple>
 #include <type_traits>
+#include <deque>
+#include <functional>
+#include <span>
+#include <memory_resource>
+#include <memory>
+#include <vector>
+#include <map>
+#include <mutex>
 
 namespace vk2s
 {
@@ -53,6 +70,22 @@ namespace vk2s
     {
     };
 
+    /**
+     * @brief  type to obtain the index of type T within variable-length argument Ts
+     */
+    template <class T, class TypeList>
+    struct IndexOf;
+
+    template <class T, class... Ts>
+    struct IndexOf<T, std::tuple<T, Ts...>> : std::integral_constant<size_t, 0>
+    {
+    };
+
+    template <class T, class U, class... Ts>
+    struct IndexOf<T, std::tuple<U, Ts...>> : std::integral_constant<size_t, 1 + IndexOf<T, std::tuple<Ts...>>::value>
+    {
+    };
+
     /**
      * @brief  index of each command queue (with value only if appropriate one exists)
      */
@@ -60,6 +93,10 @@ namespace vk2s
     {
         std::optional<uint32_t> graphicsFamily;
         std::optional<uint32_t> presentFamily;
+        //! family with compute but without graphics if available, otherwise graphicsFamily
+        std::optional<uint32_t> computeFamily;
+        //! family with transfer only if available, otherwise computeFamily
+        std::optional<uint32_t> transferFamily;
 
         bool isComplete() const
         {
@@ -115,6 +152,51 @@ namespace vk2s
             bool useExternalMemoryExt = false;
         };
 
+        /**
+         * @brief  tag to create a Device without any windowing support (see the constructor taking Headless)
+         */
+        struct Headless
+        {
+        };
+
+        /**
+         * @brief  time taken by a phase of the Device construction
+         */
+        struct StartupPhase
+        {
+            //! name of the phase
+            std::string_view name;
+            //! elapsed time of the phase
+            std::chrono::nanoseconds duration;
+        };
+
+        //! pools storing each vk2s object (page size and allocator type of each are determined by PoolTraits)
+        using Pools = std::tuple<Pool<Window>, Pool<Buffer>, Pool<Image>, Pool<Sampler>, Pool<RenderPass>, Pool<Shader>, Pool<BindLayout>, Pool<BindGroup>, Pool<Pipeline>, Pool<Semaphore>, Pool<Fence>, Pool<Command>,
+                                 Pool<AccelerationStructure>, Pool<ShaderBindingTable>, Pool<DynamicBuffer>>;
+
+        /**
+         * @brief  memory resources the pool pages of each type are allocated from (see PoolResource.hpp for arena / huge page resources)
+         * @detail every resource must outlive the Device, nullptr means new / delete
+         */
+        struct PoolResources
+        {
+            /**
+             * @brief  set the resource of the pool storing the specified type T
+             */
+            template <typename T>
+            PoolResources& set(std::pmr::memory_resource* pResource)
+            {
+                static_assert(IsContainedIn<Pool<T>, Pools>::value, "invalid type of pool!");
+                resources[IndexOf<Pool<T>, Pools>::value] = pResource;
+                return *this;
+            }
+
+            //! resource of the pools without their own resource
+            std::pmr::memory_resource* pDefaultResource = nullptr;
+            //! resource of each pool (in the order of Pools)
+            std::array<std::pmr::memory_resource*, std::tuple_size_v<Pools>> resources{};
+        };
+
     public:  // methods
         /**
          * @brief  constructor
@@ -127,6 +209,17 @@ namespace vk2s
          */
         Device(const Extensions extensions, const bool useWindow = true);
 
+        /**
+         * @brief constructor (with extensions and the memory resources of pool pages)
+         */
+        Device(const Extensions extensions, const bool useWindow, const PoolResources& poolResources);
+
+        /**
+         * @brief  constructor for headless use (e.g. offline rendering workers)
+         * @detail skips GLFW, surfaces, the swapchain extension and ImGui entirely, so Window and initImGui() can't be used
+         */
+        Device(const Extensions extensions, const Headless headless, const PoolResources& poolResources = PoolResources());
+
         /**
          * @brief  destructor
          */
@@ -137,25 +230,114 @@ namespace vk2s
         /**
          * @brief  creates an instance of the specified type T and returns a handle
          * @detail compile-time error if not a vk2s object
+         *         can be called from multiple threads (the pool is lock-free, the Device serializes submissions and deferred destructions),
+         *         except that the shared command pools of getVkCommandPool() (Command without a frame index, and Uploader / Readback / GeometryArena recording to them) must be used by one thread at a time
          */
-        template <typename T, size_t PageSize = kDefaultPageSize, typename Allocator = DefaultAllocator, typename... Args>
-        Handle<T, PageSize, DefaultAllocator> create(Args&&... args)
+        template <typename T, size_t PageSize = PoolTraits<T>::kPageSize, typename Allocator = typename PoolTraits<T>::AllocatorType, typename... Args>
+        Handle<T, PageSize, Allocator> create(Args&&... args)
         {
-            static_assert(IsContainedIn<Pool<T, PageSize, DefaultAllocator>, decltype(mPools)>::value, "invalid type of pool!");
-            return std::get<Pool<T, PageSize, DefaultAllocator>>(mPools).allocate(*this, std::forward<Args>(args)...);
+            static_assert(IsContainedIn<Pool<T, PageSize, Allocator>, decltype(mPools)>::value, "invalid type of pool!");
+            return std::get<Pool<T, PageSize, Allocator>>(mPools).allocate(*this, std::forward<Args>(args)...);
         }
 
         /**
          * @brief  destroy an instance of the specified handle
          * @detail compile-time error if not a vk2s object
+         *         can be called from multiple threads, but not for the same object while another thread still uses it
+         */
+        template <typename T, size_t PageSize = PoolTraits<T>::kPageSize, typename Allocator = typename PoolTraits<T>::AllocatorType>
+        bool destroy(Handle<T, PageSize, Allocator>& handle)
+        {
+            static_assert(IsContainedIn<Pool<T, PageSize, Allocator>, decltype(mPools)>::value, "invalid type of pool!");
+            return std::get<Pool<T, PageSize, Allocator>>(mPools).deallocate(handle);
+        }
+
+        /**
+         * @brief  creates count instances of the specified type T at once and returns their handles
+         * @detail compile-time error if not a vk2s object
+         *         free slots and pool pages are reserved once before construction, so this is faster than calling create() count times
+         * 
+         * @param count number of instances to create
+         * @param argsGenerator function returning the constructor arguments (without Device) of the i-th instance as std::tuple (e.g. std::make_tuple)
+         */
+        template <typename T, size_t PageSize = PoolTraits<T>::kPageSize, typename Allocator = typename PoolTraits<T>::AllocatorType, typename ArgsGenerator>
+        std::vector<Handle<T, PageSize, Allocator>> createBatch(const size_t count, ArgsGenerator&& argsGenerator)
+        {
+            static_assert(IsContainedIn<Pool<T, PageSize, Allocator>, decltype(mPools)>::value, "invalid type of pool!");
+            return std::get<Pool<T, PageSize, Allocator>>(mPools).allocateBatch(count, [&](const size_t i) { return std::tuple_cat(std::forward_as_tuple(*this), argsGenerator(i)); });
+        }
+
+        /**
+         * @brief  destroy the instances of the specified handles at once
+         * @detail compile-time error if not a vk2s object
+         * 
+         * @return number of destroyed instances
+         */
+        template <typename T, size_t PageSize = PoolTraits<T>::kPageSize, typename Allocator = typename PoolTraits<T>::AllocatorType>
+        size_t destroyBatch(std::span<std::type_identity_t<Handle<T, PageSize, Allocator>>> handles)
+        {
+            static_assert(IsContainedIn<Pool<T, PageSize, Allocator>, decltype(mPools)>::value, "invalid type of pool!");
+            return std::get<Pool<T, PageSize, Allocator>>(mPools).deallocateBatch(handles);
+        }
+
+        /**
+         * @brief  destroy an instance of the specified handle after the GPU has retired every submission issued so far
+         * @detail the handle is invalidated immediately, the object is released by releaseRetiredObjects() (called on each Command::execute)
+         *         can be called from multiple threads
+         */
+        template <typename T, size_t PageSize = PoolTraits<T>::kPageSize, typename Allocator = typename PoolTraits<T>::AllocatorType>
+        void destroyDeferred(Handle<T, PageSize, Allocator>& handle)
+        {
+            static_assert(IsContainedIn<Pool<T, PageSize, Allocator>, decltype(mPools)>::value, "invalid type of pool!");
+            if (!handle)
+            {
+                return;
+            }
+
+            {
+                std::lock_guard lock(mDeferredDestructionMutex);
+                mDeferredDestructions.emplace_back(mSubmissionIndex.load(std::memory_order_acquire), [this, target = handle]() mutable { destroy(target); });
+            }
+            handle = Handle<T, PageSize, Allocator>();
+        }
+
+        /**
+         * @brief  release the objects passed to destroyDeferred() whose submissions have been retired by the GPU
+         */
+        void releaseRetiredObjects();
+
+        /**
+         * @brief  get the occupancy statistics of the pool storing the specified type T
+         * @detail compile-time error if not a vk2s object
+         */
+        template <typename T, size_t PageSize = PoolTraits<T>::kPageSize, typename Allocator = typename PoolTraits<T>::AllocatorType>
+        PoolStatistics getPoolStatistics() const
+        {
+            static_assert(IsContainedIn<Pool<T, PageSize, Allocator>, decltype(mPools)>::value, "invalid type of pool!");
+            return std::get<Pool<T, PageSize, Allocator>>(mPools).getStatistics();
+        }
+
+        /**
+         * @brief  return the empty pages of the pool storing the specified type T to its allocator
+         * @detail must not be called while other threads create/destroy objects of type T
+         * 
+         * @return number of released pages
          */
-        template <typename T, size_t PageSize = kDefaultPageSize, typename Allocator = DefaultAllocator>
-        bool destroy(Handle<T, PageSize, DefaultAllocator>& handle)
+        template <typename T, size_t PageSize = PoolTraits<T>::kPageSize, typename Allocator = typename PoolTraits<T>::AllocatorType>
+        size_t shrinkPool()
         {
-            static_assert(IsContainedIn<Pool<T, PageSize, DefaultAllocator>, decltype(mPools)>::value, "invalid type of pool!");
-            return std::get<Pool<T, PageSize, DefaultAllocator>>(mPools).deallocate(handle);
+            static_assert(IsContainedIn<Pool<T, PageSize, Allocator>, decltype(mPools)>::value, "invalid type of pool!");
+            return std::get<Pool<T, PageSize, Allocator>>(mPools).shrink();
         }
 
+        /**
+         * @brief  return the empty pages of all pools to their allocators (e.g. after unloading a scene)
+         * @detail must not be called while other threads create/destroy objects
+         * 
+         * @return number of released pages
+         */
+        size_t shrinkPools();
+
         /**
          * @brief  initialize ImGui for a given window/renderpass
          */
@@ -168,6 +350,7 @@ namespace vk2s
 
         /**
          * @brief  wait for task submission to the GPU from the time this function is executed, and return processing when the GPU is idle
+         * @detail blocks the submissions of other threads while waiting
          */
         void waitIdle();
 
@@ -178,9 +361,31 @@ namespace vk2s
 
         /**
          * @brief  get index for memory from Vulkan's requirements for device memory
+         * @detail selected by the type policy of MemoryAllocator (the first matching type unless MemoryAllocator::setTypePolicy() opts in to ReBAR)
          */
         uint32_t getVkMemoryTypeIndex(uint32_t requestBits, vk::MemoryPropertyFlags requestProps) const;
 
+        /**
+         * @brief  get the allocator that sub-allocates device memory for Buffer, DynamicBuffer and Image
+         * @detail also tracks the usage of each memory type and the budget of each heap (see MemoryAllocator::getHeapBudgets(), writeJson())
+         */
+        MemoryAllocator& getMemoryAllocator();
+
+        /**
+         * @brief  get the pipeline cache used by every Pipeline (persisted to PipelineCache::kDefaultPath unless changed by PipelineCache::setPath())
+         */
+        PipelineCache& getPipelineCache();
+
+        /**
+         * @brief  whether the Device was created without any windowing support
+         */
+        bool isHeadless() const;
+
+        /**
+         * @brief  get the elapsed time of each phase of the construction (instance, physical device, logical device, pools, ...) in order
+         */
+        const std::vector<StartupPhase>& getStartupPhases() const;
+
         /**
          * @brief  get the status of the active extension
          */
@@ -201,6 +406,12 @@ namespace vk2s
          */
         const vk::UniqueDevice& getVkDevice();
 
+        /**
+         * @brief  get the function pointers loaded from the logical device of this Device (pass to vk::CommandBuffer / vk::Queue calls on hot paths)
+         * @detail VULKAN_HPP_DEFAULT_DISPATCHER stays instance-level, so it keeps working with every Device of the process through the loader trampolines
+         */
+        const VulkanDispatchLoader& getVkDispatcher() const;
+
         /**
          * @brief  get index of each vulkan command queue
          */
@@ -217,12 +428,85 @@ namespace vk2s
         const vk::Queue& getVkPresentQueue();
 
         /**
-         * @brief  get vulkan command pool
+         * @brief  get vulkan queue to submit compute commands (dedicated compute queue if available)
+         */
+        const vk::Queue& getVkComputeQueue();
+
+        /**
+         * @brief  get vulkan queue to submit transfer commands (dedicated transfer queue if available)
+         */
+        const vk::Queue& getVkTransferQueue();
+
+        /**
+         * @brief  get vulkan queue of the specified type
+         */
+        const vk::Queue& getVkQueue(const QueueType queueType);
+
+        /**
+         * @brief  get index of the queue family of the specified type
+         */
+        uint32_t getVkQueueFamilyIndex(const QueueType queueType) const;
+
+        /**
+         * @brief  get vulkan command pool for the queue of the specified type
+         */
+        const vk::UniqueCommandPool& getVkCommandPool(const QueueType queueType = QueueType::eGraphics);
+
+        /**
+         * @brief  allocate a vulkan command buffer from the command pool of the worker for the queue type and frame
+         * @detail the pool is created on first use and lives until the Device is destroyed, command buffers returned by deallocateWorkerVkCommandBuffer() are reused
+         *         worker indices are chosen by the caller (e.g. the index of a thread in a job system), so the number of pools is bounded by
+         *         workers x queue types x frames, only one thread at a time may allocate from or record to the pools of a worker
+         *
+         * @return command buffer and the index of the pool it was allocated from (pass it to deallocateWorkerVkCommandBuffer())
+         */
+        std::pair<vk::CommandBuffer, size_t> allocateWorkerVkCommandBuffer(const QueueType queueType, const uint32_t frameIndex, const uint32_t workerIndex);
+
+        /**
+         * @brief  return a command buffer allocated by allocateWorkerVkCommandBuffer() to its pool (can be called from any thread)
+         */
+        void deallocateWorkerVkCommandBuffer(const vk::CommandBuffer commandBuffer, const size_t poolIndex);
+
+        /**
+         * @brief  reset the command pools of every worker for the frame at once (all command buffers allocated from them return to the initial state)
+         * @detail the GPU must have retired the commands recorded from those pools (e.g. wait for the Fence of the frame), and no worker may be recording to them
+         */
+        void resetWorkerCommandPools(const uint32_t frameIndex);
+
+        /**
+         * @brief  get vulkan timeline semaphore signaled with the submission index by each Command::execute to the queue of the specified type
+         */
+        const vk::UniqueSemaphore& getVkSubmissionTimeline(const QueueType queueType = QueueType::eGraphics);
+
+        /**
+         * @brief  get the mutex guarding the access to every vulkan queue of the Device (submission, presentation and waitIdle)
+         * @detail vulkan requires the queues to be externally synchronized, lock it while using the queues from getVkQueue() etc.
+         */
+        std::mutex& getVkQueueMutex();
+
+        /**
+         * @brief  issue the index of a new submission to the queue of the specified type (the value to signal on its submission timeline)
+         * @detail the caller must hold getVkQueueMutex() until it has submitted with the index, so that each timeline is signaled in increasing order
          */
-        const vk::UniqueCommandPool& getVkCommandPool();
+        uint64_t issueSubmissionIndex(const QueueType queueType = QueueType::eGraphics);
 
         /**
-         * @brief  allocate a DescriptorSet that satisfies DescriptorPoolAllocationInfor
+         * @brief  get the index of the latest submission issued (may not be retired by the GPU yet)
+         */
+        uint64_t getLatestSubmissionIndex() const;
+
+        /**
+         * @brief  get the index of the latest submission retired by the GPU (every submission up to it is retired on all queues)
+         */
+        uint64_t getCompletedSubmissionIndex() const;
+
+        /**
+         * @brief  wait until the GPU has retired the specified submission
+         */
+        void waitSubmission(const uint64_t submissionIndex);
+
+        /**
+         * @brief  allocate a DescriptorSet that satisfies DescriptorPoolAllocationInfo (from the pools of the bucket for allocInfo)
          */
         const std::pair<vk::DescriptorSet, size_t> allocateVkDescriptorSet(const vk::DescriptorSetLayout& layout, const DescriptorPoolAllocationInfo& allocInfo);
 
@@ -231,6 +515,32 @@ namespace vk2s
          */
         void deallocateVkDescriptorSet(vk::DescriptorSet& set, const size_t poolIndex, const DescriptorPoolAllocationInfo& allocInfo);
 
+        /**
+         * @brief  allocate a DescriptorSet that is valid until the GPU retires the frame (released wholesale by advanceTransientDescriptorPools())
+         */
+        vk::DescriptorSet allocateTransientVkDescriptorSet(const vk::DescriptorSetLayout& layout, const DescriptorPoolAllocationInfo& allocInfo);
+
+        /**
+         * @brief  start a new frame of transient DescriptorSets (call at the beginning of each frame)
+         * @detail the sets allocated so far are released when the GPU retires the submissions issued so far
+         */
+        void advanceTransientDescriptorPools();
+
+        /**
+         * @brief  get the allocator of DescriptorSets for BindGroup
+         */
+        DescriptorAllocator& getDescriptorAllocator();
+
+        /**
+         * @brief  get the GPU profiler measuring the scopes of Command::beginProfileScope() (call Profiler::beginFrame() every frame)
+         */
+        Profiler& getProfiler();
+
+        /**
+         * @brief  get the uploader batching host data uploads to Buffers and Images into single submissions (used by Image::write())
+         */
+        Uploader& getUploader();
+
         /**
          * @brief  aligns the size along the specified
          */
@@ -242,15 +552,23 @@ namespace vk2s
 
     private:  // types
         /**
-         * @brief  DescriptorPool and its current allocation status
+         * @brief  command pool owned by a worker for a queue type and frame
          */
-        struct DescriptorPool
+        struct WorkerCommandPool
         {
-            vk::UniqueDescriptorPool descriptorPool;
-            DescriptorPoolAllocationInfo now;
+            vk::UniqueCommandPool commandPool;
+            //! frame the pool belongs to
+            uint32_t frameIndex;
+            //! guards freeCommandBuffers (commands may be destroyed on other threads)
+            std::mutex mutex;
+            //! command buffers returned to the pool
+            std::vector<vk::CommandBuffer> freeCommandBuffers;
         };
 
     private:  // compile time constant
+        //! number of QueueType
+        constexpr static size_t kQueueTypeNum = 3;
+
               //! flag to enable or disable the verification layer
 #ifdef NDEBUG
         constexpr static bool enableValidationLayers = false;
@@ -272,10 +590,14 @@ namespace vk2s
 
         //! normal device extensions required for vk2s
         constexpr static std::array baseDeviceExtensions = {
-            VK_KHR_SWAPCHAIN_EXTENSION_NAME,
             VK_EXT_ROBUSTNESS_2_EXTENSION_NAME,
         };
 
+        //! device extensions required for presenting to Window (not used when headless)
+        constexpr static std::array swapchainDeviceExtensions = {
+            VK_KHR_SWAPCHAIN_EXTENSION_NAME,
+        };
+
         //! device extensions required for hardware accelerated ray tracing
         constexpr static std::array rayTracingDeviceExtensions = {
             VK_KHR_RAY_TRACING_PIPELINE_EXTENSION_NAME,
@@ -286,6 +608,9 @@ namespace vk2s
 
         //! NV_Motion_blur extension
         constexpr static const char* nvRayTracingMotionBlurExtension = VK_NV_RAY_TRACING_MOTION_BLUR_EXTENSION_NAME;
+
+        //! memory budget extension (enabled if available)
+        constexpr static const char* memoryBudgetExtension = VK_EXT_MEMORY_BUDGET_EXTENSION_NAME;
         
         //! external memory instance extensions
         constexpr static std::array externalMemoryInstanceExtensions = {
@@ -321,10 +646,12 @@ namespace vk2s
             VK_KHR_EXTERNAL_MEMORY_PLATFORM_EXTENSION_NAME,
         };
 
-        //! maximum number of descriptors allocated by one DescriptorPool (adhoc)
-        constexpr static uint32_t kMaxDescriptorNum = 256;
-
     private:  // methods
+        /**
+         * @brief  constructor that the public ones delegate to
+         */
+        Device(const Extensions extensions, const bool useWindow, const bool headless, const PoolResources& poolResources);
+
         /**
          * @brief  create vulkan instance
          */
@@ -351,14 +678,19 @@ namespace vk2s
         void createLogicalDevice(const vk::UniqueSurfaceKHR& testSurface);
 
         /**
-         * @brief  create vulkan command pool
+         * @brief  create vulkan command pool for each queue type
          */
         void createCommandPool();
 
         /**
-         * @brief  create vulkan descriptor pool
+         * @brief  create vulkan timeline semaphore to track submissions for each queue type
          */
-        void createDescriptorPool();
+        void createSubmissionTimeline();
+
+        /**
+         * @brief  run every deferred destruction regardless of the submissions (only on destruction, after the GPU is idle)
+         */
+        void drainDeferredDestructions();
 
         // imgui--------------
         /**
@@ -411,13 +743,25 @@ namespace vk2s
 
         //! whether various extensions are requested (synonymous with available extensions if created on device success)
         const Extensions mQueriedExtensions;
+        //! whether the Device was created without any windowing support
+        const bool mHeadless;
+        //! elapsed time of each phase of the construction
+        std::vector<StartupPhase> mStartupPhases;
 
         //! vulkan physical device
         vk::PhysicalDevice mPhysicalDevice;
         //! vulkan memory properties of the selected physical device
         vk::PhysicalDeviceMemoryProperties mPhysMemProps;
+        //! whether VK_EXT_memory_budget is enabled
+        bool mMemoryBudgetEnabled;
         //! vulkan logical device
         vk::UniqueDevice mDevice;
+        //! function pointers loaded from mDevice (the default dispatcher is shared by every Device of the process)
+        VulkanDispatchLoader mDispatcher;
+        //! device memory sub-allocator (destroyed before the logical device)
+        std::unique_ptr<MemoryAllocator> mMemoryAllocator;
+        //! pipeline cache shared by every Pipeline (saved to the file on destruction)
+        std::unique_ptr<PipelineCache> mPipelineCache;
 
         //! index of each device queue
         QueueFamilyIndices mQueueFamilyIndices;
@@ -425,12 +769,40 @@ namespace vk2s
         vk::Queue mGraphicsQueue;
         //! vulkan device queue for present commands
         vk::Queue mPresentQueue;
-
-        //! vulkan command pool
-        vk::UniqueCommandPool mCommandPool;
-
-        //! vulkan descriptor pools (simple linear allocation)
-        std::vector<DescriptorPool> mDescriptorPools;
+        //! vulkan device queue for compute commands
+        vk::Queue mComputeQueue;
+        //! vulkan device queue for transfer commands
+        vk::Queue mTransferQueue;
+
+        //! vulkan command pool for each queue type
+        std::array<vk::UniqueCommandPool, kQueueTypeNum> mCommandPools;
+
+        //! guards mWorkerCommandPools and mWorkerCommandPoolIndices
+        std::mutex mWorkerCommandPoolMutex;
+        //! command pools of each worker, queue type and frame (elements are never moved)
+        std::deque<WorkerCommandPool> mWorkerCommandPools;
+        //! index of the command pool in mWorkerCommandPools for each worker, queue type and frame
+        std::map<std::tuple<uint32_t, QueueType, uint32_t>, size_t> mWorkerCommandPoolIndices;
+
+        //! vulkan timeline semaphore for each queue type signaled with the submission index (indices are shared among queues)
+        std::array<vk::UniqueSemaphore, kQueueTypeNum> mSubmissionTimelines;
+        //! guards the vulkan queues, written indices below are published under it
+        std::mutex mQueueMutex;
+        //! index of the latest submission to each queue type
+        std::array<std::atomic<uint64_t>, kQueueTypeNum> mLastSubmissionIndices;
+        //! index of the latest submission
+        std::atomic<uint64_t> mSubmissionIndex;
+        //! guards mDeferredDestructions
+        std::mutex mDeferredDestructionMutex;
+        //! objects waiting for destruction and the submission index that must be retired before it
+        std::deque<std::pair<uint64_t, std::function<void()>>> mDeferredDestructions;
+
+        //! descriptor set allocator (pools bucketed by DescriptorPoolAllocationInfo and transient per-frame pools)
+        std::unique_ptr<DescriptorAllocator> mDescriptorAllocator;
+        //! GPU profiler (timestamp and pipeline statistics query pools for each frame in flight)
+        std::unique_ptr<Profiler> mProfiler;
+        //! staging ring uploader (destroyed before the pools)
+        std::unique_ptr<Uploader> mUploader;
 
         // imgui--------------
         //! vulkan descriptor pool only for Imgui
@@ -440,9 +812,7 @@ namespace vk2s
 
     private:  // pools
         //! tuple of pools where each instance of vk2s is stored
-        std::tuple<Pool<Window>, Pool<Buffer>, Pool<Image>, Pool<Sampler>, Pool<RenderPass>, Pool<Shader>, Pool<BindLayout>, Pool<BindGroup>, Pool<Pipeline>, Pool<Semaphore>, Pool<Fence>, Pool<Command>, Pool<AccelerationStructure>,
-                   Pool<ShaderBindingTable>, Pool<DynamicBuffer>>
-            mPools;
+        Pools mPools;
     };
 }  // namespace vk2s
 
@@ -14,6 +14,7 @@
 #endif
 
 #include "Macro.hpp"
+#include "MemoryAllocator.hpp"
 
 namespace vk2s
 {
@@ -31,6 +32,14 @@ namespace vk2s
 
         void write(const void* pSrc, const size_t size, const size_t offset = 0);
 
+        void* getMappedPointer() const;
+
+        bool isHostCoherent() const;
+
+        void flush(const vk::DeviceSize offset = 0, const vk::DeviceSize size = VK_WHOLE_SIZE);
+
+        void invalidate(const vk::DeviceSize offset = 0, const vk::DeviceSize size = VK_WHOLE_SIZE);
+
         const vk::UniqueBuffer& getVkBuffer();
 
         const vk::DeviceSize getSize() const;
@@ -44,8 +53,8 @@ namespace vk2s
     private:  // member variables
         Device& mDevice;
 
+        MemoryAllocation mMemory;
         vk::UniqueBuffer mBuffer;
-        vk::UniqueDeviceMemory mMemory;
         vk::DeviceSize mSize;
         vk::DeviceSize mOffset;
         vk::DeviceSize mBlockSize;
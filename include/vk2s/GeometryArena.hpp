@@ -0,0 +1,249 @@
+/*****************************************************************/ /**
+ * @file   GeometryArena.hpp
+ * @brief  header file of GeometryArena class
+ *
+ * @author agent
+ * @date   October 2026
+ *********************************************************************/
+#ifndef VK2S_INCLUDE_GEOMETRYARENA_HPP_
+#define VK2S_INCLUDE_GEOMETRYARENA_HPP_
+
+#ifndef VULKAN_HPP_DISPATCH_LOADER_DYNAMIC
+#define VULKAN_HPP_DISPATCH_LOADER_DYNAMIC 1
+#include <vulkan/vulkan.hpp>
+#endif
+
+#include "Macro.hpp"
+#include "SlotMap.hpp"
+
+#include <deque>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace vk2s
+{
+    //! forward declaration
+    class Device;
+    class Buffer;
+
+    /**
+     * @brief  class that packs the vertices and indices of many meshes into a few large device local Buffers (blocks)
+     * @detail each mesh gets a slice of a block for its vertices and one for its indices, vertex slices are aligned to the vertex stride
+     *         and index slices to the index size, so a block can be bound once and drawn with Slice::getFirstElement() as vertexOffset / firstIndex
+     *         the data is uploaded through Device::getUploader() (call Uploader::submit() after adding meshes)
+     *         get() and getStatistics() only take an internal lock, add(), remove() and compact() go through the Uploader and the shared
+     *         graphics command pool, so call them on the thread driving the Uploader
+     */
+    class GeometryArena
+    {
+    public:  // types
+        /**
+         * @brief  ID of a mesh in the arena
+         */
+        using MeshID = uint32_t;
+
+        /**
+         * @brief  range of a block holding the vertices or indices of a mesh
+         */
+        struct Slice
+        {
+            //! block the range belongs to
+            Handle<Buffer> buffer;
+            //! byte offset of the range in the block (pass to Command::bindVertexBuffer() / bindIndexBuffer())
+            vk::DeviceSize offset = 0;
+            //! number of elements (vertices or indices)
+            uint32_t count = 0;
+            //! byte size of an element
+            uint32_t stride = 0;
+
+            /**
+             * @brief  get the byte size of the range
+             */
+            vk::DeviceSize getSize() const
+            {
+                return static_cast<vk::DeviceSize>(count) * stride;
+            }
+
+            /**
+             * @brief  get the index of the first element in the block (vertexOffset / firstIndex of draws with the block bound at offset 0)
+             */
+            uint32_t getFirstElement() const
+            {
+                return static_cast<uint32_t>(offset / stride);
+            }
+
+            /**
+             * @brief  get the device address of the range (for BLAS builds and shaders, needs the ray tracing extensions)
+             */
+            vk::DeviceAddress getVkDeviceAddress() const;
+        };
+
+        /**
+         * @brief  slices of a mesh
+         */
+        struct Mesh
+        {
+            Slice vertices;
+            Slice indices;
+        };
+
+        /**
+         * @brief  statistics of the arena
+         */
+        struct Statistics
+        {
+            //! number of live meshes
+            size_t meshNum = 0;
+            //! number of blocks
+            size_t blockNum = 0;
+            //! bytes of the blocks
+            vk::DeviceSize reservedBytes = 0;
+            //! bytes of the slices of live meshes
+            vk::DeviceSize usedBytes = 0;
+            //! number of compactions so far
+            size_t compactionNum = 0;
+        };
+
+    public:  // methods
+        /**
+         * @brief  constructor
+         *
+         * @param vertexStride byte size of a vertex
+         * @param blockSize byte size of each block (meshes larger than this get their own block)
+         */
+        GeometryArena(Device& device, const uint32_t vertexStride, const vk::DeviceSize blockSize = kDefaultBlockSize);
+
+        /**
+         * @brief  destructor
+         */
+        ~GeometryArena();
+
+        NONCOPYABLE(GeometryArena);
+        NONMOVABLE(GeometryArena);
+
+        /**
+         * @brief  add a mesh (32bit indices) and queue the upload of its data
+         *
+         * @return ID of the mesh
+         */
+        MeshID add(const void* pVertices, const uint32_t vertexNum, const uint32_t* pIndices, const uint32_t indexNum);
+
+        /**
+         * @brief  remove the mesh (its slices are reused after the GPU retires the submissions issued so far)
+         */
+        void remove(const MeshID id);
+
+        /**
+         * @brief  get the slices of the mesh (changed by compact())
+         */
+        Mesh get(const MeshID id) const;
+
+        /**
+         * @brief  move every mesh into tightly packed new blocks on the GPU and release the old blocks after the copy retires
+         * @detail call between frames before recording commands, slices, device addresses and BLASes referring to the meshes
+         *         must be fetched / built again when this returns true
+         *
+         * @param threshold compact only if the unused bytes of the blocks exceed this ratio
+         * @return whether the meshes were moved
+         */
+        bool compact(const float threshold = kDefaultCompactionThreshold);
+
+        /**
+         * @brief  get the statistics of the arena
+         */
+        Statistics getStatistics() const;
+
+        //! default byte size of each block
+        constexpr static vk::DeviceSize kDefaultBlockSize = 64 * 1024 * 1024;
+        //! default ratio of unused bytes that triggers compaction
+        constexpr static float kDefaultCompactionThreshold = 0.25f;
+
+    private:  // types
+        /**
+         * @brief  large Buffer holding the slices of meshes
+         */
+        struct Block
+        {
+            //! device local buffer
+            Handle<Buffer> buffer;
+            //! byte size of buffer
+            vk::DeviceSize size;
+            //! free ranges (offset -> size, coalesced)
+            std::map<vk::DeviceSize, vk::DeviceSize> freeRanges;
+        };
+
+        /**
+         * @brief  slices of a live mesh and the blocks they belong to
+         */
+        struct Entry
+        {
+            Mesh mesh;
+            uint32_t vertexBlock;
+            uint32_t indexBlock;
+        };
+
+        /**
+         * @brief  range freed by remove() waiting for the GPU to retire the submissions that may read it
+         */
+        struct PendingFree
+        {
+            uint64_t submissionIndex;
+            uint32_t blockIndex;
+            vk::DeviceSize offset;
+            vk::DeviceSize size;
+        };
+
+    private:  // methods
+        /**
+         * @brief  allocate a slice with the alignment (adds a block if needed)
+         *
+         * @return slice and index of its block
+         */
+        std::pair<Slice, uint32_t> allocate(const uint32_t count, const uint32_t stride, const vk::DeviceSize alignment);
+
+        /**
+         * @brief  create a block of the byte size
+         */
+        uint32_t addBlock(const vk::DeviceSize size);
+
+        /**
+         * @brief  return the range to the free list of the block (coalesced with the neighbors)
+         */
+        void freeRange(const uint32_t blockIndex, const vk::DeviceSize offset, const vk::DeviceSize size);
+
+        /**
+         * @brief  free the ranges of the removed meshes retired by the GPU
+         */
+        void reclaim();
+
+    private:  // member variables
+        //! reference to device
+        Device& mDevice;
+        //! byte size of a vertex
+        uint32_t mVertexStride;
+        //! alignment of vertex slices (multiple of the vertex stride and 4)
+        vk::DeviceSize mVertexAlignment;
+        //! byte size of each block
+        vk::DeviceSize mBlockSize;
+        //! usage of the blocks
+        vk::BufferUsageFlags mUsage;
+
+        //! guards every member below
+        mutable std::mutex mMutex;
+        //! blocks
+        std::vector<Block> mBlocks;
+        //! meshes (indices are IDs, nullopt if removed)
+        std::vector<std::optional<Entry>> mMeshes;
+        //! IDs of removed meshes to reuse
+        std::vector<MeshID> mFreeIDs;
+        //! ranges of removed meshes waiting for the GPU
+        std::deque<PendingFree> mPendingFrees;
+        //! statistics
+        Statistics mStats;
+    };
+}  // namespace vk2s
+
+#endif
@@ -14,6 +14,7 @@
 #endif
 
 #include "Macro.hpp"
+#include "MemoryAllocator.hpp"
 
 namespace vk2s
 {
@@ -50,27 +51,50 @@ namespace vk2s
         NONMOVABLE(Image);
 
         /**
-         * @brief  writes data to image
+         * @brief  writes data to image and waits for the transfer to complete (left in eShaderReadOnlyOptimal)
+         * @detail the data is written to the first mip level, the other levels are generated from it
+         *         use writeAsync() or Uploader::enqueue() to avoid stalling on the transfer
          * 
          * @param pSrc pointer to copy source memory area
          * @param size size of copy source memory area
          */
         void write(const void* pSrc, const size_t size);
 
+        /**
+         * @brief  writes data to image through Device::getUploader() without waiting (left in eShaderReadOnlyOptimal)
+         * @detail the upload is visible to every later submission on the graphics queue
+         *         wait for the returned index with Device::waitSubmission() before reading the image on the host or another queue
+         * 
+         * @param pSrc pointer to copy source memory area
+         * @param size size of copy source memory area
+         * @return submission index of the upload
+         */
+        uint64_t writeAsync(const void* pSrc, const size_t size);
+
         /**
          * @brief  load the specified image file
          */
         void loadFromFile(std::string_view path);
 
+        /**
+         * @brief  get the number of mip levels of the full mip chain for the extent
+         */
+        static uint32_t calcMipLevels(const uint32_t width, const uint32_t height);
+
         /**
          * @brief  get vulkan image handle 
          */
         const vk::UniqueImage& getVkImage();
 
         /**
-         * @brief  get vulkan device memory
+         * @brief  get vulkan device memory (shared with other resources unless dedicated, see getMemoryAllocation() for the range)
          */
-        const vk::UniqueDeviceMemory& getVkDeviceMemory();
+        vk::DeviceMemory getVkDeviceMemory() const;
+
+        /**
+         * @brief  get the range of device memory bound to this image
+         */
+        const MemoryAllocation& getMemoryAllocation() const;
 
         /**
          * @brief  get vulkan image view handle
@@ -92,14 +116,29 @@ namespace vk2s
          */
         vk::ImageAspectFlags getVkAspectFlag() const;
 
+        /**
+         * @brief  get the number of mip levels
+         */
+        uint32_t getMipLevels() const;
+
+        /**
+         * @brief  get the number of array layers
+         */
+        uint32_t getArrayLayers() const;
+
+        /**
+         * @brief  get the subresource range covering every mip level and array layer
+         */
+        vk::ImageSubresourceRange getVkSubresourceRange() const;
+
     private:  // member variables
         //! reference to device
         Device& mDevice;
 
+        //! device memory bound to the image (declared first to be released after the image)
+        MemoryAllocation mMemory;
         //! vulkan image handle 
         vk::UniqueImage mImage;
-        //! vulkan device memory
-        vk::UniqueDeviceMemory mMemory;
         //! vulkan image view handle
         vk::UniqueImageView mImageView;
         //! vulkan image extent(3D)
@@ -108,6 +147,10 @@ namespace vk2s
         vk::Format mFormat;
         //! vulkan image aspect flag
         vk::ImageAspectFlags mAspectFlag;
+        //! number of mip levels
+        uint32_t mMipLevels;
+        //! number of array layers
+        uint32_t mArrayLayers;
     };
 }  // namespace vk2s
 
@@ -0,0 +1,411 @@
+/*****************************************************************/ /**
+ * @file   MemoryAllocator.hpp
+ * @brief  header file of MemoryAllocator class
+ *
+ * @author agent
+ * @date   October 2026
+ *********************************************************************/
+#ifndef VK2S_INCLUDE_MEMORYALLOCATOR_HPP_
+#define VK2S_INCLUDE_MEMORYALLOCATOR_HPP_
+
+#ifndef VULKAN_HPP_DISPATCH_LOADER_DYNAMIC
+#define VULKAN_HPP_DISPATCH_LOADER_DYNAMIC 1
+#include <vulkan/vulkan.hpp>
+#endif
+
+#include "Macro.hpp"
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <vector>
+#include <cstddef>
+
+namespace vk2s
+{
+    //! forward declaration
+    class MemoryAllocator;
+
+    /**
+     * @brief  range of device memory handed out by MemoryAllocator (returned to the allocator on destruction)
+     */
+    class MemoryAllocation
+    {
+    public:  // methods
+        /**
+         * @brief  constructor (empty allocation)
+         */
+        MemoryAllocation();
+
+        /**
+         * @brief  destructor
+         */
+        ~MemoryAllocation();
+
+        NONCOPYABLE(MemoryAllocation);
+
+        /**
+         * @brief  move constructor
+         */
+        MemoryAllocation(MemoryAllocation&& other) noexcept;
+
+        /**
+         * @brief  assignment operator overload (move)
+         */
+        MemoryAllocation& operator=(MemoryAllocation&& other) noexcept;
+
+        /**
+         * @brief  return the range to the allocator (does nothing if empty)
+         */
+        void release();
+
+        /**
+         * @brief  get the vulkan device memory the range belongs to (shared with other allocations unless dedicated)
+         */
+        vk::DeviceMemory getVkDeviceMemory() const;
+
+        /**
+         * @brief  get the offset of the range in the vulkan device memory
+         */
+        vk::DeviceSize getOffset() const;
+
+        /**
+         * @brief  get the size of the range
+         */
+        vk::DeviceSize getSize() const;
+
+        /**
+         * @brief  get the index of the memory type of the range
+         */
+        uint32_t getMemoryTypeIndex() const;
+
+        /**
+         * @brief  get the persistently mapped host pointer to the beginning of the range (nullptr if not host visible)
+         */
+        std::byte* getMappedPointer() const;
+
+        /**
+         * @brief  whether host writes are visible to the device (and vice versa) without flush() / invalidate()
+         */
+        bool isHostCoherent() const;
+
+        /**
+         * @brief  make host writes to the range visible to the device (does nothing if host coherent)
+         * @detail the range is widened to nonCoherentAtomSize, which never crosses into other allocations
+         *
+         * @param offset offset from the beginning of the allocation
+         * @param size size of the range (VK_WHOLE_SIZE to the end of the allocation)
+         */
+        void flush(const vk::DeviceSize offset = 0, const vk::DeviceSize size = VK_WHOLE_SIZE) const;
+
+        /**
+         * @brief  make device writes to the range visible to the host (does nothing if host coherent)
+         *
+         * @param offset offset from the beginning of the allocation
+         * @param size size of the range (VK_WHOLE_SIZE to the end of the allocation)
+         */
+        void invalidate(const vk::DeviceSize offset = 0, const vk::DeviceSize size = VK_WHOLE_SIZE) const;
+
+        /**
+         * @brief  whether the range owns a whole vulkan device memory
+         */
+        bool isDedicated() const;
+
+        /**
+         * @brief  bool operator overload to determine if the allocation is not empty
+         */
+        explicit operator bool() const noexcept;
+
+    private:  // member variables
+        friend class MemoryAllocator;
+
+        //! allocator the range is returned to
+        MemoryAllocator* mpAllocator;
+        //! vulkan device memory
+        vk::DeviceMemory mMemory;
+        //! offset in the vulkan device memory
+        vk::DeviceSize mOffset;
+        //! size of the range
+        vk::DeviceSize mSize;
+        //! persistently mapped host pointer (nullptr if not host visible)
+        std::byte* mpMapped;
+        //! whether the memory is host visible but not host coherent (needs flush / invalidate)
+        bool mNonCoherent;
+        //! index of the memory type
+        uint32_t mMemoryTypeIndex;
+        //! index of the block list the range belongs to
+        uint32_t mListIndex;
+        //! block the range belongs to (nullptr if dedicated)
+        void* mpBlock;
+        //! index of the node in the block
+        uint32_t mNodeIndex;
+    };
+
+    /**
+     * @brief  class that sub-allocates device memory from large blocks per memory type
+     * @detail each block is managed by TLSF (two-level segregated fit), linear resources (buffers) and optimal tiling images are
+     *         placed in separate blocks when bufferImageGranularity > 1, large or driver-preferred resources get dedicated allocations
+     *         host visible memory is persistently mapped, every method can be called from multiple threads
+     */
+    class MemoryAllocator
+    {
+    public:  // types
+        /**
+         * @brief  policy to select the memory type among those satisfying the requested properties
+         */
+        enum class TypePolicy
+        {
+            //! the first matching type (default)
+            eFirstMatch,
+            //! the type with the fewest unrequested properties, device local + host visible (ReBAR) types for host visible requests if the heap is large enough
+            ePreferReBAR,
+        };
+
+        /**
+         * @brief  usage statistics of the allocator
+         */
+        struct Statistics
+        {
+            //! number of blocks
+            size_t blockNum = 0;
+            //! number of dedicated allocations
+            size_t dedicatedAllocationNum = 0;
+            //! number of live allocations (including dedicated)
+            size_t allocationNum = 0;
+            //! bytes allocated from vulkan (blocks and dedicated allocations)
+            vk::DeviceSize reservedBytes = 0;
+            //! bytes handed out to allocations
+            vk::DeviceSize usedBytes = 0;
+        };
+
+        /**
+         * @brief  usage of a memory type by this allocator
+         */
+        struct TypeUsage
+        {
+            //! index of the memory type
+            uint32_t typeIndex = 0;
+            //! index of the heap the type belongs to
+            uint32_t heapIndex = 0;
+            //! properties of the memory type
+            vk::MemoryPropertyFlags propertyFlags;
+            //! number of live allocations
+            size_t allocationNum = 0;
+            //! bytes allocated from vulkan (blocks and dedicated allocations)
+            vk::DeviceSize reservedBytes = 0;
+            //! bytes handed out to allocations
+            vk::DeviceSize usedBytes = 0;
+        };
+
+        /**
+         * @brief  usage and budget of a memory heap
+         */
+        struct HeapBudget
+        {
+            //! index of the heap
+            uint32_t heapIndex = 0;
+            //! properties of the heap
+            vk::MemoryHeapFlags flags;
+            //! size of the heap
+            vk::DeviceSize size = 0;
+            //! bytes the process can allocate without degrading performance (VK_EXT_memory_budget, otherwise 80% of the heap size)
+            vk::DeviceSize budget = 0;
+            //! bytes the process uses (VK_EXT_memory_budget, otherwise reservedBytes)
+            vk::DeviceSize usage = 0;
+            //! bytes allocated from vulkan by this allocator
+            vk::DeviceSize reservedBytes = 0;
+            //! bytes handed out to allocations by this allocator
+            vk::DeviceSize usedBytes = 0;
+            //! whether budget and usage are reported by the driver (VK_EXT_memory_budget)
+            bool fromDriver = false;
+        };
+
+    public:  // methods
+        /**
+         * @brief  constructor
+         *
+         * @param physicalDevice vulkan physical device
+         * @param device vulkan logical device
+         * @param useDeviceAddress whether to allocate every memory with VK_MEMORY_ALLOCATE_DEVICE_ADDRESS_BIT (needs bufferDeviceAddress)
+         * @param useMemoryBudget whether VK_EXT_memory_budget is enabled on the device
+         * @param blockSize byte size of each block (smaller for heaps under 1GiB)
+         */
+        MemoryAllocator(vk::PhysicalDevice physicalDevice, vk::Device device, const bool useDeviceAddress, const bool useMemoryBudget, const vk::DeviceSize blockSize = kDefaultBlockSize);
+
+        /**
+         * @brief  destructor
+         */
+        ~MemoryAllocator();
+
+        NONCOPYABLE(MemoryAllocator);
+        NONMOVABLE(MemoryAllocator);
+
+        /**
+         * @brief  allocate memory for the buffer and bind it
+         */
+        MemoryAllocation allocateForBuffer(vk::Buffer buffer, const vk::BufferUsageFlags usage, const vk::MemoryPropertyFlags requiredProps);
+
+        /**
+         * @brief  allocate memory for the image and bind it
+         */
+        MemoryAllocation allocateForImage(vk::Image image, const vk::ImageTiling tiling, const vk::MemoryPropertyFlags requiredProps);
+
+        /**
+         * @brief  get the best memory type index for the requested properties according to the policy (0 if not found)
+         */
+        uint32_t findMemoryTypeIndex(const uint32_t typeBits, const vk::MemoryPropertyFlags requiredProps) const;
+
+        /**
+         * @brief  set the policy to select the memory type (TypePolicy::eFirstMatch by default)
+         * @detail affects only the memory allocated after the call, TypePolicy::ePreferReBAR suits CPU write-only data (staging, per-frame constants)
+         *         but makes CPU reads from host visible memory much slower
+         */
+        void setTypePolicy(const TypePolicy policy);
+
+        /**
+         * @brief  get the policy to select the memory type
+         */
+        TypePolicy getTypePolicy() const;
+
+        /**
+         * @brief  set the minimum byte size of resources that get dedicated allocations
+         */
+        void setDedicatedThreshold(const vk::DeviceSize threshold);
+
+        /**
+         * @brief  get the usage statistics
+         */
+        Statistics getStatistics() const;
+
+        /**
+         * @brief  get the usage of each memory type
+         */
+        std::vector<TypeUsage> getTypeUsages() const;
+
+        /**
+         * @brief  get the usage and budget of each memory heap (queries the driver each call if VK_EXT_memory_budget is enabled)
+         */
+        std::vector<HeapBudget> getHeapBudgets() const;
+
+        /**
+         * @brief  get the bytes that can still be allocated within the budget of the heap preferred for the requested properties
+         * @detail use this to pick resolutions or evict resources before the allocation fails
+         */
+        vk::DeviceSize getAvailableBudget(const vk::MemoryPropertyFlags requiredProps) const;
+
+        /**
+         * @brief  write the statistics, heap budgets and type usages as JSON
+         */
+        void writeJson(std::ostream& os) const;
+
+        //! default byte size of each block
+        constexpr static vk::DeviceSize kDefaultBlockSize = 64 * 1024 * 1024;
+        //! heaps smaller than this are considered as BAR without resizable BAR (not preferred by ePreferReBAR)
+        constexpr static vk::DeviceSize kReBARHeapThreshold = 256 * 1024 * 1024;
+
+    private:  // types
+        //! block of device memory managed by TLSF (defined in the source file)
+        struct Block;
+
+        /**
+         * @brief  usage counters of a memory type
+         */
+        struct TypeCounter
+        {
+            std::atomic<size_t> allocationNum;
+            std::atomic<vk::DeviceSize> reservedBytes;
+            std::atomic<vk::DeviceSize> usedBytes;
+        };
+
+        /**
+         * @brief  blocks of a memory type (for linear or optimal resources)
+         */
+        struct BlockList
+        {
+            std::mutex mutex;
+            std::vector<std::unique_ptr<Block>> blocks;
+        };
+
+    private:  // methods
+        friend class MemoryAllocation;
+
+        /**
+         * @brief  allocate a range satisfying the requirements (dedicated allocations get the resource to be bound)
+         */
+        MemoryAllocation allocate(const vk::MemoryRequirements& reqs, const vk::MemoryPropertyFlags requiredProps, const bool optimal, const bool dedicated, const vk::MemoryDedicatedAllocateInfo& dedicatedInfo);
+
+        /**
+         * @brief  allocate a range from the specified memory type (throws vk::OutOfDeviceMemoryError if exhausted)
+         */
+        MemoryAllocation allocateFromType(const uint32_t typeIndex, const vk::MemoryRequirements& reqs, const bool optimal, const bool dedicated, const vk::MemoryDedicatedAllocateInfo& dedicatedInfo);
+
+        /**
+         * @brief  allocate a whole vulkan device memory (mapped if host visible)
+         */
+        std::pair<vk::DeviceMemory, std::byte*> allocateVkMemory(const uint32_t typeIndex, const vk::DeviceSize size, const vk::MemoryDedicatedAllocateInfo* pDedicatedInfo);
+
+        /**
+         * @brief  return the range of the allocation (called by MemoryAllocation::release())
+         */
+        void free(MemoryAllocation& allocation);
+
+        /**
+         * @brief  get the range of the allocation widened to nonCoherentAtomSize (for flush / invalidate)
+         */
+        vk::MappedMemoryRange getMappedRange(const MemoryAllocation& allocation, const vk::DeviceSize offset, const vk::DeviceSize size) const;
+
+        /**
+         * @brief  get the memory types satisfying the requested properties in the order of preference
+         */
+        std::vector<uint32_t> getMemoryTypeCandidates(const uint32_t typeBits, const vk::MemoryPropertyFlags requiredProps) const;
+
+        /**
+         * @brief  byte size of blocks for the memory type
+         */
+        vk::DeviceSize getBlockSize(const uint32_t typeIndex) const;
+
+    private:  // member variables
+        //! vulkan physical device (to query the memory budget)
+        vk::PhysicalDevice mPhysicalDevice;
+        //! vulkan logical device
+        vk::Device mDevice;
+        //! vulkan memory properties of the physical device
+        vk::PhysicalDeviceMemoryProperties mMemProps;
+        //! bufferImageGranularity of the physical device
+        vk::DeviceSize mBufferImageGranularity;
+        //! nonCoherentAtomSize of the physical device
+        vk::DeviceSize mNonCoherentAtomSize;
+        //! minimum alignment of buffers with device address (for acceleration structure scratch buffers)
+        vk::DeviceSize mDeviceAddressAlignment;
+        //! whether to allocate with VK_MEMORY_ALLOCATE_DEVICE_ADDRESS_BIT
+        bool mUseDeviceAddress;
+        //! whether VK_EXT_memory_budget is enabled
+        bool mUseMemoryBudget;
+        //! byte size of each block
+        vk::DeviceSize mBlockSize;
+        //! minimum byte size of resources that get dedicated allocations
+        std::atomic<vk::DeviceSize> mDedicatedThreshold;
+        //! policy to select the memory type
+        std::atomic<TypePolicy> mTypePolicy;
+
+        //! block lists ([memory type * 2 + (optimal ? 1 : 0)])
+        std::array<BlockList, VK_MAX_MEMORY_TYPES * 2> mBlockLists;
+
+        //! number of blocks
+        std::atomic<size_t> mBlockNum;
+        //! number of dedicated allocations
+        std::atomic<size_t> mDedicatedAllocationNum;
+        //! number of live allocations
+        std::atomic<size_t> mAllocationNum;
+        //! bytes allocated from vulkan
+        std::atomic<vk::DeviceSize> mReservedBytes;
+        //! bytes handed out to allocations
+        std::atomic<vk::DeviceSize> mUsedBytes;
+        //! usage counters of each memory type
+        std::array<TypeCounter, VK_MAX_MEMORY_TYPES> mTypeCounters;
+    };
+}  // namespace vk2s
+
+#endif
@@ -0,0 +1,179 @@
+/*****************************************************************/ /**
+ * @file   PipelineCache.hpp
+ * @brief  header file of PipelineCache class
+ *
+ * @author agent
+ * @date   October 2026
+ *********************************************************************/
+#ifndef VK2S_INCLUDE_PIPELINECACHE_HPP_
+#define VK2S_INCLUDE_PIPELINECACHE_HPP_
+
+#ifndef VULKAN_HPP_DISPATCH_LOADER_DYNAMIC
+#define VULKAN_HPP_DISPATCH_LOADER_DYNAMIC 1
+#include <vulkan/vulkan.hpp>
+#endif
+
+#include "Macro.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <mutex>
+#include <vector>
+
+namespace vk2s
+{
+    /**
+     * @brief  vulkan pipeline cache persisted to a file, used by every Pipeline of the Device
+     * @detail the file starts with a header holding the vendor / device ID, driver version and pipelineCacheUUID of the physical device,
+     *         files written by another device or driver (or corrupted ones) are ignored
+     *         on save, the data currently on disk is merged and the file is replaced atomically (written to a temporary file and renamed)
+     */
+    class PipelineCache
+    {
+    public:  // types
+        /**
+         * @brief  statistics of the pipelines created with the cache (from VK_PIPELINE_CREATION_FEEDBACK)
+         */
+        struct Statistics
+        {
+            //! whether valid data was loaded from the file
+            bool loaded = false;
+            //! byte size of the data loaded from the file
+            size_t loadedBytes = 0;
+            //! number of pipelines created
+            size_t pipelineNum = 0;
+            //! number of pipelines the driver reported as cache hits
+            size_t cacheHitNum = 0;
+            //! total creation time of the pipelines that hit the cache
+            std::chrono::nanoseconds hitTime = std::chrono::nanoseconds(0);
+            //! total creation time of the pipelines that missed the cache
+            std::chrono::nanoseconds missTime = std::chrono::nanoseconds(0);
+
+            /**
+             * @brief  estimated time saved by the cache (hits priced at the average miss time, 0 if nothing missed)
+             */
+            std::chrono::nanoseconds getEstimatedSavedTime() const
+            {
+                const size_t missNum = pipelineNum - cacheHitNum;
+                if (missNum == 0 || cacheHitNum == 0)
+                {
+                    return std::chrono::nanoseconds(0);
+                }
+
+                const auto saved = missTime / missNum * cacheHitNum - hitTime;
+                return std::max(saved, std::chrono::nanoseconds(0));
+            }
+        };
+
+    public:  // methods
+        /**
+         * @brief  constructor (loads the cache from the file if it is valid)
+         *
+         * @param physicalDevice vulkan physical device
+         * @param device vulkan logical device
+         * @param path file the cache is loaded from and saved to (empty to disable persistence)
+         */
+        PipelineCache(vk::PhysicalDevice physicalDevice, vk::Device device, const std::filesystem::path& path = kDefaultPath);
+
+        /**
+         * @brief  destructor (saves the cache to the file)
+         */
+        ~PipelineCache();
+
+        NONCOPYABLE(PipelineCache);
+        NONMOVABLE(PipelineCache);
+
+        /**
+         * @brief  get vulkan pipeline cache handle
+         */
+        const vk::UniquePipelineCache& getVkPipelineCache() const;
+
+        /**
+         * @brief  change the file (the data in the new file is merged into the current cache)
+         * @detail the merge writes to the cache, so don't create Pipelines on other threads meanwhile
+         */
+        void setPath(const std::filesystem::path& path);
+
+        /**
+         * @brief  get the file the cache is saved to
+         */
+        const std::filesystem::path& getPath() const;
+
+        /**
+         * @brief  merge the cache with the file and replace the file atomically
+         * @detail the cache is merged into a temporary one, so Pipelines can be created on other threads meanwhile
+         *
+         * @return whether the file was written
+         */
+        bool save();
+
+        /**
+         * @brief  record the creation feedback of a pipeline created with this cache
+         */
+        void recordCreation(const vk::PipelineCreationFeedback& feedback);
+
+        /**
+         * @brief  get the statistics of the pipelines created with this cache
+         */
+        Statistics getStatistics() const;
+
+        //! default file name (in the working directory)
+        constexpr static const char* kDefaultPath = "vk2s_pipeline_cache.bin";
+
+    private:  // types
+        /**
+         * @brief  header written in front of the vulkan pipeline cache data
+         */
+        struct FileHeader
+        {
+            uint32_t magic;
+            uint32_t version;
+            uint32_t vendorID;
+            uint32_t deviceID;
+            uint32_t driverVersion;
+            uint8_t pipelineCacheUUID[VK_UUID_SIZE];
+            uint64_t dataSize;
+            uint64_t checksum;
+        };
+
+    private:  // methods
+        /**
+         * @brief  read the vulkan pipeline cache data from the file (empty if missing or invalid)
+         */
+        std::vector<std::byte> readFile(const std::filesystem::path& path) const;
+
+        /**
+         * @brief  create a header for the data of this device
+         */
+        FileHeader makeHeader(const std::vector<std::byte>& data) const;
+
+        /**
+         * @brief  64-bit FNV-1a hash of the data
+         */
+        static uint64_t computeChecksum(const std::vector<std::byte>& data);
+
+        //! "VK2S" in little endian
+        constexpr static uint32_t kMagic = 0x53324B56;
+        //! version of the file layout
+        constexpr static uint32_t kFileVersion = 1;
+
+    private:  // member variables
+        //! vulkan logical device
+        vk::Device mDevice;
+        //! properties of the physical device (to validate the file)
+        vk::PhysicalDeviceProperties mProps;
+        //! vulkan pipeline cache
+        vk::UniquePipelineCache mPipelineCache;
+        //! file the cache is saved to
+        std::filesystem::path mPath;
+
+        //! guards mStats
+        mutable std::mutex mMutex;
+        //! statistics of the pipelines created with this cache
+        Statistics mStats;
+    };
+}  // namespace vk2s
+
+#endif
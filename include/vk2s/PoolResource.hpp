@@ -0,0 +1,166 @@
+/*****************************************************************/ /**
+ * @file   PoolResource.hpp
+ * @brief  header file of memory resources for Pool pages
+ *
+ * @author agent
+ * @date   October 2026
+ *********************************************************************/
+#ifndef VK2S_INCLUDE_POOLRESOURCE_HPP_
+#define VK2S_INCLUDE_POOLRESOURCE_HPP_
+
+#include "Macro.hpp"
+
+#include <memory_resource>
+#include <mutex>
+#include <vector>
+#include <unordered_map>
+#include <cstddef>
+
+namespace vk2s
+{
+    /**
+     * @brief  thread-safe monotonic memory resource that carves allocations out of large contiguous chunks
+     * @detail deallocate() does nothing, every chunk is returned to the upstream resource by release() or on destruction
+     *         suitable for the pools of objects that live as long as the Device (or a scene)
+     */
+    class ArenaResource : public std::pmr::memory_resource
+    {
+    public:  // methods
+        /**
+         * @brief  constructor
+         *
+         * @param chunkSize byte size of each chunk requested from the upstream resource
+         * @param pUpstream resource chunks are allocated from
+         */
+        ArenaResource(const size_t chunkSize = kDefaultChunkSize, std::pmr::memory_resource* pUpstream = std::pmr::new_delete_resource());
+
+        /**
+         * @brief  destructor
+         */
+        ~ArenaResource();
+
+        NONCOPYABLE(ArenaResource);
+        NONMOVABLE(ArenaResource);
+
+        /**
+         * @brief  return every chunk to the upstream resource (all allocations from this resource become invalid)
+         */
+        void release();
+
+        /**
+         * @brief  get the byte size reserved from the upstream resource
+         */
+        size_t getReservedSize() const;
+
+        //! default byte size of each chunk
+        constexpr static size_t kDefaultChunkSize = 4 * 1024 * 1024;
+
+    private:  // methods
+        void* do_allocate(size_t bytes, size_t alignment) override;
+
+        void do_deallocate(void* ptr, size_t bytes, size_t alignment) override;
+
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+    private:  // types
+        /**
+         * @brief  chunk allocated from the upstream resource
+         */
+        struct Chunk
+        {
+            void* ptr;
+            size_t size;
+            size_t alignment;
+        };
+
+    private:  // member variables
+        //! guards every member below
+        mutable std::mutex mMutex;
+        //! resource chunks are allocated from
+        std::pmr::memory_resource* mpUpstream;
+        //! byte size of each chunk
+        size_t mChunkSize;
+        //! chunks allocated so far
+        std::vector<Chunk> mChunks;
+        //! next free address in the current chunk
+        std::byte* mpCurrent;
+        //! end of the current chunk
+        std::byte* mpEnd;
+    };
+
+    /**
+     * @brief  thread-safe memory resource backed by huge pages (2MiB) to reduce TLB misses when iterating pools
+     * @detail regions are reserved with mmap + madvise(MADV_HUGEPAGE) (transparent huge pages) on Linux,
+     *         and with VirtualAlloc(MEM_LARGE_PAGES) on Windows if the process holds SeLockMemoryPrivilege (normal pages otherwise)
+     *         freed blocks are kept in per-size free lists and reused, regions are returned to the OS on destruction
+     */
+    class HugePageResource : public std::pmr::memory_resource
+    {
+    public:  // methods
+        /**
+         * @brief  constructor
+         *
+         * @param regionSize byte size of each region reserved from the OS (rounded up to a multiple of kHugePageSize)
+         */
+        HugePageResource(const size_t regionSize = kHugePageSize);
+
+        /**
+         * @brief  destructor
+         */
+        ~HugePageResource();
+
+        NONCOPYABLE(HugePageResource);
+        NONMOVABLE(HugePageResource);
+
+        /**
+         * @brief  get the byte size reserved from the OS
+         */
+        size_t getReservedSize() const;
+
+        //! byte size of a huge page
+        constexpr static size_t kHugePageSize = 2 * 1024 * 1024;
+
+    private:  // methods
+        void* do_allocate(size_t bytes, size_t alignment) override;
+
+        void do_deallocate(void* ptr, size_t bytes, size_t alignment) override;
+
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+        /**
+         * @brief  reserve a region of the specified byte size (a multiple of kHugePageSize) from the OS
+         */
+        static std::byte* reserveRegion(const size_t size);
+
+        /**
+         * @brief  return a region reserved by reserveRegion() to the OS
+         */
+        static void releaseRegion(std::byte* ptr, const size_t size);
+
+    private:  // types
+        /**
+         * @brief  region reserved from the OS
+         */
+        struct Region
+        {
+            std::byte* ptr;
+            size_t size;
+        };
+
+    private:  // member variables
+        //! guards every member below
+        mutable std::mutex mMutex;
+        //! byte size of each region
+        size_t mRegionSize;
+        //! regions reserved so far
+        std::vector<Region> mRegions;
+        //! freed blocks for each (aligned) byte size
+        std::unordered_map<size_t, std::vector<std::byte*>> mFreeBlocks;
+        //! next free address in the current region
+        std::byte* mpCurrent;
+        //! end of the current region
+        std::byte* mpEnd;
+    };
+}  // namespace vk2s
+
+#endif
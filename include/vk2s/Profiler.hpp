@@ -0,0 +1,202 @@
+/*****************************************************************/ /**
+ * @file   Profiler.hpp
+ * @brief  header file of Profiler class
+ *
+ * @author agent
+ * @date   October 2026
+ *********************************************************************/
+#ifndef VK2S_INCLUDE_PROFILER_HPP_
+#define VK2S_INCLUDE_PROFILER_HPP_
+
+#ifndef VULKAN_HPP_DISPATCH_LOADER_DYNAMIC
+#define VULKAN_HPP_DISPATCH_LOADER_DYNAMIC 1
+#include <vulkan/vulkan.hpp>
+#endif
+
+#include "Macro.hpp"
+
+#include <deque>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace vk2s
+{
+    //! forward declaration
+    class Device;
+
+    /**
+     * @brief  GPU profiler measuring named scopes recorded by Command::beginProfileScope() / endProfileScope()
+     * @detail each frame in flight has its own timestamp / pipeline statistics query pools,
+     *         the results of a frame are read back when its pools are reused kFrameLatency frames later (no stall if the GPU keeps up)
+     *         scopes also emit VK_EXT_debug_utils labels (if available) so that capture tools show the same names
+     */
+    class Profiler
+    {
+    public:  // types
+        /**
+         * @brief  pipeline statistics of a scope (in the order of kPipelineStatisticFlags)
+         */
+        struct PipelineStatistics
+        {
+            uint64_t inputAssemblyVertices     = 0;
+            uint64_t inputAssemblyPrimitives   = 0;
+            uint64_t vertexShaderInvocations   = 0;
+            uint64_t clippingPrimitives        = 0;
+            uint64_t fragmentShaderInvocations = 0;
+            uint64_t computeShaderInvocations  = 0;
+        };
+
+        /**
+         * @brief  measured result of a scope (aggregated by name)
+         */
+        struct ScopeResult
+        {
+            //! name of the scope
+            std::string name;
+            //! GPU time of the latest frame (milliseconds)
+            double lastMs = 0.0;
+            //! average GPU time over the latest kAverageWindow frames (milliseconds)
+            double averageMs = 0.0;
+            //! number of frames measured in total
+            size_t sampleNum = 0;
+            //! pipeline statistics of the latest frame (if requested)
+            PipelineStatistics statistics;
+            //! whether statistics holds a value
+            bool hasStatistics = false;
+        };
+
+    public:  // methods
+        /**
+         * @brief  constructor
+         *
+         * @param frameLatency number of frames to wait before reading back the results (number of query pool sets)
+         * @param maxScopeNum maximum number of scopes per frame (the rest are only labeled)
+         */
+        Profiler(Device& device, const uint32_t frameLatency = kDefaultFrameLatency, const uint32_t maxScopeNum = kDefaultMaxScopeNum);
+
+        /**
+         * @brief  destructor
+         */
+        ~Profiler();
+
+        NONCOPYABLE(Profiler);
+        NONMOVABLE(Profiler);
+
+        /**
+         * @brief  start a new frame (call once per frame before recording commands)
+         * @detail reads back the results of the frame kFrameLatency frames ago (waits only if the GPU is further behind) and resets its query pools
+         */
+        void beginFrame();
+
+        /**
+         * @brief  begin a scope in the command buffer (called by Command::beginProfileScope())
+         *
+         * @return index of the scope in the frame (pass it to endScope())
+         */
+        uint32_t beginScope(const vk::CommandBuffer commandBuffer, const uint32_t queueFamilyIndex, std::string_view name, const bool pipelineStatistics);
+
+        /**
+         * @brief  end a scope in the command buffer (called by Command::endProfileScope())
+         */
+        void endScope(const vk::CommandBuffer commandBuffer, const uint32_t scopeIndex);
+
+        /**
+         * @brief  get the results of every scope measured so far (sorted by name)
+         */
+        std::vector<ScopeResult> getResults() const;
+
+        /**
+         * @brief  write the results as lines of "name: last / average ms"
+         */
+        void print(std::ostream& os) const;
+
+        //! default number of frames to wait before reading back the results
+        constexpr static uint32_t kDefaultFrameLatency = 3;
+        //! default maximum number of scopes per frame
+        constexpr static uint32_t kDefaultMaxScopeNum = 256;
+        //! number of frames the rolling average is computed over
+        constexpr static size_t kAverageWindow = 64;
+        //! index returned for scopes that are not measured
+        constexpr static uint32_t kInvalidScope = UINT32_MAX;
+
+    private:  // types
+        /**
+         * @brief  scope recorded in a frame
+         */
+        struct Scope
+        {
+            std::string name;
+            //! whether a pipeline statistics query was written
+            bool statistics;
+            //! valid bits of the timestamps (depends on the queue family)
+            uint64_t timestampMask;
+        };
+
+        /**
+         * @brief  query pools and scopes of a frame in flight
+         */
+        struct Frame
+        {
+            vk::UniqueQueryPool timestampPool;
+            vk::UniqueQueryPool statisticsPool;
+            std::vector<Scope> scopes;
+            //! latest submission index when the frame ended
+            uint64_t submissionIndex = 0;
+        };
+
+        /**
+         * @brief  accumulated history of a scope name
+         */
+        struct History
+        {
+            std::deque<double> samples;
+            double sum = 0.0;
+            ScopeResult result;
+        };
+
+    private:  // methods
+        /**
+         * @brief  read back the results of the frame and add them to the histories
+         */
+        void collect(Frame& frame);
+
+        /**
+         * @brief  reset the query pools of the frame from the host
+         */
+        void resetFrame(Frame& frame);
+
+        //! statistics counted by pipeline statistics queries
+        constexpr static vk::QueryPipelineStatisticFlags kPipelineStatisticFlags = vk::QueryPipelineStatisticFlagBits::eInputAssemblyVertices | vk::QueryPipelineStatisticFlagBits::eInputAssemblyPrimitives |
+                                                                                   vk::QueryPipelineStatisticFlagBits::eVertexShaderInvocations | vk::QueryPipelineStatisticFlagBits::eClippingPrimitives |
+                                                                                   vk::QueryPipelineStatisticFlagBits::eFragmentShaderInvocations | vk::QueryPipelineStatisticFlagBits::eComputeShaderInvocations;
+        //! number of counters in kPipelineStatisticFlags
+        constexpr static uint32_t kPipelineStatisticNum = 6;
+
+    private:  // member variables
+        //! reference to device
+        Device& mDevice;
+        //! maximum number of scopes per frame
+        uint32_t mMaxScopeNum;
+        //! nanoseconds per timestamp tick
+        double mTimestampPeriod;
+        //! timestampValidBits and whether pipeline statistics are supported for each queue family
+        std::vector<std::pair<uint32_t, bool>> mQueueFamilySupports;
+        //! whether VK_EXT_debug_utils labels are available
+        bool mUseDebugLabel;
+
+        //! guards every member below
+        mutable std::mutex mMutex;
+        //! frames in flight
+        std::vector<Frame> mFrames;
+        //! index of the current frame in mFrames
+        size_t mFrameIndex;
+        //! histories of each scope name
+        std::unordered_map<std::string, History> mHistories;
+    };
+}  // namespace vk2s
+
+#endif
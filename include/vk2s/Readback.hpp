@@ -0,0 +1,177 @@
+/*****************************************************************/ /**
+ * @file   Readback.hpp
+ * @brief  header file of Readback class
+ *
+ * @author agent
+ * @date   October 2026
+ *********************************************************************/
+#ifndef VK2S_INCLUDE_READBACK_HPP_
+#define VK2S_INCLUDE_READBACK_HPP_
+
+#ifndef VULKAN_HPP_DISPATCH_LOADER_DYNAMIC
+#define VULKAN_HPP_DISPATCH_LOADER_DYNAMIC 1
+#include <vulkan/vulkan.hpp>
+#endif
+
+#include "Macro.hpp"
+#include "SlotMap.hpp"
+
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <span>
+
+namespace vk2s
+{
+    //! forward declaration
+    class Device;
+    class Buffer;
+    class Image;
+    class Command;
+
+    /**
+     * @brief  class that copies Buffers and Images back to the host without stalling the GPU
+     * @detail readbackAsync() submits the copy into a pooled host cached Buffer (slot) to the graphics queue after the work submitted
+     *         so far and returns a ticket, which becomes ready when the submission timeline of Device passes the copy
+     *         the slot is recycled by read(), a new slot is added when every slot is in use, so keep slotNum tickets in flight
+     *         (e.g. read the ticket of frame N - 2 in frame N) and rendering never waits for the readback
+     *         isReady(), wait() and read() can be called from any thread, readbackAsync() records to the shared graphics command pool
+     *         of Device and must run on the thread recording the other Commands from that pool
+     */
+    class Readback
+    {
+    public:  // types
+        /**
+         * @brief  ticket identifying a readback (0 is invalid)
+         */
+        using Ticket = uint64_t;
+
+        /**
+         * @brief  statistics of the readback
+         */
+        struct Statistics
+        {
+            //! number of readbacks requested so far
+            size_t requestNum = 0;
+            //! number of slots (host cached Buffers)
+            size_t slotNum = 0;
+            //! number of times read() waited for the GPU
+            size_t stallNum = 0;
+            //! bytes read back so far
+            vk::DeviceSize readBytes = 0;
+        };
+
+    public:  // methods
+        /**
+         * @brief  constructor
+         *
+         * @param slotNum number of slots created up front (3 for triple buffering)
+         * @param slotSize initial byte size of each slot (grown on demand)
+         */
+        Readback(Device& device, const uint32_t slotNum = kDefaultSlotNum, const vk::DeviceSize slotSize = 0);
+
+        /**
+         * @brief  destructor
+         */
+        ~Readback();
+
+        NONCOPYABLE(Readback);
+        NONMOVABLE(Readback);
+
+        /**
+         * @brief  read back a range of the Buffer (needs vk::BufferUsageFlagBits::eTransferSrc)
+         *
+         * @param size size of the range (VK_WHOLE_SIZE to the end of the buffer)
+         * @return ticket of the readback
+         */
+        Ticket readbackAsync(Buffer& src, const vk::DeviceSize offset = 0, const vk::DeviceSize size = VK_WHOLE_SIZE);
+
+        /**
+         * @brief  read back the first mip level and layer of the Image (needs vk::ImageUsageFlagBits::eTransferSrc)
+         * @detail texels are tightly packed rows, the Image is returned to layout after the copy
+         *
+         * @param layout current layout of the Image (the writes to it must have been submitted before)
+         * @return ticket of the readback
+         */
+        Ticket readbackAsync(Image& src, const vk::ImageLayout layout);
+
+        /**
+         * @brief  whether the data of the ticket can be read without waiting
+         */
+        bool isReady(const Ticket ticket) const;
+
+        /**
+         * @brief  wait until the data of the ticket is ready
+         */
+        void wait(const Ticket ticket);
+
+        /**
+         * @brief  pass the data of the ticket to readFunc (waits if not ready) and recycle its slot
+         * @detail the wait and readFunc run without the internal lock, the ticket is invalid after this call (even if readFunc throws)
+         *         and must be read by one thread only
+         */
+        void read(const Ticket ticket, const std::function<void(std::span<const std::byte>)>& readFunc);
+
+        /**
+         * @brief  get the statistics of the readback
+         */
+        Statistics getStatistics() const;
+
+        //! default number of slots (triple buffering)
+        constexpr static uint32_t kDefaultSlotNum = 3;
+
+    private:  // types
+        /**
+         * @brief  host cached Buffer a readback is copied into
+         */
+        struct Slot
+        {
+            //! destination of the copy (invalid until the first use)
+            Handle<Buffer> buffer;
+            //! byte size of buffer
+            vk::DeviceSize capacity = 0;
+            //! command recording the copy
+            Handle<Command> command;
+            //! ticket using the slot (0 if free)
+            Ticket ticket = 0;
+            //! byte size of the data read back
+            vk::DeviceSize size = 0;
+            //! submission index of the copy
+            uint64_t submissionIndex = 0;
+        };
+
+    private:  // methods
+        /**
+         * @brief  get a free slot with at least size bytes (adds one if every slot is in use)
+         */
+        Slot& acquireSlot(const vk::DeviceSize size);
+
+        /**
+         * @brief  find the slot of the ticket
+         */
+        Slot& findSlot(const Ticket ticket);
+
+        /**
+         * @brief  submit the copy recorded by recordFunc into the slot and issue the ticket
+         */
+        Ticket submit(Slot& slot, const vk::DeviceSize size, const std::function<void(vk::CommandBuffer, vk::Buffer)>& recordFunc);
+
+    private:  // member variables
+        //! reference to device
+        Device& mDevice;
+        //! memory properties of the slots (host cached if available)
+        vk::MemoryPropertyFlags mSlotMemProps;
+
+        //! guards every member below
+        mutable std::mutex mMutex;
+        //! slots (elements are never moved, see std::deque)
+        std::deque<Slot> mSlots;
+        //! ticket issued last
+        Ticket mLastTicket;
+        //! statistics
+        Statistics mStats;
+    };
+}  // namespace vk2s
+
+#endif
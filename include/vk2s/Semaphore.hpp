@@ -22,15 +22,23 @@ namespace vk2s
 
     /**
      * @brief  class representing the GPU-GPU synchronization mechanism (Semaphore)
+     * @detail binary semaphore by default, timeline semaphore (monotonically increasing counter that can also be waited / signaled from the host) if an initial value is given
      */
     class Semaphore
     {
     public:  // methods
         /**
-         * @brief  constructor
+         * @brief  constructor (binary semaphore)
          */
         Semaphore(Device& device);
 
+        /**
+         * @brief  constructor (timeline semaphore)
+         *
+         * @param initialValue initial value of the counter
+         */
+        Semaphore(Device& device, const uint64_t initialValue);
+
         /**
          * @brief  destructor
          */
@@ -44,12 +52,37 @@ namespace vk2s
          */
         const vk::UniqueSemaphore& getVkSemaphore();
 
+        /**
+         * @brief  whether this is a timeline semaphore
+         */
+        bool isTimeline() const;
+
+        /**
+         * @brief  get the current value of the counter (timeline semaphore only)
+         */
+        uint64_t getValue() const;
+
+        /**
+         * @brief  set the counter to the value from the host (timeline semaphore only, must be greater than the current value)
+         */
+        void signal(const uint64_t value);
+
+        /**
+         * @brief  wait on the host until the counter reaches the value (timeline semaphore only)
+         *
+         * @param timeout timeout in nanoseconds
+         * @return false if timed out
+         */
+        bool wait(const uint64_t value, const uint64_t timeout = UINT64_MAX) const;
+
     private:  // member variables
         //! reference to device
         Device& mDevice;
 
         //! vulkan handle
         vk::UniqueSemaphore mSemaphore;
+        //! whether this is a timeline semaphore
+        bool mTimeline;
     };
 }
 
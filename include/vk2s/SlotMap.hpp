@@ -12,6 +12,14 @@
 #include <cstdint>
 #include <cstddef>
 #include <vector>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <algorithm>
+#include <memory>
+#include <memory_resource>
+#include <span>
+#include <tuple>
 #include <cassert>
 
 //! you can change this but you shouldn't
@@ -20,8 +28,99 @@ using IDType = std::uint64_t;
 constexpr IDType kInvalidID = 0xFFFFFFFFFFFFFFFF;
 //! default page allcoation size
 constexpr std::size_t kDefaultPageSize = 32;
+
+/**
+ * @brief  allocator of Pool pages that allocates from a std::pmr::memory_resource chosen at runtime
+ * @detail the resource must be safe to call from multiple threads and outlive every Pool using it
+ */
+class PageAllocator
+{
+public:
+    using value_type = std::byte;
+
+    //! alignment of every page
+    constexpr static std::size_t kPageAlignment = alignof(std::max_align_t);
+
+    /**
+     * @brief  constructor (allocates with new / delete)
+     */
+    PageAllocator() noexcept
+        : mpResource(std::pmr::new_delete_resource())
+    {
+    }
+
+    /**
+     * @brief  constructor (allocates from the specified resource, with new / delete if nullptr)
+     */
+    explicit PageAllocator(std::pmr::memory_resource* pResource) noexcept
+        : mpResource(pResource ? pResource : std::pmr::new_delete_resource())
+    {
+    }
+
+    /**
+     * @brief  allocate a page of the specified byte size
+     */
+    std::byte* allocate(const std::size_t size)
+    {
+        return static_cast<std::byte*>(mpResource->allocate(size, kPageAlignment));
+    }
+
+    /**
+     * @brief  release a page allocated by this allocator
+     */
+    void deallocate(std::byte* ptr, const std::size_t size)
+    {
+        mpResource->deallocate(ptr, size, kPageAlignment);
+    }
+
+    /**
+     * @brief  get the memory resource pages are allocated from
+     */
+    std::pmr::memory_resource* getResource() const noexcept
+    {
+        return mpResource;
+    }
+
+    bool operator==(const PageAllocator& other) const noexcept
+    {
+        return *mpResource == *other.mpResource;
+    }
+
+private:
+    //! memory resource pages are allocated from
+    std::pmr::memory_resource* mpResource;
+};
+
 //! default allocator Type
-using DefaultAllocator = std::allocator<std::byte>;
+using DefaultAllocator = PageAllocator;
+
+/**
+ * @brief  page size and allocator type of the Pool storing T (and the defaults of its handles)
+ * @detail specialize this before any handle of T is named to change them, the specialization must be visible to every translation unit (including the library)
+ */
+template <typename T>
+struct PoolTraits
+{
+    //! number of objects in each page (must be a power of 2)
+    constexpr static std::size_t kPageSize = kDefaultPageSize;
+    //! allocator of pages
+    using AllocatorType = DefaultAllocator;
+};
+
+/**
+ * @brief  occupancy statistics of a Pool
+ */
+struct PoolStatistics
+{
+    //! number of live objects
+    std::size_t liveObjectNum = 0;
+    //! number of pages currently allocated
+    std::size_t pageNum = 0;
+    //! maximum number of live objects observed so far
+    std::size_t highWaterMark = 0;
+    //! bytes currently reserved from the allocator (pages and page table)
+    std::size_t reservedBytes = 0;
+};
 
 /**
  * @brief  trait to determine if template argument N is a power of 2
@@ -36,6 +135,10 @@ struct IsPowerOf2
 template <typename T, std::size_t PageSize, typename Allocator, typename IsPowerOf2>
 class Pool;
 
+//! forward declaration
+template <typename T, std::size_t PageSize, typename Allocator>
+class CompactHandle;
+
 /**
  * @brief  class representing the handle to the object stored in the Pool
  * 
@@ -43,12 +146,13 @@ class Pool;
  * @PageSize  Pool page size
  * @Allocator Pool allocator
  */
-template <typename T, std::size_t PageSize = kDefaultPageSize, typename Allocator = DefaultAllocator>
+template <typename T, std::size_t PageSize = PoolTraits<T>::kPageSize, typename Allocator = typename PoolTraits<T>::AllocatorType>
 class Handle
 {
 protected:
     using PoolType = Pool<T, PageSize, Allocator, std::enable_if_t<IsPowerOf2<PageSize>::value>>;
     friend PoolType;
+    friend CompactHandle<T, PageSize, Allocator>;
 
 public:
     /**
@@ -61,9 +165,9 @@ public:
     }
 
     /**
-     * @brief  destructor
+     * @brief  destructor (non-virtual, handles are plain values)
      */
-    virtual ~Handle()
+    ~Handle()
     {
     }
 
@@ -172,7 +276,7 @@ protected:
 /**
  * @brief  Handle's no copying & RAII version
  */
-template <typename T, std::size_t PageSize = kDefaultPageSize, typename Allocator = DefaultAllocator>
+template <typename T, std::size_t PageSize = PoolTraits<T>::kPageSize, typename Allocator = typename PoolTraits<T>::AllocatorType>
 class UniqueHandle : public Handle<T, PageSize, Allocator>
 {
     using HandleType = Handle<T, PageSize, Allocator>;
@@ -187,9 +291,9 @@ public:
     }
 
     /**
-     * @brief  destructor
+     * @brief  destructor (releases the object without virtual dispatch)
      */
-    virtual ~UniqueHandle()
+    ~UniqueHandle()
     {
         if (this->mID != kInvalidID)
         {
@@ -239,24 +343,281 @@ protected:
 };
 
 /**
- * @brief  class that actually stores the object, accessible to each object via Handle
+ * @brief  8byte version of Handle, holding only the index and the generation of the slot
+ * @detail the Pool is found through the static per-type registry (Pool<T, PageSize, Allocator>::getRegistered()),
+ *         which holds the first constructed Pool of each type until it is destroyed (e.g. the Pools of the first of several Devices),
+ *         making a CompactHandle from a Handle of any other Pool is an assertion failure
  * 
  * @tparam T objects type
  * @PageSize  Pool page size
  * @Allocator Pool allocator
  */
-template <typename T, std::size_t PageSize = kDefaultPageSize, typename Allocator = DefaultAllocator, typename = std::enable_if_t<IsPowerOf2<PageSize>::value>>
+template <typename T, std::size_t PageSize = PoolTraits<T>::kPageSize, typename Allocator = typename PoolTraits<T>::AllocatorType>
+class CompactHandle
+{
+protected:
+    using PoolType   = Pool<T, PageSize, Allocator, std::enable_if_t<IsPowerOf2<PageSize>::value>>;
+    using HandleType = Handle<T, PageSize, Allocator>;
+    friend PoolType;
+
+public:
+    /**
+     * @brief  constructor
+     */
+    CompactHandle()
+        : mIndex(kInvalidIndex)
+        , mGeneration(kInvalidGeneration)
+    {
+    }
+
+    /**
+     * @brief  constructor from Handle (the Handle's Pool must be the registered one)
+     */
+    CompactHandle(const HandleType& handle)
+        : CompactHandle(handle.getRawID())
+    {
+        assert(!handle || handle.mpPool == PoolType::getRegistered() || !"the Pool of this handle is not registered (only the first Pool of each type serves CompactHandle)!");
+    }
+
+    /**
+     * @brief  obtain a raw ID on the Pool
+     */
+    IDType getRawID() const
+    {
+        return (static_cast<IDType>(mGeneration) << 32) | mIndex;
+    }
+
+    /**
+     * @brief  obtain the slot index on the Pool
+     */
+    std::uint32_t getIndex() const
+    {
+        return mIndex;
+    }
+
+    /**
+     * @brief  obtain the generation (active flag and slot counter) of the slot
+     */
+    std::uint32_t getGeneration() const
+    {
+        return mGeneration;
+    }
+
+    /**
+     * @brief  bool operator overload to determine if the ID is normal (active at the end of the handle)
+     */
+    explicit operator bool() const noexcept
+    {
+        return getRawID() != kInvalidID;
+    }
+
+    /**
+     * @brief  not operator overload to determine if the ID is normal (active at the end of the handle)
+     */
+    bool operator!() const noexcept
+    {
+        return !static_cast<bool>(*this);
+    }
+
+    /**
+     * @brief  operator overloading as Handle type
+     */
+    operator HandleType() const noexcept
+    {
+        return HandleType(getRawID(), PoolType::getRegistered());
+    }
+
+    /**
+     * @brief  obtain a reference to the object pointed to by the handle from the registered Pool
+     */
+    T& get() const
+    {
+        assert(getRawID() != kInvalidID || !"invalid handle!");
+        assert(PoolType::getRegistered() || !"no Pool is registered for this type!");
+        return PoolType::getRegistered()->getInternal(getRawID());
+    }
+
+    /**
+     * @brief  arrow operator overloading of the object pointed to
+     */
+    T* operator->() const
+    {
+        return &get();
+    }
+
+protected:
+    /**
+     * @brief  internal constructor
+     */
+    explicit CompactHandle(const IDType id)
+        : mIndex(static_cast<std::uint32_t>(id))
+        , mGeneration(static_cast<std::uint32_t>(id >> 32))
+    {
+    }
+
+    //! index of the invalid handle
+    constexpr static std::uint32_t kInvalidIndex      = static_cast<std::uint32_t>(kInvalidID);
+    //! generation of the invalid handle
+    constexpr static std::uint32_t kInvalidGeneration = static_cast<std::uint32_t>(kInvalidID >> 32);
+
+    //! slot index on the Pool (lower half of ID)
+    std::uint32_t mIndex;
+    //! activeFlag(1bit) | slot counter(31bit) (upper half of ID)
+    std::uint32_t mGeneration;
+};
+
+/**
+ * @brief  CompactHandle's no copying & RAII version (no virtual dispatch)
+ */
+template <typename T, std::size_t PageSize = PoolTraits<T>::kPageSize, typename Allocator = typename PoolTraits<T>::AllocatorType>
+class UniqueCompactHandle : public CompactHandle<T, PageSize, Allocator>
+{
+    using CompactHandleType = CompactHandle<T, PageSize, Allocator>;
+    using HandleType        = Handle<T, PageSize, Allocator>;
+
+public:
+    /**
+     * @brief  constructor
+     */
+    UniqueCompactHandle()
+        : CompactHandleType()
+    {
+    }
+
+    /**
+     * @brief  destructor
+     */
+    ~UniqueCompactHandle()
+    {
+        release();
+    }
+
+    // noncopyable (can't use macro)
+    UniqueCompactHandle(const UniqueCompactHandle& other)            = delete;
+    UniqueCompactHandle& operator=(const UniqueCompactHandle& other) = delete;
+
+    /**
+     * @brief  move constructor
+     */
+    UniqueCompactHandle(UniqueCompactHandle&& other) noexcept
+        : CompactHandleType(other)
+    {
+        other.invalidate();
+    }
+
+    /**
+     * @brief  move constructor (from Handle)
+     */
+    UniqueCompactHandle(HandleType&& other)
+        : CompactHandleType(other)
+    {
+        other = HandleType();
+    }
+
+    /**
+     * @brief  assignment operator overload (move)
+     */
+    UniqueCompactHandle& operator=(UniqueCompactHandle&& other) noexcept
+    {
+        if (this != &other)
+        {
+            release();
+            CompactHandleType::operator=(other);
+            other.invalidate();
+        }
+
+        return *this;
+    }
+
+    /**
+     * @brief  assignment operator overload (move, from Handle)
+     */
+    UniqueCompactHandle& operator=(HandleType&& other)
+    {
+        release();
+        CompactHandleType::operator=(CompactHandleType(other));
+        other = HandleType();
+
+        return *this;
+    }
+
+private:
+    /**
+     * @brief  invalidate this handle without releasing the object
+     */
+    void invalidate()
+    {
+        this->mIndex      = CompactHandleType::kInvalidIndex;
+        this->mGeneration = CompactHandleType::kInvalidGeneration;
+    }
+
+    /**
+     * @brief  release the object (if exists) and invalidate this handle
+     */
+    void release()
+    {
+        if (static_cast<bool>(*this))
+        {
+            if (auto pPool = CompactHandleType::PoolType::getRegistered())
+            {
+                pPool->deallocInternal(this->getRawID());
+            }
+            invalidate();
+        }
+    }
+};
+
+static_assert(sizeof(CompactHandle<int>) == sizeof(IDType), "CompactHandle must be as small as a raw ID!");
+
+/**
+ * @brief  class that actually stores the object, accessible to each object via Handle
+ * @detail allocate(), deallocate() and get() are lock-free and can be called from multiple threads at the same time
+ *         (free slots are kept in a tagged Treiber stack, pages are published into a segmented page table whose storage never moves)
+ *         forEach() and clear() require that no other thread is using the Pool
+ * 
+ * @tparam T objects type
+ * @PageSize  Pool page size
+ * @Allocator Pool allocator (must be safe to call from multiple threads, see PageAllocator)
+ */
+template <typename T, std::size_t PageSize = PoolTraits<T>::kPageSize, typename Allocator = typename PoolTraits<T>::AllocatorType, typename = std::enable_if_t<IsPowerOf2<PageSize>::value>>
 class Pool
 {
-    using HandleType       = Handle<T, PageSize, Allocator>;
-    using UniqueHandleType = UniqueHandle<T, PageSize, Allocator>;
+    using HandleType              = Handle<T, PageSize, Allocator>;
+    using UniqueHandleType        = UniqueHandle<T, PageSize, Allocator>;
+    using CompactHandleType       = CompactHandle<T, PageSize, Allocator>;
+    using UniqueCompactHandleType = UniqueCompactHandle<T, PageSize, Allocator>;
+    friend CompactHandleType;
+    friend UniqueCompactHandleType;
+
+    static_assert(alignof(T) <= alignof(std::max_align_t), "over-aligned types can't be stored in the Pool!");
 
 public:
+    using AllocatorType = Allocator;
+
     /**
      * @brief  constructor
      */
     Pool()
+        : Pool(Allocator())
+    {
+    }
+
+    /**
+     * @brief  constructor (with allocator instance)
+     */
+    explicit Pool(const Allocator& allocator)
+        : mAllocator(allocator)
+        , mFreeHead(kNullHead)
+        , mReleasedPageHead(kNullHead)
+        , mPageNum(0)
+        , mAllocatedPageNum(0)
+        , mLiveNum(0)
+        , mHighWaterMark(0)
+        , mSlotBase(0)
     {
+        // the first Pool of each type is used by CompactHandle, later ones must not take over the handles already made
+        Pool* pExpected = nullptr;
+        spRegistered.compare_exchange_strong(pExpected, this, std::memory_order_acq_rel);
     }
 
     /**
@@ -265,6 +626,10 @@ public:
     ~Pool()
     {
         clear();
+
+        // only the registered Pool unregisters
+        Pool* pThis = this;
+        spRegistered.compare_exchange_strong(pThis, nullptr, std::memory_order_acq_rel);
     }
 
     //! noncopyable (can't use macro)
@@ -292,6 +657,7 @@ public:
      * @brief  releases the object of the specified handle
      * 
      * @param handle pointing to the object to be released
+     * @return false if the handle doesn't point to a live object
      */
     bool deallocate(HandleType& handle)
     {
@@ -301,6 +667,69 @@ public:
         return res;
     }
 
+    /**
+     * @brief  allocating multiple objects at once (free slots and new pages are reserved in bulk before construction)
+     * @detail if a constructor throws, the objects already constructed by this call are released before rethrowing
+     * 
+     * @tparam Generator type of the function returning the constructor arguments of the i-th object as std::tuple
+     * @param count number of objects to allocate
+     * @param generator function returning the constructor arguments of the i-th object as std::tuple
+     * @return Handles of allocated objects (in the order of generation)
+     */
+    template <typename Generator>
+    std::vector<HandleType> allocateBatch(const std::size_t count, Generator&& generator)
+    {
+        std::vector<std::uint32_t> indices;
+        reserveIndices(count, indices);
+
+        std::vector<HandleType> handles;
+        handles.reserve(count);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            try
+            {
+                const IDType id = std::apply([&](auto&&... args) { return constructAt(indices[i], std::forward<decltype(args)>(args)...); }, generator(i));
+                handles.push_back(HandleType(id, this));
+            }
+            catch (...)
+            {
+                // constructAt() has already returned indices[i]
+                for (const auto& handle : handles)
+                {
+                    deallocInternal(handle.getRawID());
+                }
+                pushFreeIndexArray(std::span(indices).subspan(i + 1));
+                throw;
+            }
+        }
+
+        return handles;
+    }
+
+    /**
+     * @brief  releases the objects of the specified handles at once (freed slots are returned to the free list in one operation)
+     * 
+     * @param handles pointing to the objects to be released (all of them are invalidated)
+     * @return number of released objects (handles that don't point to a live object are skipped)
+     */
+    std::size_t deallocateBatch(std::span<HandleType> handles)
+    {
+        std::vector<std::uint32_t> freed;
+        freed.reserve(handles.size());
+        for (auto& handle : handles)
+        {
+            if (releaseSlot(handle.getRawID()))
+            {
+                freed.emplace_back(static_cast<std::uint32_t>(handle.getRawID() & kMask));
+            }
+            handle.mID = kInvalidID;
+        }
+
+        pushFreeIndexArray(freed);
+
+        return freed.size();
+    }
+
     /**
      * @brief  obtains a reference to the object pointed to by the specified handle
      * 
@@ -311,6 +740,24 @@ public:
         return getInternal(handle.getRawID());
     }
 
+    /**
+     * @brief  obtains a reference to the object pointed to by the specified compact handle
+     * 
+     * @param handle pointing to the object
+     */
+    T& get(CompactHandleType handle)
+    {
+        return getInternal(handle.getRawID());
+    }
+
+    /**
+     * @brief  get the Pool used by CompactHandle of this type (the first constructed one, nullptr once it is destroyed)
+     */
+    static Pool* getRegistered()
+    {
+        return spRegistered.load(std::memory_order_acquire);
+    }
+
     /**
      * @brief  execute func for all stored objects
      * @detail if you have a few handles, you should use get() directly
@@ -321,22 +768,48 @@ public:
     template <typename Func>
     void forEach(Func func)
     {
-        for (auto [pPage, activeHandleNum] : mPageTable)
+        std::uint32_t pageIndex     = 0;
+        const std::uint32_t pageNum = mPageNum.load(std::memory_order_acquire);
+        for (std::size_t segment = 0; segment < kSegmentNum && pageIndex < pageNum; ++segment)
         {
-            // skip empty page
-            if (activeHandleNum == 0)
+            const PageEntry* pSegment = mSegments[segment].load(std::memory_order_acquire);
+            const std::size_t entryNum = kFirstSegmentSize << segment;
+            if (!pSegment)
             {
+                pageIndex += static_cast<std::uint32_t>(entryNum);
                 continue;
             }
 
-            const IDType* IDptr    = reinterpret_cast<IDType*>(pPage + kTypeOffset);
-            T* objectPtr           = reinterpret_cast<T*>(pPage);
-            constexpr uint64_t MSB = (static_cast<IDType>(1) << (kShiftLength * 2 - 1));
-            for (std::size_t i = 0; i < PageSize; ++i)
+            for (std::size_t i = 0; i < entryNum && pageIndex < pageNum; ++i, ++pageIndex)
             {
-                if (IDptr[i] & MSB)  // if active
+                const PageEntry& entry = pSegment[i];
+                std::byte* pPage       = entry.pPage.load(std::memory_order_acquire);
+
+                // skip empty page
+                if (!pPage || entry.activeNum.load(std::memory_order_relaxed) == 0)
+                {
+                    continue;
+                }
+
+                // visit only the set bits of the occupancy bitmap
+                T* objectPtr = reinterpret_cast<T*>(pPage);
+                for (std::size_t word = 0; word < kBitmapWordNum; ++word, objectPtr += 64)
                 {
-                    func(objectPtr[i]);
+                    std::uint64_t bits = entry.occupancy[word].load(std::memory_order_acquire);
+                    if (bits == kFullWord)
+                    {
+                        for (std::size_t bit = 0; bit < std::min<std::size_t>(PageSize, 64); ++bit)
+                        {
+                            func(objectPtr[bit]);
+                        }
+                        continue;
+                    }
+
+                    while (bits)
+                    {
+                        func(objectPtr[std::countr_zero(bits)]);
+                        bits &= bits - 1;
+                    }
                 }
             }
         }
@@ -349,57 +822,220 @@ public:
     {
         forEach([](T& val) { val.~T(); });
 
-        for (auto [pPage, activeHandleNum] : mPageTable)
+        const std::uint32_t pageNum = mPageNum.load(std::memory_order_acquire);
+        for (std::uint32_t pageIndex = 0; pageIndex < pageNum; ++pageIndex)
+        {
+            PageEntry* pEntry = getPageEntry(pageIndex);
+            if (std::byte* pPage = pEntry ? pEntry->pPage.load(std::memory_order_acquire) : nullptr)
+            {
+                mAllocator.deallocate(pPage, kPageByteSize);
+            }
+        }
+
+        for (auto& segment : mSegments)
+        {
+            delete[] segment.exchange(nullptr, std::memory_order_acq_rel);
+        }
+
+        mPageNum.store(0, std::memory_order_release);
+        mFreeHead.store(kNullHead, std::memory_order_release);
+        mReleasedPageHead.store(kNullHead, std::memory_order_release);
+        mAllocatedPageNum.store(0, std::memory_order_relaxed);
+        mLiveNum.store(0, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief  replace the allocator of pages
+     * @detail only allowed while the Pool holds no pages (before the first allocation or after clear())
+     */
+    void setAllocator(const Allocator& allocator)
+    {
+        assert(mPageNum.load(std::memory_order_acquire) == 0 || !"the allocator can't be replaced while the Pool holds pages!");
+        mAllocator = allocator;
+    }
+
+    /**
+     * @brief  get the allocator of pages
+     */
+    const Allocator& getAllocator() const
+    {
+        return mAllocator;
+    }
+
+    /**
+     * @brief  get the occupancy statistics of this Pool
+     */
+    PoolStatistics getStatistics() const
+    {
+        PoolStatistics stats;
+        stats.liveObjectNum = mLiveNum.load(std::memory_order_relaxed);
+        stats.pageNum       = mAllocatedPageNum.load(std::memory_order_relaxed);
+        stats.highWaterMark = mHighWaterMark.load(std::memory_order_relaxed);
+        stats.reservedBytes = stats.pageNum * kPageByteSize;
+
+        for (std::size_t segment = 0; segment < kSegmentNum; ++segment)
+        {
+            if (mSegments[segment].load(std::memory_order_relaxed))
+            {
+                stats.reservedBytes += (kFirstSegmentSize << segment) * sizeof(PageEntry);
+            }
+        }
+
+        return stats;
+    }
+
+    /**
+     * @brief  return every page without live objects (and the page table segments past the last used page) to the allocator
+     * @detail requires that no other thread is using the Pool, handles to live objects stay valid
+     * 
+     * @return number of released pages
+     */
+    std::size_t shrink()
+    {
+        std::size_t releasedNum     = 0;
+        std::uint32_t newPageNum    = 0;
+        const std::uint32_t pageNum = mPageNum.load(std::memory_order_acquire);
+        for (std::uint32_t pageIndex = 0; pageIndex < pageNum; ++pageIndex)
         {
+            PageEntry* pEntry = getPageEntry(pageIndex);
+            std::byte* pPage  = pEntry ? pEntry->pPage.load(std::memory_order_acquire) : nullptr;
+            if (!pPage)
+            {
+                continue;
+            }
+
+            if (pEntry->activeNum.load(std::memory_order_relaxed) != 0)
+            {
+                newPageNum = pageIndex + 1;
+                continue;
+            }
+
+            // raise the initial slot of future pages above every slot of this page, so stale handles never match reused slots
+            const IDType* IDptr = reinterpret_cast<IDType*>(pPage + kTypeOffset);
+            for (std::size_t i = 0; i < PageSize; ++i)
+            {
+                mSlotBase = std::max(mSlotBase, static_cast<std::uint32_t>((((IDptr[i] >> kShiftLength) + 1) & kSlotMask)));
+            }
+
             mAllocator.deallocate(pPage, kPageByteSize);
+            pEntry->pPage.store(nullptr, std::memory_order_release);
+            ++releasedNum;
         }
 
-        mPageTable.clear();
-        mFreePosTable.clear();
+        // rebuild the free lists from the remaining pages (in reverse so that lower slots are reused first)
+        mFreeHead.store(kNullHead, std::memory_order_relaxed);
+        mReleasedPageHead.store(kNullHead, std::memory_order_relaxed);
+        for (std::uint32_t pageIndex = newPageNum; pageIndex-- > 0;)
+        {
+            PageEntry* pEntry = getPageEntry(pageIndex);
+            std::byte* pPage  = pEntry ? pEntry->pPage.load(std::memory_order_relaxed) : nullptr;
+            if (!pPage)
+            {
+                pushReleasedPage(pageIndex);
+                continue;
+            }
+
+            const IDType* IDptr = reinterpret_cast<IDType*>(pPage + kTypeOffset);
+            for (std::size_t i = PageSize; i-- > 0;)
+            {
+                if (!(IDptr[i] & kActiveFlag))
+                {
+                    const auto index = pageIndex * static_cast<std::uint32_t>(PageSize) + static_cast<std::uint32_t>(i);
+                    pushFreeIndices(index, index);
+                }
+            }
+        }
+
+        // release the page table segments that are entirely past the last used page
+        for (std::size_t segment = 0; segment < kSegmentNum; ++segment)
+        {
+            const std::size_t firstPageIndex = kFirstSegmentSize * ((static_cast<std::size_t>(1) << segment) - 1);
+            if (firstPageIndex >= newPageNum)
+            {
+                delete[] mSegments[segment].exchange(nullptr, std::memory_order_acq_rel);
+            }
+        }
+
+        mPageNum.store(newPageNum, std::memory_order_release);
+        mAllocatedPageNum.fetch_sub(releasedNum, std::memory_order_relaxed);
+
+        return releasedNum;
     }
 
 private:
+    //! number of 64bit words in the occupancy bitmap of each page
+    constexpr static std::size_t kBitmapWordNum = (PageSize + 63) / 64;
+    //! occupancy bitmap word whose slots are all active
+    constexpr static std::uint64_t kFullWord    = PageSize >= 64 ? ~static_cast<std::uint64_t>(0) : (static_cast<std::uint64_t>(1) << (PageSize % 64)) - 1;
+
+    /**
+     * @brief  entry of the page table
+     */
+    struct PageEntry
+    {
+        //! pointer to page (nullptr until the page is published)
+        std::atomic<std::byte*> pPage;
+        //! current number of active objects in the page
+        std::atomic<std::uint32_t> activeNum;
+        //! occupancy bitmap of the page (bit i is set while slot i holds a live object)
+        std::array<std::atomic<std::uint64_t>, kBitmapWordNum> occupancy;
+        //! next entry in the list of released page indices
+        std::atomic<std::uint32_t> nextReleased;
+    };
+
     /**
      * @brief  internal implementation of the allocate function
      */
     template <typename... Args>
     IDType allocInternal(Args&&... args)
     {
-        if (mFreePosTable.empty())
+        std::uint32_t index = popFreeIndex();
+        if (index == kNullIndex)
         {
-            std::byte* pPage = mAllocator.allocate(kPageByteSize);
+            index = addPage();
+        }
 
-            for (std::size_t i = 0; i < PageSize; ++i)
-            {
-                IDType id                                                           = mPageTable.size() * PageSize + i;
-                *reinterpret_cast<IDType*>(pPage + kTypeOffset + sizeof(IDType) * i) = id;
-                mFreePosTable.emplace_back(id);
-            }
+        return constructAt(index, std::forward<Args>(args)...);
+    }
 
-            mPageTable.emplace_back(pPage, 0);
-        }
+    /**
+     * @brief  construct an object on the reserved slot and activate it (return the slot if the constructor throws)
+     */
+    template <typename... Args>
+    IDType constructAt(const std::uint32_t index, Args&&... args)
+    {
+        const auto div = index / PageSize;
+        const auto mod = index % PageSize;
 
-        // register ID
-        const auto id = mFreePosTable.back();
-        mFreePosTable.pop_back();
+        PageEntry& entry = *getPageEntry(div);
+        std::byte* pPage = entry.pPage.load(std::memory_order_acquire);
 
-        //constexpr uint32_t MSB = getMSB(PageSize);
-        const auto div = id / PageSize;  // id >> MSB;
-        const auto mod = id % PageSize;  // (id << (kShiftLength - MSB)) >> (kShiftLength - MSB);
+        // construct
+        try
+        {
+            new (pPage + sizeof(T) * mod) T(std::forward<Args>(args)...);
+        }
+        catch (...)
+        {
+            pushFreeIndices(index, index);
+            throw;
+        }
 
         // increment active handle num in page
-        ++mPageTable[div].second;
+        entry.activeNum.fetch_add(1, std::memory_order_relaxed);
+        entry.occupancy[mod / 64].fetch_or(static_cast<std::uint64_t>(1) << (mod % 64), std::memory_order_release);
 
-        // construct
+        // update statistics
+        const std::size_t liveNum = mLiveNum.fetch_add(1, std::memory_order_relaxed) + 1;
+        std::size_t highWaterMark = mHighWaterMark.load(std::memory_order_relaxed);
+        while (liveNum > highWaterMark && !mHighWaterMark.compare_exchange_weak(highWaterMark, liveNum, std::memory_order_relaxed))
         {
-            new (mPageTable[div].first + sizeof(T) * mod) T(std::forward<Args>(args)...);
         }
 
-        auto pTargetID = reinterpret_cast<IDType*>(mPageTable[div].first + kTypeOffset + sizeof(IDType) * mod);
-        // activate flag
-        *pTargetID |= (static_cast<IDType>(1) << (kShiftLength * 2 - 1));
+        // activate flag (published to releaseSlot() of other threads)
+        std::atomic_ref<IDType> targetID(*reinterpret_cast<IDType*>(pPage + kTypeOffset + sizeof(IDType) * mod));
 
-        return *pTargetID;
+        return targetID.fetch_or(kActiveFlag, std::memory_order_release) | kActiveFlag;
     }
 
     /**
@@ -407,36 +1043,60 @@ private:
      */
     bool deallocInternal(const IDType id)
     {
-        const auto maskedID = id & kMask;
+        if (!releaseSlot(id))
+        {
+            return false;
+        }
+
+        // return to be free
+        pushFreeIndices(static_cast<std::uint32_t>(id & kMask), static_cast<std::uint32_t>(id & kMask));
+
+        return true;
+    }
+
+    /**
+     * @brief  destruct the object and deactivate its slot without returning it to the free list
+     * 
+     * @return false if the ID doesn't point to a live object
+     */
+    bool releaseSlot(const IDType id)
+    {
+        const auto maskedID = static_cast<std::uint32_t>(id & kMask);
         const auto div      = maskedID / PageSize;
         const auto mod      = maskedID % PageSize;
 
-        if (div >= mPageTable.size()) // invalid handle
+        PageEntry* pEntry = div < mPageNum.load(std::memory_order_acquire) ? getPageEntry(div) : nullptr;
+        std::byte* pPage  = pEntry ? pEntry->pPage.load(std::memory_order_acquire) : nullptr;
+        if (!pPage)  // invalid handle
         {
             return false;
         }
 
-        // destruct
+        if (!(id & kActiveFlag))  // invalid handle
         {
-            T* ptr = reinterpret_cast<T*>(mPageTable[div].first + sizeof(T) * mod);
-            ptr->~T();
+            return false;
         }
 
-        // rotate slot
+        // claim the slot by rotating its slot counter (and deactivating the flag), only one of the threads releasing the same ID succeeds
+        std::atomic_ref<IDType> objectID(*reinterpret_cast<IDType*>(pPage + kTypeOffset + sizeof(IDType) * mod));
+        IDType expected      = id;
+        const IDType rotated = maskedID | ((((id >> kShiftLength) + 1) & kSlotMask) << kShiftLength);
+        if (!objectID.compare_exchange_strong(expected, rotated, std::memory_order_acq_rel, std::memory_order_relaxed))  // already released (or stale) handle
         {
-            auto pObjectID = reinterpret_cast<IDType*>(mPageTable[div].first + kTypeOffset + sizeof(IDType) * mod);
+            return false;
+        }
 
-            *pObjectID = (*pObjectID & kMask) | (((*pObjectID >> kShiftLength) + 1) << kShiftLength);
+        pEntry->occupancy[mod / 64].fetch_and(~(static_cast<std::uint64_t>(1) << (mod % 64)), std::memory_order_relaxed);
 
-            // deactivate flag
-            *pObjectID &= ~(static_cast<IDType>(1) << (kShiftLength * 2 - 1));
+        // destruct
+        {
+            T* ptr = reinterpret_cast<T*>(pPage + sizeof(T) * mod);
+            ptr->~T();
         }
 
-        // remove active ID and return to be free
-        mFreePosTable.emplace_back(maskedID);
-
         // decrement active page handle num
-        --mPageTable[div].second;
+        pEntry->activeNum.fetch_sub(1, std::memory_order_relaxed);
+        mLiveNum.fetch_sub(1, std::memory_order_relaxed);
 
         return true;
     }
@@ -449,31 +1109,325 @@ private:
         assert(id != kInvalidID || !"invalid handle!");
 
         const uint32_t maskedID = static_cast<uint32_t>(id & kMask);
-        //constexpr uint32_t MSB = getMSB(PageSize);
-        const auto div = maskedID / PageSize;  // maskedID >> MSB;
-        const auto mod = maskedID % PageSize;  // (maskedID << (32 - MSB)) >> (32 - MSB);
+        const auto div          = maskedID / PageSize;
+        const auto mod          = maskedID % PageSize;
 
-        assert(div < mPageTable.size() || !"invalid handle!");
-        assert(id == *reinterpret_cast<IDType*>(mPageTable[div].first + kTypeOffset + sizeof(IDType) * mod) || !"invalid handle!");
+        const PageEntry* pEntry = getPageEntry(div);
+        assert(pEntry || !"invalid handle!");
+        std::byte* pPage = pEntry->pPage.load(std::memory_order_acquire);
+        assert(pPage || !"invalid handle!");
+        assert(id == std::atomic_ref<IDType>(*reinterpret_cast<IDType*>(pPage + kTypeOffset + sizeof(IDType) * mod)).load(std::memory_order_acquire) || !"invalid handle!");
 
-        return *reinterpret_cast<T*>(mPageTable[div].first + sizeof(T) * mod);
+        return *reinterpret_cast<T*>(pPage + sizeof(T) * mod);
+    }
+
+    /**
+     * @brief  allocate a new page, publish it and push all but its first slot to the free list
+     * 
+     * @return index of the first slot of the new page (reserved for the caller)
+     */
+    std::uint32_t addPage()
+    {
+        // reuse the index of a page released by shrink() if exists
+        std::uint32_t pageIndex = popReleasedPage();
+        if (pageIndex == kNullIndex)
+        {
+            pageIndex = mPageNum.fetch_add(1, std::memory_order_acq_rel);
+        }
+
+        const std::uint32_t base = preparePage(pageIndex);
+
+        if constexpr (PageSize > 1)
+        {
+            // slots are already linked in order, so push them as one chain
+            pushFreeIndices(base + 1, base + static_cast<std::uint32_t>(PageSize) - 1);
+        }
+
+        return base;
+    }
+
+    /**
+     * @brief  allocate a page for the page index and publish it (its slots are linked in order but not pushed to the free list)
+     * 
+     * @return index of the first slot of the page
+     */
+    std::uint32_t preparePage(const std::uint32_t pageIndex)
+    {
+        assert(pageIndex < kMaxPageNum || !"Pool is exhausted!");
+
+        std::byte* pPage         = mAllocator.allocate(kPageByteSize);
+        const std::uint32_t base = pageIndex * static_cast<std::uint32_t>(PageSize);
+        const IDType slotBase    = static_cast<IDType>(mSlotBase) << kShiftLength;
+
+        for (std::uint32_t i = 0; i < PageSize; ++i)
+        {
+            *reinterpret_cast<IDType*>(pPage + kTypeOffset + sizeof(IDType) * i) = slotBase | (base + i);
+            new (pPage + kLinkOffset + sizeof(std::atomic<std::uint32_t>) * i) std::atomic<std::uint32_t>(i + 1 < PageSize ? base + i + 1 : kNullIndex);
+        }
+
+        getPageEntry(pageIndex, true)->pPage.store(pPage, std::memory_order_release);
+        mAllocatedPageNum.fetch_add(1, std::memory_order_relaxed);
+
+        return base;
+    }
+
+    /**
+     * @brief  reserve count free slot indices for the caller at once
+     * @detail takes a chain from the free list, then allocates all missing pages with a single page index reservation
+     */
+    void reserveIndices(const std::size_t count, std::vector<std::uint32_t>& indices)
+    {
+        indices.reserve(count);
+        popFreeIndices(count, indices);
+        if (indices.size() == count)
+        {
+            return;
+        }
+
+        std::size_t pageNum = (count - indices.size() + PageSize - 1) / PageSize;
+        std::vector<std::uint32_t> pageIndices;
+        pageIndices.reserve(pageNum);
+
+        // reuse the indices of pages released by shrink() first
+        for (std::uint32_t pageIndex = 0; pageIndices.size() < pageNum && (pageIndex = popReleasedPage()) != kNullIndex;)
+        {
+            pageIndices.emplace_back(pageIndex);
+        }
+
+        if (const std::size_t restNum = pageNum - pageIndices.size(); restNum > 0)
+        {
+            const std::uint32_t first = mPageNum.fetch_add(static_cast<std::uint32_t>(restNum), std::memory_order_acq_rel);
+            for (std::size_t i = 0; i < restNum; ++i)
+            {
+                pageIndices.emplace_back(first + static_cast<std::uint32_t>(i));
+            }
+        }
+
+        for (const auto pageIndex : pageIndices)
+        {
+            const std::uint32_t base    = preparePage(pageIndex);
+            const std::uint32_t usedNum = static_cast<std::uint32_t>(std::min<std::size_t>(PageSize, count - indices.size()));
+            for (std::uint32_t i = 0; i < usedNum; ++i)
+            {
+                indices.emplace_back(base + i);
+            }
+
+            // the rest of the last page is already linked in order
+            if (usedNum < PageSize)
+            {
+                pushFreeIndices(base + usedNum, base + static_cast<std::uint32_t>(PageSize) - 1);
+            }
+        }
+    }
+
+    /**
+     * @brief  pop a free slot index from the lock-free free list (kNullIndex if empty)
+     */
+    std::uint32_t popFreeIndex()
+    {
+        std::uint64_t head = mFreeHead.load(std::memory_order_acquire);
+        while (static_cast<std::uint32_t>(head) != kNullIndex)
+        {
+            const std::uint32_t index = static_cast<std::uint32_t>(head);
+            const std::uint32_t next  = getLink(index).load(std::memory_order_relaxed);
+            // the upper 32bit is a tag incremented on every update to avoid ABA
+            const std::uint64_t newHead = (((head >> 32) + 1) << 32) | next;
+
+            if (mFreeHead.compare_exchange_weak(head, newHead, std::memory_order_acq_rel, std::memory_order_acquire))
+            {
+                return index;
+            }
+        }
+
+        return kNullIndex;
+    }
+
+    /**
+     * @brief  push a chain of free slot indices (already linked from first to last) to the lock-free free list
+     */
+    void pushFreeIndices(const std::uint32_t first, const std::uint32_t last)
+    {
+        auto& lastLink     = getLink(last);
+        std::uint64_t head = mFreeHead.load(std::memory_order_relaxed);
+        std::uint64_t newHead;
+        do
+        {
+            lastLink.store(static_cast<std::uint32_t>(head), std::memory_order_relaxed);
+            newHead = (((head >> 32) + 1) << 32) | first;
+        } while (!mFreeHead.compare_exchange_weak(head, newHead, std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    /**
+     * @brief  pop a chain of up to maxCount free slot indices from the lock-free free list with a single CAS
+     */
+    void popFreeIndices(const std::size_t maxCount, std::vector<std::uint32_t>& indices)
+    {
+        const std::size_t prevSize = indices.size();
+        std::uint64_t head         = mFreeHead.load(std::memory_order_acquire);
+        while (static_cast<std::uint32_t>(head) != kNullIndex)
+        {
+            // links always hold valid indices, and the tag makes the CAS fail if the chain was modified while walking
+            indices.resize(prevSize);
+            std::uint32_t index = static_cast<std::uint32_t>(head);
+            while (index != kNullIndex && indices.size() - prevSize < maxCount)
+            {
+                indices.emplace_back(index);
+                index = getLink(index).load(std::memory_order_relaxed);
+            }
+
+            const std::uint64_t newHead = (((head >> 32) + 1) << 32) | index;
+            if (mFreeHead.compare_exchange_weak(head, newHead, std::memory_order_acq_rel, std::memory_order_acquire))
+            {
+                return;
+            }
+        }
+
+        indices.resize(prevSize);
+    }
+
+    /**
+     * @brief  link free slot indices in the order of the array and push them to the lock-free free list as one chain
+     */
+    void pushFreeIndexArray(std::span<const std::uint32_t> indices)
+    {
+        if (indices.empty())
+        {
+            return;
+        }
+
+        for (std::size_t i = 0; i + 1 < indices.size(); ++i)
+        {
+            getLink(indices[i]).store(indices[i + 1], std::memory_order_relaxed);
+        }
+
+        pushFreeIndices(indices.front(), indices.back());
+    }
+
+    /**
+     * @brief  pop a page index released by shrink() (kNullIndex if empty)
+     */
+    std::uint32_t popReleasedPage()
+    {
+        std::uint64_t head = mReleasedPageHead.load(std::memory_order_acquire);
+        while (static_cast<std::uint32_t>(head) != kNullIndex)
+        {
+            const std::uint32_t pageIndex = static_cast<std::uint32_t>(head);
+            const std::uint32_t next      = getPageEntry(pageIndex)->nextReleased.load(std::memory_order_relaxed);
+            const std::uint64_t newHead   = (((head >> 32) + 1) << 32) | next;
+
+            if (mReleasedPageHead.compare_exchange_weak(head, newHead, std::memory_order_acq_rel, std::memory_order_acquire))
+            {
+                return pageIndex;
+            }
+        }
+
+        return kNullIndex;
+    }
+
+    /**
+     * @brief  push a page index released by shrink() (only called by shrink(), so no other thread is running)
+     */
+    void pushReleasedPage(const std::uint32_t pageIndex)
+    {
+        const std::uint64_t head = mReleasedPageHead.load(std::memory_order_relaxed);
+        getPageEntry(pageIndex)->nextReleased.store(static_cast<std::uint32_t>(head), std::memory_order_relaxed);
+        mReleasedPageHead.store((((head >> 32) + 1) << 32) | pageIndex, std::memory_order_release);
+    }
+
+    /**
+     * @brief  get the free list link of the specified slot
+     */
+    std::atomic<std::uint32_t>& getLink(const std::uint32_t index)
+    {
+        std::byte* pPage = getPageEntry(index / PageSize)->pPage.load(std::memory_order_acquire);
+        return *reinterpret_cast<std::atomic<std::uint32_t>*>(pPage + kLinkOffset + sizeof(std::atomic<std::uint32_t>) * (index % PageSize));
+    }
+
+    /**
+     * @brief  get the entry of the page table (segment k holds kFirstSegmentSize << k entries and never moves)
+     * 
+     * @param pageIndex index of the page
+     * @param create whether to allocate the segment if it doesn't exist yet
+     */
+    PageEntry* getPageEntry(const std::uint32_t pageIndex, const bool create = false)
+    {
+        const std::size_t biased  = static_cast<std::size_t>(pageIndex) + kFirstSegmentSize;
+        const std::size_t segment = std::bit_width(biased) - 1 - kFirstSegmentShift;
+        const std::size_t offset  = biased - (kFirstSegmentSize << segment);
+
+        PageEntry* pSegment = mSegments[segment].load(std::memory_order_acquire);
+        if (!pSegment && create)
+        {
+            PageEntry* pNewSegment = new PageEntry[kFirstSegmentSize << segment]();
+            if (mSegments[segment].compare_exchange_strong(pSegment, pNewSegment, std::memory_order_acq_rel, std::memory_order_acquire))
+            {
+                pSegment = pNewSegment;
+            }
+            else  // another thread has published this segment
+            {
+                delete[] pNewSegment;
+            }
+        }
+
+        return pSegment ? pSegment + offset : nullptr;
+    }
+
+    /**
+     * @brief  round up size to the specified alignment
+     */
+    constexpr static std::size_t alignUp(const std::size_t size, const std::size_t align)
+    {
+        return (size + align - 1) & ~(align - 1);
     }
 
-    //! byte size per page
-    constexpr static std::size_t kTypeOffset   = PageSize * sizeof(T);
+    //! byte offset to the ID area of each page (aligned to be accessed through std::atomic_ref)
+    constexpr static std::size_t kTypeOffset   = alignUp(PageSize * sizeof(T), std::atomic_ref<IDType>::required_alignment);
+    //! byte offset to the free list link area of each page
+    constexpr static std::size_t kLinkOffset   = kTypeOffset + PageSize * sizeof(IDType);
     //! byte size of each page
-    constexpr static std::size_t kPageByteSize = kTypeOffset + PageSize * sizeof(IDType);
+    constexpr static std::size_t kPageByteSize = kLinkOffset + PageSize * sizeof(std::atomic<std::uint32_t>);
     //! bit shift length to slot section
     constexpr static std::size_t kShiftLength  = sizeof(IDType) * 4;  // 4 means (* 8 / 2)
     //! bit mask to extract the slot portion
     constexpr static IDType kMask              = (static_cast<IDType>(1) << kShiftLength) - 1;
+    //! bit mask of the slot counter (without the active flag)
+    constexpr static IDType kSlotMask          = kMask >> 1;
+    //! flag indicating that the slot is active
+    constexpr static IDType kActiveFlag        = static_cast<IDType>(1) << (kShiftLength * 2 - 1);
+    //! index indicating the end of the free list
+    constexpr static std::uint32_t kNullIndex  = 0xFFFFFFFF;
+    //! free list head indicating the empty free list
+    constexpr static std::uint64_t kNullHead   = kNullIndex;
+    //! maximum number of pages (limited by 32bit slot index)
+    constexpr static std::size_t kMaxPageNum   = (static_cast<std::size_t>(1) << 32) / PageSize;
+    //! log2 of the number of page table entries in the first segment
+    constexpr static std::size_t kFirstSegmentShift = 3;
+    //! number of page table entries in the first segment
+    constexpr static std::size_t kFirstSegmentSize  = static_cast<std::size_t>(1) << kFirstSegmentShift;
+    //! number of page table segments (enough to cover kMaxPageNum)
+    constexpr static std::size_t kSegmentNum        = 32 - kFirstSegmentShift;
 
     //! specified allocator
     Allocator mAllocator;
-    //! table that holds pairs of pointers to pages and the current number of pages stored
-    std::vector<std::pair<std::byte*, std::uint32_t>> mPageTable;
-    //! vector to store the position on the released page
-    std::vector<IDType> mFreePosTable;
+    //! segmented page table (entries never move, so they can be read while other threads add pages)
+    std::array<std::atomic<PageEntry*>, kSegmentNum> mSegments{};
+    //! head of the lock-free free list ((tag << 32) | slot index)
+    std::atomic<std::uint64_t> mFreeHead;
+    //! head of the lock-free list of page indices released by shrink() ((tag << 32) | page index)
+    std::atomic<std::uint64_t> mReleasedPageHead;
+    //! number of page indices handed out so far
+    std::atomic<std::uint32_t> mPageNum;
+    //! number of pages currently allocated
+    std::atomic<std::size_t> mAllocatedPageNum;
+    //! number of live objects
+    std::atomic<std::size_t> mLiveNum;
+    //! maximum number of live objects observed so far
+    std::atomic<std::size_t> mHighWaterMark;
+    //! initial slot value of new pages (raised by shrink())
+    std::uint32_t mSlotBase;
+
+    //! per-type registry of the Pool used by CompactHandle
+    inline static std::atomic<Pool*> spRegistered = nullptr;
 };
 
-#endif
\ No newline at end of file
+#endif
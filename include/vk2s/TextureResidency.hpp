@@ -0,0 +1,222 @@
+/*****************************************************************/ /**
+ * @file   TextureResidency.hpp
+ * @brief  header file of TextureResidency class
+ *
+ * @author agent
+ * @date   October 2026
+ *********************************************************************/
+#ifndef VK2S_INCLUDE_TEXTURERESIDENCY_HPP_
+#define VK2S_INCLUDE_TEXTURERESIDENCY_HPP_
+
+#ifndef VULKAN_HPP_DISPATCH_LOADER_DYNAMIC
+#define VULKAN_HPP_DISPATCH_LOADER_DYNAMIC 1
+#include <vulkan/vulkan.hpp>
+#endif
+
+#include "Macro.hpp"
+#include "SlotMap.hpp"
+
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <span>
+#include <vector>
+
+namespace vk2s
+{
+    //! forward declaration
+    class Device;
+    class Image;
+
+    /**
+     * @brief  class that keeps the most recently used textures resident in device memory within a budget
+     * @detail every texture always has a small low-resolution version (fallback) resident, the full resolution Image is
+     *         streamed on demand when use() is called and evicted in least-recently-used order when the budget is exceeded
+     *         use() returns the fallback until the full version is streamed, so frames keep working under memory pressure
+     *         the full resolution Images get their mip chain generated by blits if the format supports linear blits
+     *         use(), isResident() and the setters only take an internal lock and can be called while worker threads record,
+     *         add() and update() write Images through Device::getUploader() and belong to the thread driving the Uploader,
+     *         they run the Loader and the upload without holding the lock, so use() doesn't wait for the disk
+     */
+    class TextureResidency
+    {
+    public:  // types
+        /**
+         * @brief  function returning the texels of the full resolution texture (called each time the texture is streamed)
+         */
+        using Loader = std::function<std::vector<std::byte>()>;
+
+        /**
+         * @brief  statistics of the residency
+         */
+        struct Statistics
+        {
+            //! number of textures added
+            size_t textureNum = 0;
+            //! number of textures whose full resolution version is resident
+            size_t residentNum = 0;
+            //! bytes of the resident full resolution textures (with their mip chains)
+            vk::DeviceSize residentBytes = 0;
+            //! bytes of the resident fallback textures
+            vk::DeviceSize fallbackBytes = 0;
+            //! budget of the full resolution textures at the last update()
+            vk::DeviceSize budgetBytes = 0;
+            //! number of evictions so far
+            size_t evictionNum = 0;
+            //! number of streams so far
+            size_t streamNum = 0;
+        };
+
+    public:  // methods
+        /**
+         * @brief  constructor
+         *
+         * @param budget bytes the full resolution textures may use (0 to follow the budget of the device local heap, see MemoryAllocator::getAvailableBudget())
+         * @param fallbackSize maximum width and height of the fallback textures
+         */
+        TextureResidency(Device& device, const vk::DeviceSize budget = 0, const uint32_t fallbackSize = kDefaultFallbackSize);
+
+        /**
+         * @brief  destructor
+         */
+        ~TextureResidency();
+
+        NONCOPYABLE(TextureResidency);
+        NONMOVABLE(TextureResidency);
+
+        /**
+         * @brief  add a 2D texture (the loader is called once here to create the fallback)
+         * @detail fallbacks are downsampled only for 8bit RGBA / BGRA formats (sRGB aware), other formats get a neutral 1x1 texture
+         *
+         * @param resident whether to stream the full resolution version right away
+         * @return ID of the texture
+         */
+        uint32_t add(const uint32_t width, const uint32_t height, const vk::Format format, Loader loader, const bool resident = true);
+
+        /**
+         * @brief  add a 2D texture from texels in host memory (copied and kept to stream again after eviction)
+         *
+         * @return ID of the texture
+         */
+        uint32_t add(std::span<const std::byte> texels, const uint32_t width, const uint32_t height, const vk::Format format, const bool resident = true);
+
+        /**
+         * @brief  mark the texture as used in this frame and get the Image to bind
+         *
+         * @return full resolution Image if resident, otherwise the fallback (the full version is streamed by the next update())
+         */
+        Handle<Image> use(const uint32_t id);
+
+        /**
+         * @brief  whether the full resolution version of the texture is resident
+         */
+        bool isResident(const uint32_t id) const;
+
+        /**
+         * @brief  advance the frame, stream the requested textures and evict the least recently used ones over the budget
+         * @detail call once per frame, evicted Images are destroyed after the GPU retires the submissions issued so far
+         *
+         * @return whether the Image returned by use() changed for any texture (BindGroups must be bound again)
+         */
+        bool update();
+
+        /**
+         * @brief  set the bytes the full resolution textures may use (0 to follow the budget of the device local heap)
+         */
+        void setBudget(const vk::DeviceSize budget);
+
+        /**
+         * @brief  set the maximum bytes streamed in an update()
+         */
+        void setStreamBytesPerFrame(const vk::DeviceSize bytes);
+
+        /**
+         * @brief  get the statistics of the residency
+         */
+        Statistics getStatistics() const;
+
+        //! default maximum width and height of the fallback textures
+        constexpr static uint32_t kDefaultFallbackSize = 32;
+        //! default maximum bytes streamed in an update()
+        constexpr static vk::DeviceSize kDefaultStreamBytesPerFrame = 64 * 1024 * 1024;
+        //! textures used within this number of frames are not evicted (they may still be referenced by frames in flight)
+        constexpr static uint64_t kMinIdleFrames = 3;
+
+    private:  // types
+        /**
+         * @brief  texture managed by the residency
+         */
+        struct Entry
+        {
+            uint32_t width;
+            uint32_t height;
+            vk::Format format;
+            Loader loader;
+            //! byte size of the full resolution texels
+            vk::DeviceSize size;
+            //! mip levels of the full resolution Image
+            uint32_t mipLevels;
+            //! byte size of the full resolution Image with its mip chain (counted against the budget)
+            vk::DeviceSize residentSize;
+            //! full resolution Image (invalid if not resident)
+            Handle<Image> image;
+            //! low resolution Image (always resident, invalid if mNeutralFallback is used)
+            Handle<Image> fallback;
+            //! frame the texture was used last
+            uint64_t lastUsedFrame;
+            //! whether use() requested streaming
+            bool requested;
+            //! position in mLRU (valid if resident)
+            std::list<uint32_t>::iterator lruIter;
+        };
+
+    private:  // methods
+        /**
+         * @brief  create a device local sampled Image and write the texels to its first level (the other levels are generated)
+         */
+        Handle<Image> createImage(const uint32_t width, const uint32_t height, const vk::Format format, const void* pTexels, const size_t size, const uint32_t mipLevels = 1);
+
+        /**
+         * @brief  create the full resolution Image of the entry from its loader (mMutex must not be locked)
+         * @detail the loader and the upload run without the lock, which is taken only to publish the Image,
+         *         the budget is checked by the caller (add() and update() aren't called concurrently)
+         */
+        void stream(const uint32_t id);
+
+        /**
+         * @brief  destroy the full resolution Image of the entry (after the GPU retires it)
+         */
+        void evict(const uint32_t id);
+
+        /**
+         * @brief  get the budget of the full resolution textures
+         */
+        vk::DeviceSize computeBudget() const;
+
+    private:  // member variables
+        //! reference to device
+        Device& mDevice;
+        //! maximum width and height of the fallback textures
+        uint32_t mFallbackSize;
+        //! bytes the full resolution textures may use (0 to follow the heap budget)
+        vk::DeviceSize mBudget;
+        //! maximum bytes streamed in an update()
+        vk::DeviceSize mStreamBytesPerFrame;
+
+        //! guards every member below
+        mutable std::mutex mMutex;
+        //! textures (indices are IDs)
+        std::vector<Entry> mEntries;
+        //! IDs of the resident textures, most recently used first
+        std::list<uint32_t> mLRU;
+        //! neutral 1x1 fallback for formats that can't be downsampled
+        Handle<Image> mNeutralFallback;
+        //! current frame
+        uint64_t mFrame;
+        //! statistics
+        Statistics mStats;
+    };
+}  // namespace vk2s
+
+#endif
@@ -0,0 +1,179 @@
+/*****************************************************************/ /**
+ * @file   TransientAllocator.hpp
+ * @brief  header file of TransientAllocator class
+ *
+ * @author agent
+ * @date   October 2026
+ *********************************************************************/
+#ifndef VK2S_INCLUDE_TRANSIENTALLOCATOR_HPP_
+#define VK2S_INCLUDE_TRANSIENTALLOCATOR_HPP_
+
+#ifndef VULKAN_HPP_DISPATCH_LOADER_DYNAMIC
+#define VULKAN_HPP_DISPATCH_LOADER_DYNAMIC 1
+#include <vulkan/vulkan.hpp>
+#endif
+
+#include "Macro.hpp"
+#include "SlotMap.hpp"
+
+#include <cstddef>
+#include <cstring>
+#include <deque>
+#include <mutex>
+
+namespace vk2s
+{
+    //! forward declaration
+    class Device;
+    class DynamicBuffer;
+
+    /**
+     * @brief  class that hands out per-frame uniform / storage data from a persistently mapped ring on a DynamicBuffer
+     * @detail bind getBuffer() once as eUniformBufferDynamic / eStorageBufferDynamic and pass Allocation::getDynamicOffset() to Command::setBindGroup()
+     *         the data allocated in a frame is recycled after the GPU retires every submission issued before the next beginFrame()
+     *         allocate() takes a short internal lock, so worker threads recording the same frame can share an allocator,
+     *         beginFrame() is called once per frame by the thread driving the frames
+     */
+    class TransientAllocator
+    {
+    public:  // types
+        /**
+         * @brief  sub-allocation valid until the GPU retires the frame
+         */
+        struct Allocation
+        {
+            //! buffer the data belongs to (same as getBuffer())
+            Handle<DynamicBuffer> buffer;
+            //! offset of the data in the buffer
+            vk::DeviceSize offset = 0;
+            //! persistently mapped pointer to the data (write directly)
+            void* pData = nullptr;
+
+            /**
+             * @brief  get the offset to pass to Command::setBindGroup() as a dynamic offset
+             */
+            uint32_t getDynamicOffset() const
+            {
+                return static_cast<uint32_t>(offset);
+            }
+        };
+
+        /**
+         * @brief  statistics of the allocator
+         */
+        struct Statistics
+        {
+            //! number of allocations so far
+            size_t allocationNum = 0;
+            //! bytes allocated in the current frame
+            vk::DeviceSize frameBytes = 0;
+            //! maximum bytes allocated in a frame so far
+            vk::DeviceSize peakFrameBytes = 0;
+            //! number of times allocate() waited for the GPU to free ring space
+            size_t stallNum = 0;
+        };
+
+    public:  // methods
+        /**
+         * @brief  constructor
+         *
+         * @param usage usage of the ring buffer (eUniformBuffer and / or eStorageBuffer)
+         * @param ringSize byte size of the ring (must hold every allocation of a frame)
+         * @param bindingRange byte size visible to the shader from each dynamic offset (the maximum size of an allocation, rounded up to the offset alignment)
+         */
+        TransientAllocator(Device& device, const vk::BufferUsageFlags usage = vk::BufferUsageFlagBits::eUniformBuffer, const vk::DeviceSize ringSize = kDefaultRingSize,
+                           const vk::DeviceSize bindingRange = kDefaultBindingRange);
+
+        /**
+         * @brief  destructor
+         */
+        ~TransientAllocator();
+
+        NONCOPYABLE(TransientAllocator);
+        NONMOVABLE(TransientAllocator);
+
+        /**
+         * @brief  start a new frame (call once per frame before allocating)
+         * @detail the allocations of the previous frame are recycled once the GPU retires the submissions issued so far
+         */
+        void beginFrame();
+
+        /**
+         * @brief  allocate size bytes aligned for dynamic offsets (a pointer bump unless the ring is full)
+         */
+        Allocation allocate(const vk::DeviceSize size);
+
+        /**
+         * @brief  allocate and write the data
+         */
+        template <typename T>
+        Allocation push(const T& data)
+        {
+            const Allocation allocation = allocate(sizeof(T));
+            std::memcpy(allocation.pData, &data, sizeof(T));
+            return allocation;
+        }
+
+        /**
+         * @brief  get the ring buffer (bind to BindGroup as a dynamic uniform / storage buffer)
+         */
+        Handle<DynamicBuffer> getBuffer() const;
+
+        /**
+         * @brief  get the statistics of the allocator
+         */
+        Statistics getStatistics() const;
+
+        //! default byte size of the ring
+        constexpr static vk::DeviceSize kDefaultRingSize = 4 * 1024 * 1024;
+        //! default byte size visible from each dynamic offset (guaranteed maxUniformBufferRange)
+        constexpr static vk::DeviceSize kDefaultBindingRange = 16384;
+
+    private:  // types
+        /**
+         * @brief  range of the ring used by a finished frame
+         */
+        struct FrameRange
+        {
+            //! submission index the GPU must retire before the range is recycled
+            uint64_t submissionIndex;
+            //! end of the range (position in the ring, see mHead)
+            uint64_t end;
+        };
+
+    private:  // methods
+        /**
+         * @brief  free the ranges of the frames retired by the GPU
+         */
+        void reclaim();
+
+    private:  // member variables
+        //! reference to device
+        Device& mDevice;
+        //! ring buffer (the last block is kept free so that every offset in the ring can see bindingRange bytes)
+        Handle<DynamicBuffer> mBuffer;
+        //! persistently mapped pointer to the ring
+        std::byte* mpMapped;
+        //! byte size of the ring
+        vk::DeviceSize mRingSize;
+        //! byte size visible from each dynamic offset
+        vk::DeviceSize mBindingRange;
+        //! alignment of dynamic offsets
+        vk::DeviceSize mAlignment;
+
+        //! guards every member below
+        mutable std::mutex mMutex;
+        //! position to allocate the next data at (increases monotonically, the offset in the ring is mHead % mRingSize)
+        uint64_t mHead;
+        //! beginning of the ranges not recycled yet
+        uint64_t mTail;
+        //! beginning of the current frame
+        uint64_t mFrameBegin;
+        //! ranges of the finished frames the GPU may not have retired yet (oldest first)
+        std::deque<FrameRange> mFrameRanges;
+        //! statistics
+        Statistics mStats;
+    };
+}  // namespace vk2s
+
+#endif
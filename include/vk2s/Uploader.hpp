@@ -0,0 +1,260 @@
+/*****************************************************************/ /**
+ * @file   Uploader.hpp
+ * @brief  header file of Uploader class
+ *
+ * @author agent
+ * @date   October 2026
+ *********************************************************************/
+#ifndef VK2S_INCLUDE_UPLOADER_HPP_
+#define VK2S_INCLUDE_UPLOADER_HPP_
+
+#ifndef VULKAN_HPP_DISPATCH_LOADER_DYNAMIC
+#define VULKAN_HPP_DISPATCH_LOADER_DYNAMIC 1
+#include <vulkan/vulkan.hpp>
+#endif
+
+#include "Macro.hpp"
+#include "SlotMap.hpp"
+
+#include <deque>
+#include <mutex>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace vk2s
+{
+    //! forward declaration
+    class Device;
+    class Buffer;
+    class Image;
+    class Command;
+    class Fence;
+
+    /**
+     * @brief  class that uploads host data to (device local) Buffers and Images through a persistently mapped staging ring buffer
+     * @detail enqueue() copies the data into the ring right away, submit() records every queued copy into a single command on the
+     *         graphics queue, ring space is recycled when the submission timeline of Device passes the submission
+     *         the copies wait for every earlier submission on the graphics queue and are visible to every later one, submissions on
+     *         other queues must wait for the returned submission index (see Device::getVkSubmissionTimeline())
+     *         the calls are serialized by a mutex, but submit(), uploadBatch() and enqueue() on a full ring record to the shared graphics
+     *         command pool of Device, so use the Uploader on the thread recording the other Commands from that pool
+     */
+    class Uploader
+    {
+    public:  // types
+        /**
+         * @brief  statistics of the uploader
+         */
+        struct Statistics
+        {
+            //! number of submissions
+            size_t submitNum = 0;
+            //! number of uploads to Buffers
+            size_t bufferUploadNum = 0;
+            //! number of uploads to Images
+            size_t imageUploadNum = 0;
+            //! bytes uploaded so far
+            vk::DeviceSize uploadedBytes = 0;
+            //! number of times enqueue() waited for the GPU to free ring space
+            size_t stallNum = 0;
+            //! number of uploads larger than the ring (staged through their own Buffers)
+            size_t oversizedNum = 0;
+        };
+
+        /**
+         * @brief  upload to a subresource of an Image, see uploadBatch()
+         */
+        struct ImageUpload
+        {
+            //! destination (needs vk::ImageUsageFlagBits::eTransferDst)
+            Handle<Image> image;
+            //! tightly packed texels of the subresource
+            const void* pData = nullptr;
+            //! byte size of pData
+            vk::DeviceSize size = 0;
+            //! mip level to write
+            uint32_t mipLevel = 0;
+            //! array layer to write
+            uint32_t arrayLayer = 0;
+            //! generate the other mip levels from the written one (only if mipLevel is 0, needs vk::ImageUsageFlagBits::eTransferSrc)
+            bool generateMipmaps = true;
+            //! layout of the subresources after the upload
+            vk::ImageLayout finalLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
+        };
+
+    public:  // methods
+        /**
+         * @brief  constructor (the ring is allocated on the first enqueue())
+         *
+         * @param ringSize byte size of the staging ring buffer
+         */
+        Uploader(Device& device, const vk::DeviceSize ringSize = kDefaultRingSize);
+
+        /**
+         * @brief  destructor
+         */
+        ~Uploader();
+
+        NONCOPYABLE(Uploader);
+        NONMOVABLE(Uploader);
+
+        /**
+         * @brief  queue an upload to the Buffer (needs vk::BufferUsageFlagBits::eTransferDst)
+         * @detail the data is copied here, so pSrc can be released right after the call
+         *
+         * @param dstOffset offset in the Buffer to write to
+         */
+        void enqueue(Buffer& dst, const void* pSrc, const vk::DeviceSize size, const vk::DeviceSize dstOffset = 0);
+
+        /**
+         * @brief  queue an upload of the whole first mip level and layer of the Image (needs vk::ImageUsageFlagBits::eTransferDst)
+         * @detail the previous contents are discarded, the Image is left in finalLayout after the submission
+         *         the other mip levels are generated by blits in the same submission (needs vk::ImageUsageFlagBits::eTransferSrc),
+         *         sRGB formats are filtered in linear space, throws std::runtime_error if the size is smaller than the level or the
+         *         format doesn't support blits
+         *
+         * @param finalLayout layout of the Image after the upload
+         */
+        void enqueue(Image& dst, const void* pSrc, const vk::DeviceSize size, const vk::ImageLayout finalLayout = vk::ImageLayout::eShaderReadOnlyOptimal);
+
+        /**
+         * @brief  upload every Image subresource in a single submission (together with the uploads queued by enqueue())
+         * @detail the texels are packed into one staging range of the ring (or one Buffer if larger than the ring),
+         *         so loading N textures costs a single copy command and submission instead of N round trips
+         *
+         *         every upload is validated before any staging space is taken (throws std::runtime_error if an upload is out of its
+         *         Image, smaller than its subresource or generates mip levels of a format without blit support), a rejected batch
+         *         leaves the ring untouched
+         *
+         * @param signalFence fence signaled when the batch is completed (must be unsignaled, optional)
+         * @return index of the submission (wait with Device::waitSubmission())
+         */
+        uint64_t uploadBatch(std::span<const ImageUpload> uploads, const Handle<Fence>& signalFence = Handle<Fence>());
+
+        /**
+         * @brief  submit every queued upload in a single command
+         *
+         * @return index of the submission (wait with Device::waitSubmission()), 0 if nothing was queued
+         */
+        uint64_t submit();
+
+        /**
+         * @brief  whether the GPU has retired the submission returned by submit()
+         */
+        bool isCompleted(const uint64_t submissionIndex) const;
+
+        /**
+         * @brief  get the statistics of the uploader
+         */
+        Statistics getStatistics() const;
+
+        //! default byte size of the staging ring buffer
+        constexpr static vk::DeviceSize kDefaultRingSize = 64 * 1024 * 1024;
+
+    private:  // types
+        /**
+         * @brief  queued copy to a Buffer
+         */
+        struct BufferCopy
+        {
+            vk::Buffer src;
+            vk::Buffer dst;
+            vk::BufferCopy region;
+        };
+
+        /**
+         * @brief  queued copy to an Image
+         */
+        struct ImageCopy
+        {
+            vk::Buffer src;
+            vk::Image dst;
+            vk::BufferImageCopy region;
+            vk::ImageLayout finalLayout;
+            //! number of mip levels from the written one (generated from it if more than 1)
+            uint32_t mipLevels;
+            //! filter of the blits generating the mip levels
+            vk::Filter filter;
+        };
+
+        /**
+         * @brief  range of the ring used by a submission
+         */
+        struct InFlightRange
+        {
+            //! submission that reads the range
+            uint64_t submissionIndex;
+            //! end of the range (position in the ring, see mHead)
+            uint64_t end;
+        };
+
+    private:  // methods
+        /**
+         * @brief  check an upload to a subresource of the Image before staging it
+         * @detail the size must cover the tightly packed texels of the subresource (unchecked for formats without a known texel size),
+         *         throws std::runtime_error if the upload is rejected
+         */
+        void validateImageUpload(Image& dst, const vk::DeviceSize size, const uint32_t mipLevel, const uint32_t arrayLayer, const bool generateMipmaps) const;
+
+        /**
+         * @brief  copy the data into the ring (or its own Buffer if larger than the ring)
+         *
+         * @return staging Buffer and offset in it
+         */
+        std::pair<vk::Buffer, vk::DeviceSize> stage(const void* pSrc, const vk::DeviceSize size, const vk::DeviceSize alignment);
+
+        /**
+         * @brief  allocate a range of the ring (or its own Buffer if larger than the ring) without writing to it
+         *
+         * @return staging Buffer and offset in it
+         */
+        std::pair<Buffer*, vk::DeviceSize> allocateStaging(const vk::DeviceSize size, const vk::DeviceSize alignment);
+
+        /**
+         * @brief  queue the copy of the staged texels to a subresource of the Image and the generation of its mip levels
+         */
+        void queueImageCopy(Image& dst, const vk::Buffer src, const vk::DeviceSize srcOffset, const uint32_t mipLevel, const uint32_t arrayLayer, const bool generateMipmaps, const vk::ImageLayout finalLayout);
+
+        /**
+         * @brief  free the ring ranges of the retired submissions
+         */
+        void reclaim();
+
+        /**
+         * @brief  internal implementation of submit() (mMutex must be locked)
+         */
+        uint64_t submitInternal(const Handle<Fence>& signalFence = Handle<Fence>());
+
+    private:  // member variables
+        //! reference to device
+        Device& mDevice;
+        //! byte size of the ring
+        vk::DeviceSize mRingSize;
+
+        //! guards every member below
+        mutable std::mutex mMutex;
+        //! staging ring buffer (host visible and coherent, invalid until the first enqueue())
+        Handle<Buffer> mRing;
+        //! position to stage the next data at (increases monotonically, the offset in the ring is mHead % mRingSize)
+        uint64_t mHead;
+        //! beginning of the ranges not freed yet
+        uint64_t mTail;
+        //! end of the ranges already submitted
+        uint64_t mSubmittedHead;
+        //! ranges read by submissions the GPU may not have retired yet (oldest first)
+        std::deque<InFlightRange> mInFlightRanges;
+        //! queued copies to Buffers
+        std::vector<BufferCopy> mBufferCopies;
+        //! queued copies to Images
+        std::vector<ImageCopy> mImageCopies;
+        //! staging Buffers of the queued uploads larger than the ring (destroyed after the submission)
+        std::vector<Handle<Buffer>> mOversizedBuffers;
+        //! commands recorded by submit() (reused once retired)
+        std::vector<Handle<Command>> mCommands;
+        //! statistics
+        Statistics mStats;
+    };
+}  // namespace vk2s
+
+#endif
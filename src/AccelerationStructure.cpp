@@ -18,6 +18,13 @@ namespace vk2s
         build(vertexNum, vertexStride, vertexBuffer, faceNum, indexBuffer, motion, buildCommand);
     }
 
+    // BLAS (device addresses)
+    AccelerationStructure::AccelerationStructure(Device& device, const uint32_t vertexNum, const uint32_t vertexStride, const vk::DeviceAddress vertexAddress, const uint32_t faceNum, const vk::DeviceAddress indexAddress, const bool motion, const Handle<Command>& buildCommand)
+        : mDevice(device)
+    {
+        build(vertexNum, vertexStride, vertexAddress, faceNum, indexAddress, motion, buildCommand);
+    }
+
     // TLAS
     AccelerationStructure::AccelerationStructure(Device& device, const vk::ArrayProxy<vk::AccelerationStructureInstanceKHR>& instances, const Handle<Command>& buildCommand)
         : mDevice(device)
@@ -48,7 +55,11 @@ namespace vk2s
 
     void AccelerationStructure::build(const uint32_t vertexNum, const uint32_t vertexStride, Buffer& vertexBuffer, const uint32_t faceNum, Buffer& indexBuffer, const bool motion, const Handle<Command>& buildCommand)
     {
-        const auto& vkDevice = mDevice.getVkDevice();
+        build(vertexNum, vertexStride, vertexBuffer.getVkDeviceAddress(), faceNum, indexBuffer.getVkDeviceAddress(), motion, buildCommand);
+    }
+
+    void AccelerationStructure::build(const uint32_t vertexNum, const uint32_t vertexStride, const vk::DeviceAddress vertexAddress, const uint32_t faceNum, const vk::DeviceAddress indexAddress, const bool motion, const Handle<Command>& buildCommand)
+    {
 
         vk::AccelerationStructureGeometryKHR geometryInfo;
         geometryInfo.flags        = vk::GeometryFlagBitsKHR::eOpaque;
@@ -61,16 +72,13 @@ namespace vk2s
         //}
 
         {
-            vk::BufferDeviceAddressInfo VBdeviceAddressInfo(vertexBuffer.getVkBuffer().get());
-            vk::BufferDeviceAddressInfo IBdeviceAddressInfo(indexBuffer.getVkBuffer().get());
-
             auto& triangles                    = geometryInfo.geometry.triangles;
             triangles.vertexFormat             = vk::Format::eR32G32B32Sfloat;
-            triangles.vertexData.deviceAddress = vkDevice->getBufferAddress(VBdeviceAddressInfo);
+            triangles.vertexData.deviceAddress = vertexAddress;
             triangles.maxVertex                = vertexNum;
             triangles.vertexStride             = vertexStride;
             triangles.indexType                = vk::IndexType::eUint32;
-            triangles.indexData.deviceAddress  = vkDevice->getBufferAddress(IBdeviceAddressInfo);
+            triangles.indexData.deviceAddress  = indexAddress;
         }
 
         vk::AccelerationStructureBuildRangeInfoKHR asBuildRangeInfo(faceNum);
@@ -230,7 +238,7 @@ namespace vk2s
                 command->begin(true);
             }
 
-            command->getVkCommandBuffer()->buildAccelerationStructuresKHR(asBuildGeometryInfo, buildRangeInfoPtrs);
+            command->getVkCommandBuffer()->buildAccelerationStructuresKHR(asBuildGeometryInfo, buildRangeInfoPtrs, mDevice.getVkDispatcher());
 
             // need memory barrier
             vk::MemoryBarrier barrier;
@@ -248,7 +256,7 @@ namespace vk2s
             }
 
             // HACK: BAD
-            vkDevice->waitIdle();
+            mDevice.waitIdle();
         }
     }
 
@@ -4,16 +4,25 @@
 
 namespace vk2s
 {
-    BindGroup::BindGroup(Device& device, BindLayout& layout)
+    BindGroup::BindGroup(Device& device, BindLayout& layout, const bool transient)
         : mDevice(device)
+        , mPoolIndex(0)
+        , mTransient(transient)
         , mAllocationInfo(layout.getDescriptorPoolAllocationInfo())
     {
         // get mAllocationInfo from BindLayout
 
-        const auto&& [descriptorSet, poolIndex] = mDevice.allocateVkDescriptorSet(layout.getVkDescriptorSetLayout().get(), mAllocationInfo);
+        if (mTransient)
+        {
+            mDescriptorSet = mDevice.allocateTransientVkDescriptorSet(layout.getVkDescriptorSetLayout().get(), mAllocationInfo);
+        }
+        else
+        {
+            const auto&& [descriptorSet, poolIndex] = mDevice.allocateVkDescriptorSet(layout.getVkDescriptorSetLayout().get(), mAllocationInfo);
 
-        mDescriptorSet = descriptorSet;
-        mPoolIndex     = poolIndex;
+            mDescriptorSet = descriptorSet;
+            mPoolIndex     = poolIndex;
+        }
 
         // HACK:
         mInfoCaches.reserve(mAllocationInfo.sum());
@@ -21,7 +30,11 @@ namespace vk2s
 
     BindGroup::~BindGroup()
     {
-        mDevice.deallocateVkDescriptorSet(mDescriptorSet, mPoolIndex, mAllocationInfo);
+        // transient sets are released with their pool
+        if (!mTransient)
+        {
+            mDevice.deallocateVkDescriptorSet(mDescriptorSet, mPoolIndex, mAllocationInfo);
+        }
     }
 
     void BindGroup::bind(const uint8_t binding, const vk::DescriptorType type, Buffer& buffer)
@@ -25,33 +25,34 @@ namespace vk2s
 
     inline void BindLayout::initAllocationInfo(const vk::ArrayProxy<const vk::DescriptorSetLayoutBinding>& bindings)
     {
+        // count descriptors (not bindings), descriptor pools are sized exactly from this
         for (const auto& b : bindings)
         {
             switch (b.descriptorType)
             {
             case vk::DescriptorType::eAccelerationStructureKHR:
-                mInfo.accelerationStructureNum += 1;
+                mInfo.accelerationStructureNum += b.descriptorCount;
                 break;
             case vk::DescriptorType::eCombinedImageSampler:
-                mInfo.combinedImageSamplerNum += 1;
+                mInfo.combinedImageSamplerNum += b.descriptorCount;
                 break;
             case vk::DescriptorType::eSampledImage:
-                mInfo.sampledImageNum += 1;
+                mInfo.sampledImageNum += b.descriptorCount;
                 break;
             case vk::DescriptorType::eSampler:
-                mInfo.samplerNum += 1;
+                mInfo.samplerNum += b.descriptorCount;
                 break;
             case vk::DescriptorType::eStorageBuffer:
-                mInfo.storageBufferNum += 1;
+                mInfo.storageBufferNum += b.descriptorCount;
                 break;
             case vk::DescriptorType::eStorageImage:
-                mInfo.storageImageNum += 1;
+                mInfo.storageImageNum += b.descriptorCount;
                 break;
             case vk::DescriptorType::eUniformBuffer:
-                mInfo.uniformBufferNum += 1;
+                mInfo.uniformBufferNum += b.descriptorCount;
                 break;
             case vk::DescriptorType::eUniformBufferDynamic:
-                mInfo.uniformBufferDynamicNum += 1;
+                mInfo.uniformBufferDynamicNum += b.descriptorCount;
                 break;
             default:
                 assert(!"invalid (or unsupported) descriptor type!");
@@ -11,21 +11,10 @@ namespace vk2s
 
         mBuffer = vkDevice->createBufferUnique(bi);
 
-        // for ray tracing
-        vk::MemoryAllocateFlagsInfo allocateFlagsInfo(vk::MemoryAllocateFlagBits::eDeviceAddress);
-
-        vk::MemoryRequirements reqs = vkDevice->getBufferMemoryRequirements(mBuffer.get());
-        vk::MemoryAllocateInfo ai(reqs.size, mDevice.getVkMemoryTypeIndex(reqs.memoryTypeBits, pbs));
-        if (bi.usage & vk::BufferUsageFlagBits::eShaderDeviceAddress)
-        {
-            ai.pNext = &allocateFlagsInfo;
-        }
-
-        mMemory = vkDevice->allocateMemoryUnique(ai);
+        // sub-allocated from a shared block and bound
+        mMemory = mDevice.getMemoryAllocator().allocateForBuffer(mBuffer.get(), bi.usage, pbs);
         mSize   = bi.size;
         mOffset = 0;
-
-        vkDevice->bindBufferMemory(mBuffer.get(), mMemory.get(), mOffset);
     }
 
     Buffer::~Buffer()
@@ -34,12 +23,10 @@ namespace vk2s
 
     void Buffer::write(const void* pSrc, const size_t size, const size_t offset)
     {
-        const auto& vkDevice = mDevice.getVkDevice();
-
-        void* p = vkDevice->mapMemory(mMemory.get(), offset, size);
+        std::byte* p = mMemory.getMappedPointer();
         assert(p || !"failed to map memory!");
-        memcpy(p, pSrc, size);
-        vkDevice->unmapMemory(mMemory.get());
+        memcpy(p + offset, pSrc, size);
+        mMemory.flush(offset, size);
     }
 
     void Buffer::read(const std::function<void(const void*)>& readFunc, const size_t size, const size_t offset)
@@ -50,12 +37,30 @@ namespace vk2s
             return;
         }
 
-        const auto& vkDevice = mDevice.getVkDevice();
-
-        void* p = vkDevice->mapMemory(mMemory.get(), offset, size);
+        const std::byte* p = mMemory.getMappedPointer();
         assert(p || !"failed to map memory!");
-        readFunc(p);
-        vkDevice->unmapMemory(mMemory.get());
+        mMemory.invalidate(offset, size);
+        readFunc(p + offset);
+    }
+
+    void* Buffer::getMappedPointer() const
+    {
+        return mMemory.getMappedPointer();
+    }
+
+    bool Buffer::isHostCoherent() const
+    {
+        return mMemory.isHostCoherent();
+    }
+
+    void Buffer::flush(const vk::DeviceSize offset, const vk::DeviceSize size)
+    {
+        mMemory.flush(offset, size);
+    }
+
+    void Buffer::invalidate(const vk::DeviceSize offset, const vk::DeviceSize size)
+    {
+        mMemory.invalidate(offset, size);
     }
 
     const vk::UniqueBuffer& Buffer::getVkBuffer()
@@ -63,7 +68,12 @@ namespace vk2s
         return mBuffer;
     }
 
-    const vk::UniqueDeviceMemory& Buffer::getVkDeviceMemory()
+    vk::DeviceMemory Buffer::getVkDeviceMemory() const
+    {
+        return mMemory.getVkDeviceMemory();
+    }
+
+    const MemoryAllocation& Buffer::getMemoryAllocation() const
     {
         return mMemory;
     }
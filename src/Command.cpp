@@ -13,25 +13,55 @@
 #include <imgui_impl_glfw.h>
 #include <imgui_impl_vulkan.h>
 
+#include <algorithm>
+#include <cassert>
+#include <stdexcept>
+
 namespace vk2s
 {
-    Command::Command(Device& device)
+    Command::Command(Device& device, const QueueType queueType)
         : mDevice(device)
+        , mDispatcher(device.getVkDispatcher())
+        , mQueueType(queueType)
+        , mLastSubmissionIndex(0)
     {
-        vk::CommandBufferAllocateInfo allocInfo(mDevice.getVkCommandPool().get(), vk::CommandBufferLevel::ePrimary, 1);
+        vk::CommandBufferAllocateInfo allocInfo(mDevice.getVkCommandPool(mQueueType).get(), vk::CommandBufferLevel::ePrimary, 1);
 
         mCommandBuffer = std::move(mDevice.getVkDevice()->allocateCommandBuffersUnique(allocInfo).front());
     }
 
+    Command::Command(Device& device, const QueueType queueType, const uint32_t frameIndex, const uint32_t workerIndex)
+        : mDevice(device)
+        , mDispatcher(device.getVkDispatcher())
+        , mQueueType(queueType)
+        , mLastSubmissionIndex(0)
+    {
+        const auto [commandBuffer, poolIndex] = mDevice.allocateWorkerVkCommandBuffer(mQueueType, frameIndex, workerIndex);
+
+        // the deleter is never used, the buffer is returned to the worker pool on destruction
+        mCommandBuffer   = vk::UniqueCommandBuffer(commandBuffer);
+        mWorkerPoolIndex = poolIndex;
+    }
+
     Command::~Command()
     {
-        mDevice.getVkDevice()->waitIdle();
-        mCommandBuffer->reset();
+        // only wait for the last submission of this command (no wait if it's already retired)
+        mDevice.waitSubmission(mLastSubmissionIndex);
+
+        if (mWorkerPoolIndex)
+        {
+            // reset together with the pool of the worker
+            mDevice.deallocateWorkerVkCommandBuffer(mCommandBuffer.release(), *mWorkerPoolIndex);
+            return;
+        }
+
+        mCommandBuffer->reset({}, mDispatcher);
     }
 
     void Command::reset()
     {
-        mCommandBuffer->reset();
+        mCommandBuffer->reset({}, mDispatcher);
+        mProfileScopes.clear();
     }
 
     void Command::begin(const bool singleTimeUse, const bool secondaryUse, const bool simultaneousUse)
@@ -50,28 +80,29 @@ namespace vk2s
             usage |= vk::CommandBufferUsageFlagBits::eSimultaneousUse;
         }
 
-        mCommandBuffer->begin(vk::CommandBufferBeginInfo(usage));
+        mCommandBuffer->begin(vk::CommandBufferBeginInfo(usage), mDispatcher);
     }
 
     void Command::end()
     {
-        mCommandBuffer->end();
+        assert(mProfileScopes.empty() || !"every profile scope must be ended before the command!");
+        mCommandBuffer->end(mDispatcher);
     }
 
     void Command::beginRenderPass(RenderPass& renderpass, const uint32_t frameBufferIndex, const vk::Rect2D& area, const vk::ArrayProxyNoTemporaries<const vk::ClearValue>& clearValues)
     {
         vk::RenderPassBeginInfo bi(renderpass.getVkRenderPass().get(), renderpass.getVkFrameBuffers()[frameBufferIndex].get(), area, clearValues);
-        mCommandBuffer->beginRenderPass(bi, vk::SubpassContents::eInline);
+        mCommandBuffer->beginRenderPass(bi, vk::SubpassContents::eInline, mDispatcher);
     }
 
     void Command::endRenderPass()
     {
-        mCommandBuffer->endRenderPass();
+        mCommandBuffer->endRenderPass(mDispatcher);
     }
 
     void Command::setPipeline(Handle<Pipeline> pipeline)
     {
-        mCommandBuffer->bindPipeline(pipeline->getVkPipelineBindPoint(), pipeline->getVkPipeline().get());
+        mCommandBuffer->bindPipeline(pipeline->getVkPipelineBindPoint(), pipeline->getVkPipeline().get(), mDispatcher);
         mNowPipeline = pipeline;
     }
 
@@ -83,7 +114,7 @@ namespace vk2s
             return;
         }
 
-        mCommandBuffer->bindDescriptorSets(mNowPipeline->getVkPipelineBindPoint(), mNowPipeline->getVkPipelineLayout().get(), set, bindGroup.getVkDescriptorSet(), dynamicOffsets);
+        mCommandBuffer->bindDescriptorSets(mNowPipeline->getVkPipelineBindPoint(), mNowPipeline->getVkPipelineLayout().get(), set, bindGroup.getVkDescriptorSet(), dynamicOffsets, mDispatcher);
     }
 
     void Command::setViewport(const uint32_t firstViewport, const vk::ArrayProxy<vk::Viewport> viewports)
@@ -94,7 +125,7 @@ namespace vk2s
             return;
         }
 
-        mCommandBuffer->setViewport(firstViewport, viewports);
+        mCommandBuffer->setViewport(firstViewport, viewports, mDispatcher);
     }
 
     void Command::setScissor(const uint32_t firstScissor, const vk::ArrayProxy<vk::Rect2D> scissors)
@@ -105,7 +136,7 @@ namespace vk2s
             return;
         }
 
-        mCommandBuffer->setScissor(firstScissor, scissors);
+        mCommandBuffer->setScissor(firstScissor, scissors, mDispatcher);
     }
 
     void Command::setPushConstant(const vk::ShaderStageFlags shaderStage, const size_t offset, const size_t size, const void* const pData)
@@ -116,138 +147,262 @@ namespace vk2s
             return;
         }
 
-        mCommandBuffer->pushConstants(mNowPipeline->getVkPipelineLayout().get(), shaderStage, offset, size, pData);
+        mCommandBuffer->pushConstants(mNowPipeline->getVkPipelineLayout().get(), shaderStage, offset, size, pData, mDispatcher);
     }
 
-    void Command::bindVertexBuffer(Buffer& vertexBuffer)
+    void Command::bindVertexBuffer(Buffer& vertexBuffer, const vk::DeviceSize offset)
     {
-        mCommandBuffer->bindVertexBuffers(0, vertexBuffer.getVkBuffer().get(), { 0 });
+        mCommandBuffer->bindVertexBuffers(0, vertexBuffer.getVkBuffer().get(), offset, mDispatcher);
     }
 
-    void Command::bindIndexBuffer(Buffer& indexBuffer)
+    void Command::bindIndexBuffer(Buffer& indexBuffer, const vk::DeviceSize offset)
     {
-        mCommandBuffer->bindIndexBuffer(indexBuffer.getVkBuffer().get(), 0, vk::IndexType::eUint32);
+        mCommandBuffer->bindIndexBuffer(indexBuffer.getVkBuffer().get(), offset, vk::IndexType::eUint32, mDispatcher);
     }
 
     void Command::draw(const uint32_t vertexCount, const uint32_t instanceCount, const uint32_t firstVertex, const uint32_t firstInstance)
     {
-        mCommandBuffer->draw(vertexCount, instanceCount, firstVertex, firstInstance);
+        mCommandBuffer->draw(vertexCount, instanceCount, firstVertex, firstInstance, mDispatcher);
     }
 
     void Command::drawIndirect(Buffer& infoBuffer, const vk::DeviceSize offset, const uint32_t drawCount, const uint32_t stride)
     {
-        mCommandBuffer->drawIndirect(infoBuffer.getVkBuffer().get(), infoBuffer.getOffset(), drawCount, stride);
+        mCommandBuffer->drawIndirect(infoBuffer.getVkBuffer().get(), infoBuffer.getOffset(), drawCount, stride, mDispatcher);
     }
 
     void Command::drawIndexed(const uint32_t indexCount, const uint32_t instanceCount, const uint32_t firstIndex, const uint32_t vertexOffset, const uint32_t firstInstance)
     {
-        mCommandBuffer->drawIndexed(indexCount, instanceCount, firstIndex, vertexOffset, firstInstance);
+        mCommandBuffer->drawIndexed(indexCount, instanceCount, firstIndex, vertexOffset, firstInstance, mDispatcher);
     }
 
     void Command::drawIndexedIndirect(Buffer& infoBuffer, const vk::DeviceSize offset, const uint32_t drawCount, const uint32_t stride)
     {
-        mCommandBuffer->drawIndexedIndirect(infoBuffer.getVkBuffer().get(), offset, drawCount, stride);
+        mCommandBuffer->drawIndexedIndirect(infoBuffer.getVkBuffer().get(), offset, drawCount, stride, mDispatcher);
     }
 
     void Command::traceRays(const ShaderBindingTable& shaderBindingTable, const uint32_t width, const uint32_t height, const uint32_t depth)
     {
         const auto& sbtInfo = shaderBindingTable.getVkSBTInfo();
-        mCommandBuffer->traceRaysKHR(sbtInfo.rgen, sbtInfo.miss, sbtInfo.hit, sbtInfo.callable, width, height, depth);
+        mCommandBuffer->traceRaysKHR(sbtInfo.rgen, sbtInfo.miss, sbtInfo.hit, sbtInfo.callable, width, height, depth, mDispatcher);
     }
 
     void Command::traceRaysIndirect(const ShaderBindingTable& shaderBindingTable, const vk::DeviceAddress infoBufferDeviceAddress)
     {
         const auto& sbtInfo = shaderBindingTable.getVkSBTInfo();
-        mCommandBuffer->traceRaysIndirectKHR(sbtInfo.rgen, sbtInfo.miss, sbtInfo.hit, sbtInfo.callable, infoBufferDeviceAddress);
+        mCommandBuffer->traceRaysIndirectKHR(sbtInfo.rgen, sbtInfo.miss, sbtInfo.hit, sbtInfo.callable, infoBufferDeviceAddress, mDispatcher);
     }
 
     void Command::traceRaysIndirect2(const vk::DeviceAddress infoBufferDeviceAddress)
     {
-        mCommandBuffer->traceRaysIndirect2KHR(infoBufferDeviceAddress);
+        mCommandBuffer->traceRaysIndirect2KHR(infoBufferDeviceAddress, mDispatcher);
     }
 
     void Command::dispatch(const uint32_t groupCountX, const uint32_t groupCountY, const uint32_t groupCountZ, const uint32_t countBaseX, const uint32_t countBaseY, const uint32_t countBaseZ)
     {
-        mCommandBuffer->dispatchBase(countBaseX, countBaseY, countBaseZ, groupCountX, groupCountY, groupCountZ);
+        mCommandBuffer->dispatchBase(countBaseX, countBaseY, countBaseZ, groupCountX, groupCountY, groupCountZ, mDispatcher);
     }
 
     void Command::dispatchIndirect(Buffer& infoBuffer, vk::DeviceSize offset)
     {
-        mCommandBuffer->dispatchIndirect(infoBuffer.getVkBuffer().get(), offset);
+        mCommandBuffer->dispatchIndirect(infoBuffer.getVkBuffer().get(), offset, mDispatcher);
     }
 
     void Command::globalPipelineBarrier(const vk::MemoryBarrier barrier, const vk::PipelineStageFlags from, const vk::PipelineStageFlags to)
     {
-        mCommandBuffer->pipelineBarrier(from, to, {}, barrier, {}, {});
+        mCommandBuffer->pipelineBarrier(from, to, {}, barrier, {}, {}, mDispatcher);
     }
 
     void Command::bufferPipelineBarrier(const vk::BufferMemoryBarrier barrier, const vk::PipelineStageFlags from, const vk::PipelineStageFlags to)
     {
-        mCommandBuffer->pipelineBarrier(from, to, {}, {}, barrier, {});
+        mCommandBuffer->pipelineBarrier(from, to, {}, {}, barrier, {}, mDispatcher);
     }
 
     void Command::imagePipelineBarrier(const vk::ImageMemoryBarrier barrier, const vk::PipelineStageFlags from, const vk::PipelineStageFlags to)
     {
-        mCommandBuffer->pipelineBarrier(from, to, {}, {}, {}, barrier);
+        mCommandBuffer->pipelineBarrier(from, to, {}, {}, {}, barrier, mDispatcher);
     }
 
     void Command::transitionImageLayout(Image& image, const vk::ImageLayout from, const vk::ImageLayout to)
     {
-        transitionLayoutInternal(image.getVkImage().get(), image.getVkAspectFlag(), from, to);
+        transitionLayoutInternal(image.getVkImage().get(), image.getVkSubresourceRange(), from, to);
+    }
+
+    void Command::transitionImageLayout(Image& image, const vk::ImageLayout from, const vk::ImageLayout to, const vk::ImageSubresourceRange& range)
+    {
+        transitionLayoutInternal(image.getVkImage().get(), range, from, to);
+    }
+
+    void Command::releaseBufferOwnership(Buffer& buffer, const QueueType dstQueue, const vk::AccessFlags srcAccess, const vk::PipelineStageFlags srcStage)
+    {
+        const uint32_t srcFamily = mDevice.getVkQueueFamilyIndex(mQueueType);
+        const uint32_t dstFamily = mDevice.getVkQueueFamilyIndex(dstQueue);
+        if (srcFamily == dstFamily)
+        {
+            return;
+        }
+
+        // dstAccessMask is ignored for the release operation
+        vk::BufferMemoryBarrier barrier(srcAccess, {}, srcFamily, dstFamily, buffer.getVkBuffer().get(), 0, VK_WHOLE_SIZE);
+        mCommandBuffer->pipelineBarrier(srcStage, vk::PipelineStageFlagBits::eBottomOfPipe, {}, {}, barrier, {}, mDispatcher);
+    }
+
+    void Command::acquireBufferOwnership(Buffer& buffer, const QueueType srcQueue, const vk::AccessFlags dstAccess, const vk::PipelineStageFlags dstStage)
+    {
+        const uint32_t srcFamily = mDevice.getVkQueueFamilyIndex(srcQueue);
+        const uint32_t dstFamily = mDevice.getVkQueueFamilyIndex(mQueueType);
+        if (srcFamily == dstFamily)
+        {
+            vk::BufferMemoryBarrier barrier(vk::AccessFlagBits::eMemoryWrite, dstAccess, VK_QUEUE_FAMILY_IGNORED, VK_QUEUE_FAMILY_IGNORED, buffer.getVkBuffer().get(), 0, VK_WHOLE_SIZE);
+            mCommandBuffer->pipelineBarrier(vk::PipelineStageFlagBits::eAllCommands, dstStage, {}, {}, barrier, {}, mDispatcher);
+            return;
+        }
+
+        // srcAccessMask is ignored for the acquire operation
+        vk::BufferMemoryBarrier barrier({}, dstAccess, srcFamily, dstFamily, buffer.getVkBuffer().get(), 0, VK_WHOLE_SIZE);
+        mCommandBuffer->pipelineBarrier(vk::PipelineStageFlagBits::eTopOfPipe, dstStage, {}, {}, barrier, {}, mDispatcher);
+    }
+
+    void Command::releaseImageOwnership(Image& image, const QueueType dstQueue, const vk::ImageLayout from, const vk::ImageLayout to, const vk::AccessFlags srcAccess, const vk::PipelineStageFlags srcStage)
+    {
+        const uint32_t srcFamily = mDevice.getVkQueueFamilyIndex(mQueueType);
+        const uint32_t dstFamily = mDevice.getVkQueueFamilyIndex(dstQueue);
+        if (srcFamily == dstFamily)
+        {
+            return;
+        }
+
+        const vk::ImageSubresourceRange range(image.getVkAspectFlag(), 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS);
+        vk::ImageMemoryBarrier barrier(srcAccess, {}, from, to, srcFamily, dstFamily, image.getVkImage().get(), range);
+        mCommandBuffer->pipelineBarrier(srcStage, vk::PipelineStageFlagBits::eBottomOfPipe, {}, {}, {}, barrier, mDispatcher);
+    }
+
+    void Command::acquireImageOwnership(Image& image, const QueueType srcQueue, const vk::ImageLayout from, const vk::ImageLayout to, const vk::AccessFlags dstAccess, const vk::PipelineStageFlags dstStage)
+    {
+        const uint32_t srcFamily = mDevice.getVkQueueFamilyIndex(srcQueue);
+        const uint32_t dstFamily = mDevice.getVkQueueFamilyIndex(mQueueType);
+
+        const vk::ImageSubresourceRange range(image.getVkAspectFlag(), 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS);
+        if (srcFamily == dstFamily)
+        {
+            vk::ImageMemoryBarrier barrier(vk::AccessFlagBits::eMemoryWrite, dstAccess, from, to, VK_QUEUE_FAMILY_IGNORED, VK_QUEUE_FAMILY_IGNORED, image.getVkImage().get(), range);
+            mCommandBuffer->pipelineBarrier(vk::PipelineStageFlagBits::eAllCommands, dstStage, {}, {}, {}, barrier, mDispatcher);
+            return;
+        }
+
+        vk::ImageMemoryBarrier barrier({}, dstAccess, from, to, srcFamily, dstFamily, image.getVkImage().get(), range);
+        mCommandBuffer->pipelineBarrier(vk::PipelineStageFlagBits::eTopOfPipe, dstStage, {}, {}, {}, barrier, mDispatcher);
     }
 
-    void Command::copyBufferToImage(Buffer& buffer, Image& image, const uint32_t width, const uint32_t height)
+    void Command::copyBufferToImage(Buffer& buffer, Image& image, const uint32_t width, const uint32_t height, const uint32_t mipLevel, const vk::DeviceSize bufferOffset)
     {
+        assert(mipLevel < image.getMipLevels() || !"the mip level is out of the image!");
+
         vk::BufferImageCopy region;
-        region.bufferOffset      = 0;
+        region.bufferOffset      = bufferOffset;
         region.bufferRowLength   = 0;
         region.bufferImageHeight = 0;
 
-        region.imageSubresource.aspectMask     = vk::ImageAspectFlagBits::eColor;
-        region.imageSubresource.mipLevel       = 0;
+        region.imageSubresource.aspectMask     = image.getVkAspectFlag();
+        region.imageSubresource.mipLevel       = mipLevel;
         region.imageSubresource.baseArrayLayer = 0;
         region.imageSubresource.layerCount     = 1;
 
         region.imageOffset = vk::Offset3D(0, 0, 0);
         region.imageExtent = vk::Extent3D(width, height, 1);
 
-        mCommandBuffer->copyBufferToImage(buffer.getVkBuffer().get(), image.getVkImage().get(), vk::ImageLayout::eTransferDstOptimal, region);
+        mCommandBuffer->copyBufferToImage(buffer.getVkBuffer().get(), image.getVkImage().get(), vk::ImageLayout::eTransferDstOptimal, region, mDispatcher);
+    }
+
+    void Command::generateMipmaps(Image& image, const vk::ImageLayout finalLayout)
+    {
+        const vk::Image vkImage = image.getVkImage().get();
+        const auto aspect       = image.getVkAspectFlag();
+        const auto extent       = image.getVkExtent();
+        const uint32_t levelNum = image.getMipLevels();
+
+        // blits of sRGB formats decode to linear before filtering and encode after
+        const auto features     = mDevice.getVkPhysicalDevice().getFormatProperties(image.getVkFormat()).optimalTilingFeatures;
+        const vk::Filter filter = (features & vk::FormatFeatureFlagBits::eSampledImageFilterLinear) ? vk::Filter::eLinear : vk::Filter::eNearest;
+        if (!(features & vk::FormatFeatureFlagBits::eBlitSrc) || !(features & vk::FormatFeatureFlagBits::eBlitDst))
+        {
+            throw std::runtime_error("the format of the image doesn't support blits for generating mip levels!");
+        }
+
+        for (uint32_t level = 1; level < levelNum; ++level)
+        {
+            transitionLayoutInternal(vkImage, vk::ImageSubresourceRange(aspect, level - 1, 1, 0, 1), vk::ImageLayout::eTransferDstOptimal, vk::ImageLayout::eTransferSrcOptimal);
+
+            vk::ImageBlit blit;
+            blit.srcSubresource = vk::ImageSubresourceLayers(aspect, level - 1, 0, 1);
+            blit.srcOffsets[1]  = vk::Offset3D(std::max(extent.width >> (level - 1), 1u), std::max(extent.height >> (level - 1), 1u), std::max(extent.depth >> (level - 1), 1u));
+            blit.dstSubresource = vk::ImageSubresourceLayers(aspect, level, 0, 1);
+            blit.dstOffsets[1]  = vk::Offset3D(std::max(extent.width >> level, 1u), std::max(extent.height >> level, 1u), std::max(extent.depth >> level, 1u));
+            mCommandBuffer->blitImage(vkImage, vk::ImageLayout::eTransferSrcOptimal, vkImage, vk::ImageLayout::eTransferDstOptimal, blit, filter, mDispatcher);
+        }
+
+        // every level except the last one has been read by a blit
+        std::vector<vk::ImageMemoryBarrier> barriers;
+        if (levelNum > 1)
+        {
+            barriers.emplace_back(vk::AccessFlagBits::eTransferRead, vk::AccessFlagBits::eMemoryRead, vk::ImageLayout::eTransferSrcOptimal, finalLayout, VK_QUEUE_FAMILY_IGNORED, VK_QUEUE_FAMILY_IGNORED, vkImage,
+                                  vk::ImageSubresourceRange(aspect, 0, levelNum - 1, 0, 1));
+        }
+        barriers.emplace_back(vk::AccessFlagBits::eTransferWrite, vk::AccessFlagBits::eMemoryRead, vk::ImageLayout::eTransferDstOptimal, finalLayout, VK_QUEUE_FAMILY_IGNORED, VK_QUEUE_FAMILY_IGNORED, vkImage,
+                              vk::ImageSubresourceRange(aspect, levelNum - 1, 1, 0, 1));
+        mCommandBuffer->pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eAllCommands, {}, {}, {}, barriers, mDispatcher);
     }
 
     void Command::copyImageToBuffer(Image& image, Buffer& buffer, const vk::BufferImageCopy& copyInfo)
     {
-        mCommandBuffer->copyImageToBuffer(image.getVkImage().get(), vk::ImageLayout::eTransferSrcOptimal, buffer.getVkBuffer().get(), copyInfo);
+        mCommandBuffer->copyImageToBuffer(image.getVkImage().get(), vk::ImageLayout::eTransferSrcOptimal, buffer.getVkBuffer().get(), copyInfo, mDispatcher);
     }
 
     void Command::copyImage(Image& src, Image& dst, const vk::ImageCopy& region)
     {
-        mCommandBuffer->copyImage(src.getVkImage().get(), vk::ImageLayout::eTransferSrcOptimal, dst.getVkImage().get(), vk::ImageLayout::eTransferDstOptimal, region);
+        mCommandBuffer->copyImage(src.getVkImage().get(), vk::ImageLayout::eTransferSrcOptimal, dst.getVkImage().get(), vk::ImageLayout::eTransferDstOptimal, region, mDispatcher);
     }
 
     void Command::copyImageToSwapchain(Image& src, Window& window, const vk::ImageCopy& region, const uint32_t frameBufferIndex)
     {
         auto swapchainImage = window.getVkImages().at(frameBufferIndex);
-        transitionLayoutInternal(swapchainImage, vk::ImageAspectFlagBits::eColor, vk::ImageLayout::ePresentSrcKHR, vk::ImageLayout::eTransferDstOptimal);
-        mCommandBuffer->copyImage(src.getVkImage().get(), vk::ImageLayout::eTransferSrcOptimal, swapchainImage, vk::ImageLayout::eTransferDstOptimal, region);
+        transitionLayoutInternal(swapchainImage, vk::ImageSubresourceRange(vk::ImageAspectFlagBits::eColor, 0, 1, 0, 1), vk::ImageLayout::ePresentSrcKHR, vk::ImageLayout::eTransferDstOptimal);
+        mCommandBuffer->copyImage(src.getVkImage().get(), vk::ImageLayout::eTransferSrcOptimal, swapchainImage, vk::ImageLayout::eTransferDstOptimal, region, mDispatcher);
     }
 
     void Command::clearImage(Image& target, const vk::ImageLayout layout, const vk::ClearValue& clearValue, const vk::ArrayProxy<vk::ImageSubresourceRange>& ranges)
     {
         if (target.getVkAspectFlag() | vk::ImageAspectFlagBits::eColor)
         {
-            mCommandBuffer->clearColorImage(target.getVkImage().get(), layout, clearValue.color, ranges);
+            mCommandBuffer->clearColorImage(target.getVkImage().get(), layout, clearValue.color, ranges, mDispatcher);
         }
         else  // depth
         {
-            mCommandBuffer->clearDepthStencilImage(target.getVkImage().get(), layout, clearValue.depthStencil, ranges);
+            mCommandBuffer->clearDepthStencilImage(target.getVkImage().get(), layout, clearValue.depthStencil, ranges, mDispatcher);
         }
     }
 
     void Command::fillBuffer(Buffer& buffer, const vk::DeviceSize offset, const vk::DeviceSize size, const uint32_t value)
 	{
-		mCommandBuffer->fillBuffer(buffer.getVkBuffer().get(), offset, size, value);
+		mCommandBuffer->fillBuffer(buffer.getVkBuffer().get(), offset, size, value, mDispatcher);
 	}
 
+    void Command::beginProfileScope(std::string_view name, const bool pipelineStatistics)
+    {
+        // pipeline statistics queries can't be nested
+        const bool statistics = pipelineStatistics && std::none_of(mProfileScopes.begin(), mProfileScopes.end(), [](const auto& scope) { return scope.second; });
+
+        const uint32_t index = mDevice.getProfiler().beginScope(mCommandBuffer.get(), mDevice.getVkQueueFamilyIndex(mQueueType), name, statistics);
+        mProfileScopes.emplace_back(index, statistics);
+    }
+
+    void Command::endProfileScope()
+    {
+        assert(!mProfileScopes.empty() || !"no profile scope has begun!");
+
+        mDevice.getProfiler().endScope(mCommandBuffer.get(), mProfileScopes.back().first);
+        mProfileScopes.pop_back();
+    }
+
     void Command::drawImGui()
     {
         // ImGui command write
@@ -256,30 +411,71 @@ namespace vk2s
 
     void Command::execute(const Handle<Fence>& fence, const Handle<Semaphore>& wait, const Handle<Semaphore>& signal)
     {
-        vk::SubmitInfo submitInfo(nullptr, nullptr, mCommandBuffer.get(), nullptr);
+        // TODO: change wait stage
+        // (compute and transfer queues don't support the color attachment stage)
+        const vk::PipelineStageFlags waitStage(mQueueType == QueueType::eGraphics ? vk::PipelineStageFlagBits::eColorAttachmentOutput : vk::PipelineStageFlagBits::eAllCommands);
 
-        if (wait)
-        {
-            // TODO: change wait stage
-            constexpr vk::PipelineStageFlags waitStage(vk::PipelineStageFlagBits::eColorAttachmentOutput);
+        const SemaphoreWait waitInfo{ .semaphore = wait, .stage = waitStage };
+        const SemaphoreSignal signalInfo{ .semaphore = signal };
 
-            submitInfo.setWaitSemaphores(wait->getVkSemaphore().get());
-            submitInfo.setWaitDstStageMask(waitStage);
-        }
+        execute(wait ? vk::ArrayProxy<const SemaphoreWait>(waitInfo) : vk::ArrayProxy<const SemaphoreWait>(), signal ? vk::ArrayProxy<const SemaphoreSignal>(signalInfo) : vk::ArrayProxy<const SemaphoreSignal>(), fence);
+    }
 
-        if (signal)
+    void Command::execute(const vk::ArrayProxy<const SemaphoreWait>& waits, const vk::ArrayProxy<const SemaphoreSignal>& signals, const Handle<Fence>& fence)
+    {
+        std::vector<vk::Semaphore> waitSems;
+        std::vector<uint64_t> waitValues;
+        std::vector<vk::PipelineStageFlags> waitStages;
+        waitSems.reserve(waits.size());
+        waitValues.reserve(waits.size());
+        waitStages.reserve(waits.size());
+        for (const auto& wait : waits)
         {
-            submitInfo.setSignalSemaphores(signal->getVkSemaphore().get());
+            waitSems.emplace_back(wait.semaphore->getVkSemaphore().get());
+            waitValues.emplace_back(wait.value);
+            waitStages.emplace_back(wait.stage);
         }
 
-        if (fence)
+        // always signal the submission timeline of the device (the value is filled with the submission index below, the value for a binary semaphore is ignored)
+        std::vector<vk::Semaphore> signalSems;
+        std::vector<uint64_t> signalValues;
+        signalSems.reserve(signals.size() + 1);
+        signalValues.reserve(signals.size() + 1);
+        signalSems.emplace_back(mDevice.getVkSubmissionTimeline(mQueueType).get());
+        signalValues.emplace_back(0);
+        for (const auto& signal : signals)
         {
-            mDevice.getVkGraphicsQueue().submit(submitInfo, fence->getVkFence().get());
+            signalSems.emplace_back(signal.semaphore->getVkSemaphore().get());
+            signalValues.emplace_back(signal.value);
         }
-        else
+
+        vk::TimelineSemaphoreSubmitInfo timelineInfo(waitValues, signalValues);
+        vk::SubmitInfo submitInfo(waitSems, waitStages, mCommandBuffer.get(), signalSems, &timelineInfo);
+
         {
-            mDevice.getVkGraphicsQueue().submit(submitInfo);
+            // issue the index and submit at once, so that the timeline is signaled in increasing order even if other threads submit
+            std::lock_guard lock(mDevice.getVkQueueMutex());
+
+            mLastSubmissionIndex = mDevice.issueSubmissionIndex(mQueueType);
+            signalValues.front() = mLastSubmissionIndex;
+
+            const auto& queue = mDevice.getVkQueue(mQueueType);
+            if (fence)
+            {
+                queue.submit(submitInfo, fence->getVkFence().get(), mDispatcher);
+            }
+            else
+            {
+                queue.submit(submitInfo, {}, mDispatcher);
+            }
         }
+
+        mDevice.releaseRetiredObjects();
+    }
+
+    uint64_t Command::getLastSubmissionIndex() const
+    {
+        return mLastSubmissionIndex;
     }
 
     const vk::UniqueCommandBuffer& Command::getVkCommandBuffer()
@@ -287,19 +483,20 @@ namespace vk2s
         return mCommandBuffer;
     }
 
-    inline void Command::transitionLayoutInternal(vk::Image image, vk::ImageAspectFlags flag, const vk::ImageLayout from, const vk::ImageLayout to)
+    QueueType Command::getQueueType() const
+    {
+        return mQueueType;
+    }
+
+    inline void Command::transitionLayoutInternal(vk::Image image, const vk::ImageSubresourceRange& range, const vk::ImageLayout from, const vk::ImageLayout to)
     {
         vk::ImageMemoryBarrier barrier;
-        barrier.oldLayout                       = from;
-        barrier.newLayout                       = to;
-        barrier.srcQueueFamilyIndex             = VK_QUEUE_FAMILY_IGNORED;
-        barrier.dstQueueFamilyIndex             = VK_QUEUE_FAMILY_IGNORED;
-        barrier.image                           = image;
-        barrier.subresourceRange.aspectMask     = flag;
-        barrier.subresourceRange.baseMipLevel   = 0;
-        barrier.subresourceRange.levelCount     = 1;
-        barrier.subresourceRange.baseArrayLayer = 0;
-        barrier.subresourceRange.layerCount     = 1;
+        barrier.oldLayout           = from;
+        barrier.newLayout           = to;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image               = image;
+        barrier.subresourceRange    = range;
 
         vk::PipelineStageFlags sourceStage;
         vk::PipelineStageFlags destinationStage;
@@ -453,7 +650,7 @@ namespace vk2s
             throw std::invalid_argument("unsupported layout transition!");
         }
 
-        mCommandBuffer->pipelineBarrier(sourceStage, destinationStage, {}, {}, {}, barrier);
+        mCommandBuffer->pipelineBarrier(sourceStage, destinationStage, {}, {}, {}, barrier, mDispatcher);
     }
 
 }  // namespace vk2s
\ No newline at end of file
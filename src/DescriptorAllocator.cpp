@@ -0,0 +1,257 @@
+/*****************************************************************/ /**
+ * @file   DescriptorAllocator.cpp
+ * @brief  source file of DescriptorAllocator class
+ *
+ * @author agent
+ * @date   October 2026
+ *********************************************************************/
+#include "../include/vk2s/DescriptorAllocator.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+namespace vk2s
+{
+    namespace
+    {
+        //! each member of DescriptorPoolAllocationInfo and its descriptor type
+        constexpr std::pair<uint32_t DescriptorPoolAllocationInfo::*, vk::DescriptorType> kDescriptorTypes[] = {
+            { &DescriptorPoolAllocationInfo::accelerationStructureNum, vk::DescriptorType::eAccelerationStructureKHR },
+            { &DescriptorPoolAllocationInfo::combinedImageSamplerNum, vk::DescriptorType::eCombinedImageSampler },
+            { &DescriptorPoolAllocationInfo::sampledImageNum, vk::DescriptorType::eSampledImage },
+            { &DescriptorPoolAllocationInfo::samplerNum, vk::DescriptorType::eSampler },
+            { &DescriptorPoolAllocationInfo::storageBufferNum, vk::DescriptorType::eStorageBuffer },
+            { &DescriptorPoolAllocationInfo::storageImageNum, vk::DescriptorType::eStorageImage },
+            { &DescriptorPoolAllocationInfo::uniformBufferNum, vk::DescriptorType::eUniformBuffer },
+            { &DescriptorPoolAllocationInfo::uniformBufferDynamicNum, vk::DescriptorType::eUniformBufferDynamic },
+        };
+    }  // namespace
+
+    size_t DescriptorAllocator::AllocationInfoHash::operator()(const DescriptorPoolAllocationInfo& info) const noexcept
+    {
+        // FNV-1a over the counts
+        size_t hash = 14695981039346656037ull;
+        for (const auto& [member, type] : kDescriptorTypes)
+        {
+            hash = (hash ^ info.*member) * 1099511628211ull;
+        }
+
+        return hash;
+    }
+
+    DescriptorAllocator::DescriptorAllocator(vk::Device device, const bool useAccelerationStructure)
+        : mDevice(device)
+        , mUseAccelerationStructure(useAccelerationStructure)
+        , mSetNum(0)
+    {
+    }
+
+    DescriptorAllocator::~DescriptorAllocator()
+    {
+        // every set is released with its pool
+    }
+
+    std::pair<vk::DescriptorSet, size_t> DescriptorAllocator::allocate(const vk::DescriptorSetLayout& layout, const DescriptorPoolAllocationInfo& allocInfo)
+    {
+        std::lock_guard lock(mMutex);
+
+        auto& bucket = mBuckets[allocInfo];
+
+        while (true)
+        {
+            const bool created = bucket.freePools.empty();
+            if (created)
+            {
+                const uint32_t setNum = bucket.nextSetNum;
+                bucket.nextSetNum     = std::min(bucket.nextSetNum * 2, kMaxSetNum);
+
+                DescriptorPoolAllocationInfo descriptorNum;
+                for (const auto& [member, type] : kDescriptorTypes)
+                {
+                    descriptorNum.*member = allocInfo.*member * setNum;
+                }
+
+                auto& added          = mPools.emplace_back();
+                added.descriptorPool = createVkDescriptorPool(descriptorNum, setNum, vk::DescriptorPoolCreateFlagBits::eFreeDescriptorSet);
+                added.freeSetNum     = setNum;
+                added.listed         = true;
+                added.key            = allocInfo;
+                bucket.freePools.emplace_back(mPools.size() - 1);
+            }
+
+            const size_t poolIndex = bucket.freePools.back();
+            auto& pool             = mPools[poolIndex];
+
+            vk::DescriptorSet set;
+            try
+            {
+                vk::DescriptorSetAllocateInfo ai(pool.descriptorPool.get(), layout);
+                set = mDevice.allocateDescriptorSets(ai).front();
+            }
+            catch (const vk::SystemError&)
+            {
+                // drivers may still report fragmentation, treat the pool as full and try the next one
+                if (created)
+                {
+                    throw;
+                }
+                pool.freeSetNum = 0;
+            }
+
+            if (set)
+            {
+                --pool.freeSetNum;
+                ++mSetNum;
+            }
+
+            if (pool.freeSetNum == 0)
+            {
+                bucket.freePools.pop_back();
+                pool.listed = false;
+            }
+
+            if (set)
+            {
+                return { set, poolIndex };
+            }
+        }
+    }
+
+    void DescriptorAllocator::deallocate(const vk::DescriptorSet& set, const size_t poolIndex)
+    {
+        std::lock_guard lock(mMutex);
+
+        assert(poolIndex < mPools.size() || !"invalid descriptor pool index!");
+        auto& pool = mPools[poolIndex];
+
+        mDevice.freeDescriptorSets(pool.descriptorPool.get(), set);
+        ++pool.freeSetNum;
+        --mSetNum;
+
+        if (!pool.listed)
+        {
+            mBuckets[pool.key].freePools.emplace_back(poolIndex);
+            pool.listed = true;
+        }
+    }
+
+    vk::DescriptorSet DescriptorAllocator::allocateTransient(const vk::DescriptorSetLayout& layout, const DescriptorPoolAllocationInfo& allocInfo)
+    {
+        std::lock_guard lock(mMutex);
+
+        if (mTransientPools.empty() || !fits(mTransientPools.back(), allocInfo))
+        {
+            // reuse a reset pool if it is large enough, otherwise create one
+            auto iter = std::find_if(mFreeTransientPools.begin(), mFreeTransientPools.end(), [&](const TransientPool& pool) { return fits(pool, allocInfo); });
+            if (iter != mFreeTransientPools.end())
+            {
+                mTransientPools.emplace_back(std::move(*iter));
+                mFreeTransientPools.erase(iter);
+            }
+            else
+            {
+                DescriptorPoolAllocationInfo capacity(kTransientSetNum);
+                for (const auto& [member, type] : kDescriptorTypes)
+                {
+                    capacity.*member = std::max(capacity.*member, allocInfo.*member);
+                }
+                if (!mUseAccelerationStructure)
+                {
+                    assert(allocInfo.accelerationStructureNum == 0 || !"acceleration structure descriptors are not available!");
+                    capacity.accelerationStructureNum = 0;
+                }
+
+                auto& added          = mTransientPools.emplace_back();
+                added.descriptorPool = createVkDescriptorPool(capacity, kTransientSetNum, {});
+                added.capacity       = capacity;
+                added.now            = capacity;
+                added.setNum         = kTransientSetNum;
+            }
+        }
+
+        auto& pool = mTransientPools.back();
+        for (const auto& [member, type] : kDescriptorTypes)
+        {
+            pool.now.*member -= allocInfo.*member;
+        }
+        --pool.setNum;
+
+        vk::DescriptorSetAllocateInfo ai(pool.descriptorPool.get(), layout);
+
+        return mDevice.allocateDescriptorSets(ai).front();
+    }
+
+    void DescriptorAllocator::advanceFrame(const uint64_t submissionIndex, const uint64_t completedSubmissionIndex)
+    {
+        std::lock_guard lock(mMutex);
+
+        for (auto& pool : mTransientPools)
+        {
+            mRetiredTransientPools.emplace_back(submissionIndex, std::move(pool));
+        }
+        mTransientPools.clear();
+
+        while (!mRetiredTransientPools.empty() && mRetiredTransientPools.front().first <= completedSubmissionIndex)
+        {
+            auto& pool = mRetiredTransientPools.front().second;
+            mDevice.resetDescriptorPool(pool.descriptorPool.get());
+            pool.now    = pool.capacity;
+            pool.setNum = kTransientSetNum;
+            mFreeTransientPools.emplace_back(std::move(pool));
+            mRetiredTransientPools.pop_front();
+        }
+    }
+
+    DescriptorAllocator::Statistics DescriptorAllocator::getStatistics() const
+    {
+        std::lock_guard lock(mMutex);
+
+        Statistics stats;
+        stats.bucketNum        = mBuckets.size();
+        stats.poolNum          = mPools.size();
+        stats.setNum           = mSetNum;
+        stats.transientPoolNum = mTransientPools.size() + mRetiredTransientPools.size() + mFreeTransientPools.size();
+
+        return stats;
+    }
+
+    vk::UniqueDescriptorPool DescriptorAllocator::createVkDescriptorPool(const DescriptorPoolAllocationInfo& descriptorNum, const uint32_t maxSets, const vk::DescriptorPoolCreateFlags flags)
+    {
+        std::vector<vk::DescriptorPoolSize> poolSizes;
+        for (const auto& [member, type] : kDescriptorTypes)
+        {
+            if (descriptorNum.*member > 0)
+            {
+                poolSizes.emplace_back(type, descriptorNum.*member);
+            }
+        }
+
+        // sets without any descriptor still need a valid pool
+        if (poolSizes.empty())
+        {
+            poolSizes.emplace_back(vk::DescriptorType::eSampler, 1);
+        }
+
+        vk::DescriptorPoolCreateInfo ci(flags, maxSets, poolSizes);
+
+        return mDevice.createDescriptorPoolUnique(ci);
+    }
+
+    bool DescriptorAllocator::fits(const TransientPool& pool, const DescriptorPoolAllocationInfo& allocInfo)
+    {
+        if (pool.setNum == 0)
+        {
+            return false;
+        }
+
+        for (const auto& [member, type] : kDescriptorTypes)
+        {
+            if (pool.now.*member < allocInfo.*member)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+}  // namespace vk2s
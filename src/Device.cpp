@@ -2,8 +2,10 @@
 
 #include <GLFW/glfw3.h>
 
+#include <algorithm>
 #include <iostream>
 #include <set>
+#include <string_view>
 #include <imgui_impl_glfw.h>
 #include <imgui_impl_vulkan.h>
 
@@ -16,20 +18,89 @@ namespace vk2s
     {
     }
 
+    template <size_t N = 0, typename T>
+    void iterateTupleAndSetResource(T& t, const Device::PoolResources& poolResources)
+    {
+        if constexpr (N < std::tuple_size<T>::value)
+        {
+            auto& x             = std::get<N>(t);
+            using AllocatorType = typename std::remove_reference_t<decltype(x)>::AllocatorType;
+            if constexpr (std::is_constructible_v<AllocatorType, std::pmr::memory_resource*>)
+            {
+                std::pmr::memory_resource* pResource = poolResources.resources[N] ? poolResources.resources[N] : poolResources.pDefaultResource;
+                if (pResource)
+                {
+                    x.setAllocator(AllocatorType(pResource));
+                }
+            }
+            iterateTupleAndSetResource<N + 1>(t, poolResources);
+        }
+    }
+
     Device::Device(const Extensions extensions, const bool useWindow)
+        : Device(extensions, useWindow, PoolResources())
+    {
+    }
+
+    Device::Device(const Extensions extensions, const bool useWindow, const PoolResources& poolResources)
+        : Device(extensions, useWindow, false, poolResources)
+    {
+    }
+
+    Device::Device(const Extensions extensions, const Headless, const PoolResources& poolResources)
+        : Device(extensions, false, true, poolResources)
+    {
+    }
+
+    namespace
+    {
+        //! run the phase and record its elapsed time
+        template <typename F>
+        void measureStartupPhase(std::vector<Device::StartupPhase>& phases, std::string_view name, F&& phase)
+        {
+            const auto begin = std::chrono::steady_clock::now();
+            phase();
+            phases.emplace_back(Device::StartupPhase{ name, std::chrono::steady_clock::now() - begin });
+        }
+    }  // namespace
+
+    Device::Device(const Extensions extensions, const bool useWindow, const bool headless, const PoolResources& poolResources)
         : mQueriedExtensions(extensions)
+        , mHeadless(headless)
+        , mMemoryBudgetEnabled(false)
+        , mLastSubmissionIndices{}
+        , mSubmissionIndex(0)
         , mImGuiActive(false)
     {
-        glfwInit();
+        const auto begin = std::chrono::steady_clock::now();
 
-        createInstance();
-        setupDebugMessenger();
+        iterateTupleAndSetResource(mPools, poolResources);
+
+        if (!mHeadless)
+        {
+            measureStartupPhase(mStartupPhases, "glfw", [&]() { glfwInit(); });
+        }
+
+        measureStartupPhase(mStartupPhases, "instance", [&]() { createInstance(); });
+        measureStartupPhase(mStartupPhases, "debug messenger", [&]() { setupDebugMessenger(); });
         pickAndCreateDevice(useWindow);
-        createCommandPool();
+        // buffer device address is enabled only with ray tracing
+        measureStartupPhase(mStartupPhases, "memory allocator",
+                            [&]() { mMemoryAllocator = std::make_unique<MemoryAllocator>(mPhysicalDevice, mDevice.get(), mQueriedExtensions.useRayTracingExt, mMemoryBudgetEnabled); });
+        measureStartupPhase(mStartupPhases, "pipeline cache", [&]() { mPipelineCache = std::make_unique<PipelineCache>(mPhysicalDevice, mDevice.get()); });
+        measureStartupPhase(mStartupPhases, "command pools", [&]() { createCommandPool(); });
+        measureStartupPhase(mStartupPhases, "submission timelines", [&]() { createSubmissionTimeline(); });
+
+        if (!mHeadless)
+        {
+            measureStartupPhase(mStartupPhases, "imgui descriptor pool", [&]() { createDescriptorPoolForImGui(); });
+        }
 
-        createDescriptorPoolForImGui();
+        measureStartupPhase(mStartupPhases, "descriptor allocator", [&]() { mDescriptorAllocator = std::make_unique<DescriptorAllocator>(mDevice.get(), mQueriedExtensions.useRayTracingExt); });
+        measureStartupPhase(mStartupPhases, "profiler", [&]() { mProfiler = std::make_unique<Profiler>(*this); });
+        measureStartupPhase(mStartupPhases, "uploader", [&]() { mUploader = std::make_unique<Uploader>(*this); });
 
-        createDescriptorPool();
+        mStartupPhases.emplace_back(StartupPhase{ "total", std::chrono::steady_clock::now() - begin });
     }
 
     template <size_t N = 0, typename T>
@@ -43,12 +114,40 @@ namespace vk2s
         }
     }
 
+    template <size_t N = 0, typename T>
+    size_t iterateTupleAndShrink(T& t)
+    {
+        if constexpr (N < std::tuple_size<T>::value)
+        {
+            auto& x = std::get<N>(t);
+            return x.shrink() + iterateTupleAndShrink<N + 1>(t);
+        }
+        else
+        {
+            return 0;
+        }
+    }
+
     Device::~Device()
     {
         mDevice->waitIdle();
 
+        // owns objects in the pools
+        mUploader.reset();
+
+        // every submission is retired here
+        drainDeferredDestructions();
+
         iterateTupleAndClear(mPools);
 
+        // objects destroyed by the pools may have deferred others
+        drainDeferredDestructions();
+
+        if (mHeadless)
+        {
+            return;
+        }
+
         destroyImGui();
         if (ImGui::GetCurrentContext())
         {
@@ -58,11 +157,28 @@ namespace vk2s
         glfwTerminate();
     }
 
+    void Device::drainDeferredDestructions()
+    {
+        // pop before calling, the destructor may defer another object
+        while (!mDeferredDestructions.empty())
+        {
+            auto destruction = std::move(mDeferredDestructions.front().second);
+            mDeferredDestructions.pop_front();
+            destruction();
+        }
+    }
+
     void Device::waitIdle()
     {
+        std::lock_guard lock(mQueueMutex);
         mDevice->waitIdle();
     }
 
+    size_t Device::shrinkPools()
+    {
+        return iterateTupleAndShrink(mPools);
+    }
+
     void Device::createDescriptorPoolForImGui()
     {
         vk::DescriptorPoolSize size(vk::DescriptorType::eCombinedImageSampler, 1);
@@ -74,6 +190,7 @@ namespace vk2s
 
     void Device::initImGui(Window& window, RenderPass& renderpass)
     {
+        assert(!mHeadless || !"ImGui can't be used with a headless Device!");
         // if the context is not set, create a new one
         if (!ImGui::GetCurrentContext())
         {
@@ -130,6 +247,11 @@ namespace vk2s
         return mDevice;
     }
 
+    const VulkanDispatchLoader& Device::getVkDispatcher() const
+    {
+        return mDispatcher;
+    }
+
     const QueueFamilyIndices Device::getVkQueueFamilyIndices() const
     {
         return mQueueFamilyIndices;
@@ -145,59 +267,268 @@ namespace vk2s
         return mPresentQueue;
     }
 
-    const vk::UniqueCommandPool& Device::getVkCommandPool()
+    const vk::Queue& Device::getVkComputeQueue()
     {
-        return mCommandPool;
+        return mComputeQueue;
     }
 
-    const std::pair<vk::DescriptorSet, size_t> Device::allocateVkDescriptorSet(const vk::DescriptorSetLayout& layout, const DescriptorPoolAllocationInfo& allocInfo)
+    const vk::Queue& Device::getVkTransferQueue()
+    {
+        return mTransferQueue;
+    }
+
+    const vk::Queue& Device::getVkQueue(const QueueType queueType)
+    {
+        switch (queueType)
+        {
+        case QueueType::eCompute:
+            return mComputeQueue;
+        case QueueType::eTransfer:
+            return mTransferQueue;
+        default:
+            return mGraphicsQueue;
+        }
+    }
+
+    uint32_t Device::getVkQueueFamilyIndex(const QueueType queueType) const
+    {
+        switch (queueType)
+        {
+        case QueueType::eCompute:
+            return mQueueFamilyIndices.computeFamily.value();
+        case QueueType::eTransfer:
+            return mQueueFamilyIndices.transferFamily.value();
+        default:
+            return mQueueFamilyIndices.graphicsFamily.value();
+        }
+    }
+
+    const vk::UniqueCommandPool& Device::getVkCommandPool(const QueueType queueType)
     {
-        size_t idx = 0;
-        for (const auto& pool : mDescriptorPools)
+        return mCommandPools[static_cast<size_t>(queueType)];
+    }
+
+    std::pair<vk::CommandBuffer, size_t> Device::allocateWorkerVkCommandBuffer(const QueueType queueType, const uint32_t frameIndex, const uint32_t workerIndex)
+    {
+        size_t poolIndex = 0;
+        WorkerCommandPool* pPool = nullptr;
         {
-            if (pool.now.accelerationStructureNum < allocInfo.accelerationStructureNum || pool.now.combinedImageSamplerNum < allocInfo.combinedImageSamplerNum || pool.now.sampledImageNum < allocInfo.sampledImageNum ||
-                pool.now.samplerNum < allocInfo.samplerNum || pool.now.storageBufferNum < allocInfo.storageBufferNum || pool.now.storageImageNum < allocInfo.storageImageNum || pool.now.uniformBufferNum < allocInfo.uniformBufferNum ||
-                pool.now.uniformBufferDynamicNum < allocInfo.uniformBufferDynamicNum)
+            std::lock_guard lock(mWorkerCommandPoolMutex);
+
+            const auto key = std::make_tuple(workerIndex, queueType, frameIndex);
+            if (auto iter = mWorkerCommandPoolIndices.find(key); iter != mWorkerCommandPoolIndices.end())
             {
-                break;
+                poolIndex = iter->second;
+                pPool     = &mWorkerCommandPools[poolIndex];
+            }
+            else
+            {
+                // individual reset is still allowed so that Command::reset() and re-recording keep working
+                vk::CommandPoolCreateInfo poolInfo(vk::CommandPoolCreateFlagBits::eTransient | vk::CommandPoolCreateFlagBits::eResetCommandBuffer, getVkQueueFamilyIndex(queueType));
+
+                poolIndex          = mWorkerCommandPools.size();
+                pPool              = &mWorkerCommandPools.emplace_back();
+                pPool->commandPool = mDevice->createCommandPoolUnique(poolInfo);
+                pPool->frameIndex  = frameIndex;
+                mWorkerCommandPoolIndices.emplace(key, poolIndex);
+            }
+        }
+
+        {
+            std::lock_guard lock(pPool->mutex);
+            if (!pPool->freeCommandBuffers.empty())
+            {
+                const auto commandBuffer = pPool->freeCommandBuffers.back();
+                pPool->freeCommandBuffers.pop_back();
+                return { commandBuffer, poolIndex };
             }
-            ++idx;
         }
 
-        if (idx == mDescriptorPools.size())
+        // only the thread currently acting as the worker allocates from its pool
+        vk::CommandBufferAllocateInfo allocInfo(pPool->commandPool.get(), vk::CommandBufferLevel::ePrimary, 1);
+
+        return { mDevice->allocateCommandBuffers(allocInfo).front(), poolIndex };
+    }
+
+    void Device::deallocateWorkerVkCommandBuffer(const vk::CommandBuffer commandBuffer, const size_t poolIndex)
+    {
+        WorkerCommandPool* pPool = nullptr;
+        {
+            std::lock_guard lock(mWorkerCommandPoolMutex);
+            assert(poolIndex < mWorkerCommandPools.size() || !"invalid command pool index!");
+            pPool = &mWorkerCommandPools[poolIndex];
+        }
+
+        // not freed to the pool (that needs the thread of the worker), reused by its next allocation
+        std::lock_guard lock(pPool->mutex);
+        pPool->freeCommandBuffers.emplace_back(commandBuffer);
+    }
+
+    void Device::resetWorkerCommandPools(const uint32_t frameIndex)
+    {
+        std::lock_guard lock(mWorkerCommandPoolMutex);
+
+        for (auto& pool : mWorkerCommandPools)
         {
-            createDescriptorPool();
+            if (pool.frameIndex == frameIndex)
+            {
+                mDevice->resetCommandPool(pool.commandPool.get());
+            }
         }
+    }
+
+    const vk::UniqueSemaphore& Device::getVkSubmissionTimeline(const QueueType queueType)
+    {
+        return mSubmissionTimelines[static_cast<size_t>(queueType)];
+    }
+
+    std::mutex& Device::getVkQueueMutex()
+    {
+        return mQueueMutex;
+    }
 
-        auto& allocatedPool = mDescriptorPools[idx];
-        allocatedPool.now.accelerationStructureNum -= allocInfo.accelerationStructureNum;
-        allocatedPool.now.combinedImageSamplerNum -= allocInfo.combinedImageSamplerNum;
-        allocatedPool.now.sampledImageNum -= allocInfo.sampledImageNum;
-        allocatedPool.now.samplerNum -= allocInfo.samplerNum;
-        allocatedPool.now.storageBufferNum -= allocInfo.storageBufferNum;
-        allocatedPool.now.storageImageNum -= allocInfo.storageImageNum;
-        allocatedPool.now.uniformBufferNum -= allocInfo.uniformBufferNum;
-        allocatedPool.now.uniformBufferDynamicNum -= allocInfo.uniformBufferDynamicNum;
+    uint64_t Device::issueSubmissionIndex(const QueueType queueType)
+    {
+        // serialized by mQueueMutex, the atomics only publish the indices to the readers
+        const uint64_t submissionIndex = mSubmissionIndex.load(std::memory_order_relaxed) + 1;
+        mLastSubmissionIndices[static_cast<size_t>(queueType)].store(submissionIndex, std::memory_order_release);
+        mSubmissionIndex.store(submissionIndex, std::memory_order_release);
 
-        vk::DescriptorSetAllocateInfo ai(allocatedPool.descriptorPool.get(), layout);
+        return submissionIndex;
+    }
 
-        return { mDevice->allocateDescriptorSets(ai).front(), idx };
+    uint64_t Device::getLatestSubmissionIndex() const
+    {
+        return mSubmissionIndex.load(std::memory_order_acquire);
+    }
+
+    uint64_t Device::getCompletedSubmissionIndex() const
+    {
+        // queues retire out of order, so everything up to the minimum over busy queues is retired
+        uint64_t completed = mSubmissionIndex.load(std::memory_order_acquire);
+        for (size_t i = 0; i < kQueueTypeNum; ++i)
+        {
+            const uint64_t lastSubmissionIndex = mLastSubmissionIndices[i].load(std::memory_order_acquire);
+            if (lastSubmissionIndex == 0)
+            {
+                continue;
+            }
+
+            const uint64_t value = mDevice->getSemaphoreCounterValue(mSubmissionTimelines[i].get());
+            if (value < lastSubmissionIndex)
+            {
+                completed = std::min(completed, value);
+            }
+        }
+
+        return completed;
+    }
+
+    void Device::waitSubmission(const uint64_t submissionIndex)
+    {
+        if (submissionIndex == 0 || getCompletedSubmissionIndex() >= submissionIndex)
+        {
+            return;
+        }
+
+        // wait on every queue until it passes the index (or retires all of its submissions)
+        std::array<vk::Semaphore, kQueueTypeNum> semaphores;
+        std::array<uint64_t, kQueueTypeNum> values;
+        uint32_t count = 0;
+        for (size_t i = 0; i < kQueueTypeNum; ++i)
+        {
+            const uint64_t lastSubmissionIndex = mLastSubmissionIndices[i].load(std::memory_order_acquire);
+            if (lastSubmissionIndex != 0)
+            {
+                semaphores[count] = mSubmissionTimelines[i].get();
+                values[count]     = std::min(submissionIndex, lastSubmissionIndex);
+                ++count;
+            }
+        }
+
+        const auto res = mDevice->waitSemaphores(vk::SemaphoreWaitInfo({}, count, semaphores.data(), values.data()), UINT64_MAX);
+        assert(res == vk::Result::eSuccess || !"failed to wait for submission!");
+    }
+
+    void Device::releaseRetiredObjects()
+    {
+        {
+            std::lock_guard lock(mDeferredDestructionMutex);
+            if (mDeferredDestructions.empty())
+            {
+                return;
+            }
+        }
+
+        const uint64_t completed = getCompletedSubmissionIndex();
+        while (true)
+        {
+            std::function<void()> destruction;
+            {
+                std::lock_guard lock(mDeferredDestructionMutex);
+                if (mDeferredDestructions.empty() || mDeferredDestructions.front().first > completed)
+                {
+                    break;
+                }
+
+                destruction = std::move(mDeferredDestructions.front().second);
+                mDeferredDestructions.pop_front();
+            }
+
+            // called without the lock, the destructor may defer another object
+            destruction();
+        }
+    }
+
+    const std::pair<vk::DescriptorSet, size_t> Device::allocateVkDescriptorSet(const vk::DescriptorSetLayout& layout, const DescriptorPoolAllocationInfo& allocInfo)
+    {
+        return mDescriptorAllocator->allocate(layout, allocInfo);
     }
 
     void Device::deallocateVkDescriptorSet(vk::DescriptorSet& set, const size_t poolIndex, const DescriptorPoolAllocationInfo& allocInfo)
     {
-        auto& allocatedPool = mDescriptorPools[poolIndex];
+        mDescriptorAllocator->deallocate(set, poolIndex);
+        set = vk::DescriptorSet();
+    }
+
+    vk::DescriptorSet Device::allocateTransientVkDescriptorSet(const vk::DescriptorSetLayout& layout, const DescriptorPoolAllocationInfo& allocInfo)
+    {
+        return mDescriptorAllocator->allocateTransient(layout, allocInfo);
+    }
+
+    void Device::advanceTransientDescriptorPools()
+    {
+        mDescriptorAllocator->advanceFrame(getLatestSubmissionIndex(), getCompletedSubmissionIndex());
+    }
+
+    PipelineCache& Device::getPipelineCache()
+    {
+        return *mPipelineCache;
+    }
+
+    DescriptorAllocator& Device::getDescriptorAllocator()
+    {
+        return *mDescriptorAllocator;
+    }
+
+    Profiler& Device::getProfiler()
+    {
+        return *mProfiler;
+    }
+
+    Uploader& Device::getUploader()
+    {
+        return *mUploader;
+    }
 
-        allocatedPool.now.accelerationStructureNum += allocInfo.accelerationStructureNum;
-        allocatedPool.now.combinedImageSamplerNum += allocInfo.combinedImageSamplerNum;
-        allocatedPool.now.sampledImageNum += allocInfo.sampledImageNum;
-        allocatedPool.now.samplerNum += allocInfo.samplerNum;
-        allocatedPool.now.storageBufferNum += allocInfo.storageBufferNum;
-        allocatedPool.now.storageImageNum += allocInfo.storageImageNum;
-        allocatedPool.now.uniformBufferNum += allocInfo.uniformBufferNum;
-        allocatedPool.now.uniformBufferDynamicNum += allocInfo.uniformBufferDynamicNum;
+    bool Device::isHeadless() const
+    {
+        return mHeadless;
+    }
 
-        mDevice->freeDescriptorSets(allocatedPool.descriptorPool.get(), set);
+    const std::vector<Device::StartupPhase>& Device::getStartupPhases() const
+    {
+        return mStartupPhases;
     }
 
 #if VK_HEADER_VERSION >= 301
@@ -262,31 +593,36 @@ namespace vk2s
     void Device::pickAndCreateDevice(const bool useWindow)
     {
         // HACK: create test surface
-        if (useWindow)
+        if (useWindow && !mHeadless)
         {
             VkSurfaceKHR surface;
-
-            glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
-            glfwWindowHint(GLFW_RESIZABLE, GLFW_FALSE);
-            const auto pTestWindow = glfwCreateWindow(1, 1, "surface test", nullptr, nullptr);
-            auto res               = glfwCreateWindowSurface(VkInstance(mInstance.get()), pTestWindow, nullptr, &surface);
-            if (res != VK_SUCCESS)
-            {
-                throw std::runtime_error("failed to create window surface!");
-            }
+            GLFWwindow* pTestWindow = nullptr;
+
+            measureStartupPhase(mStartupPhases, "test surface",
+                                [&]()
+                                {
+                                    glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
+                                    glfwWindowHint(GLFW_RESIZABLE, GLFW_FALSE);
+                                    pTestWindow = glfwCreateWindow(1, 1, "surface test", nullptr, nullptr);
+                                    auto res    = glfwCreateWindowSurface(VkInstance(mInstance.get()), pTestWindow, nullptr, &surface);
+                                    if (res != VK_SUCCESS)
+                                    {
+                                        throw std::runtime_error("failed to create window surface!");
+                                    }
+                                });
             const auto testSurface = vk::UniqueSurfaceKHR(surface, { mInstance.get() });
 
-            pickPhysicalDevice(testSurface);
+            measureStartupPhase(mStartupPhases, "physical device", [&]() { pickPhysicalDevice(testSurface); });
 
-            createLogicalDevice(testSurface);
+            measureStartupPhase(mStartupPhases, "logical device", [&]() { createLogicalDevice(testSurface); });
 
             glfwDestroyWindow(pTestWindow);
         }
         else
         {
-            pickPhysicalDevice(vk::UniqueSurfaceKHR());
+            measureStartupPhase(mStartupPhases, "physical device", [&]() { pickPhysicalDevice(vk::UniqueSurfaceKHR()); });
 
-            createLogicalDevice(vk::UniqueSurfaceKHR());
+            measureStartupPhase(mStartupPhases, "logical device", [&]() { createLogicalDevice(vk::UniqueSurfaceKHR()); });
         }
     }
 
@@ -316,7 +652,8 @@ namespace vk2s
         mQueueFamilyIndices = QueueFamilyIndices::findQueueFamilies(mPhysicalDevice, testSurface);
 
         std::vector<vk::DeviceQueueCreateInfo> queueCreateInfos;
-        std::set<uint32_t> uniqueQueueFamilies = { mQueueFamilyIndices.graphicsFamily.value(), mQueueFamilyIndices.presentFamily.value() };
+        std::set<uint32_t> uniqueQueueFamilies = { mQueueFamilyIndices.graphicsFamily.value(), mQueueFamilyIndices.presentFamily.value(), mQueueFamilyIndices.computeFamily.value(),
+                                                   mQueueFamilyIndices.transferFamily.value() };
 
         float queuePriority = 1.0f;
         for (uint32_t queueFamily : uniqueQueueFamilies)
@@ -349,9 +686,17 @@ namespace vk2s
 
         vk::PhysicalDeviceRobustness2FeaturesEXT robustness2Features(VK_TRUE, VK_TRUE, VK_TRUE);
 
+        // for submission tracking
+        vk::PhysicalDeviceTimelineSemaphoreFeatures timelineSemaphoreFeatures(VK_TRUE);
+        timelineSemaphoreFeatures.pNext = &robustness2Features;
+
+        // for resetting the query pools of Profiler from the host
+        vk::PhysicalDeviceHostQueryResetFeatures hostQueryResetFeatures(VK_TRUE);
+        hostQueryResetFeatures.pNext = &timelineSemaphoreFeatures;
+
         vk::PhysicalDeviceVulkan13Features vk1_3features;
         vk1_3features.maintenance4 = VK_TRUE;
-        vk1_3features.pNext        = &robustness2Features;
+        vk1_3features.pNext        = &hostQueryResetFeatures;
 
         vk::PhysicalDeviceFeatures features = mPhysicalDevice.getFeatures();
 
@@ -362,8 +707,22 @@ namespace vk2s
         std::vector<const char*> extensionNames(baseDeviceExtensions.begin(), baseDeviceExtensions.end());
         extensionNames.reserve(allDeviceExtensions.size());
 
+        if (!mHeadless)
+        {
+            extensionNames.insert(extensionNames.end(), swapchainDeviceExtensions.begin(), swapchainDeviceExtensions.end());
+        }
+
         void** ppNext = &(robustness2Features.pNext);
 
+        // optional, lets MemoryAllocator report the budget of each heap
+        const auto availableExtensions = mPhysicalDevice.enumerateDeviceExtensionProperties();
+        mMemoryBudgetEnabled           = std::any_of(availableExtensions.begin(), availableExtensions.end(),
+                                                     [](const vk::ExtensionProperties& ext) { return std::string_view(ext.extensionName.data()) == memoryBudgetExtension; });
+        if (mMemoryBudgetEnabled)
+        {
+            extensionNames.emplace_back(memoryBudgetExtension);
+        }
+
         if (mQueriedExtensions.useExternalMemoryExt)
         {
             extensionNames.resize(extensionNames.size() + externalMemoryDeviceExtensions.size());
@@ -399,36 +758,33 @@ namespace vk2s
         mDevice = mPhysicalDevice.createDeviceUnique(createInfo);
         assert(mDevice || !"failed to create logical device!");
 
+        // device-level function pointers skip the loader trampolines, they are kept per Device since the default dispatcher is process-global
+        mDispatcher.init(static_cast<VkInstance>(mInstance.get()), VULKAN_HPP_DEFAULT_DISPATCHER.vkGetInstanceProcAddr, static_cast<VkDevice>(mDevice.get()), VULKAN_HPP_DEFAULT_DISPATCHER.vkGetDeviceProcAddr);
+
         mGraphicsQueue = mDevice->getQueue(mQueueFamilyIndices.graphicsFamily.value(), 0);
         mPresentQueue  = mDevice->getQueue(mQueueFamilyIndices.presentFamily.value(), 0);
+        mComputeQueue  = mDevice->getQueue(mQueueFamilyIndices.computeFamily.value(), 0);
+        mTransferQueue = mDevice->getQueue(mQueueFamilyIndices.transferFamily.value(), 0);
     }
 
     void Device::createCommandPool()
     {
-        vk::CommandPoolCreateInfo poolInfo({}, mQueueFamilyIndices.graphicsFamily.value());
-        poolInfo.flags |= vk::CommandPoolCreateFlagBits::eResetCommandBuffer;
+        for (size_t i = 0; i < kQueueTypeNum; ++i)
+        {
+            vk::CommandPoolCreateInfo poolInfo({}, getVkQueueFamilyIndex(static_cast<QueueType>(i)));
+            poolInfo.flags |= vk::CommandPoolCreateFlagBits::eResetCommandBuffer;
 
-        mCommandPool = mDevice->createCommandPoolUnique(poolInfo);
+            mCommandPools[i] = mDevice->createCommandPoolUnique(poolInfo);
+        }
     }
 
-    void Device::createDescriptorPool()
+    void Device::createSubmissionTimeline()
     {
-        std::vector poolSize = {
-            vk::DescriptorPoolSize(vk::DescriptorType::eCombinedImageSampler, kMaxDescriptorNum), vk::DescriptorPoolSize(vk::DescriptorType::eStorageImage, kMaxDescriptorNum),
-            vk::DescriptorPoolSize(vk::DescriptorType::eStorageBuffer, kMaxDescriptorNum),        vk::DescriptorPoolSize(vk::DescriptorType::eUniformBufferDynamic, kMaxDescriptorNum),
-            vk::DescriptorPoolSize(vk::DescriptorType::eUniformBuffer, kMaxDescriptorNum),        vk::DescriptorPoolSize(vk::DescriptorType::eAccelerationStructureKHR, kMaxDescriptorNum),
-        };
-
-        if (!mQueriedExtensions.useRayTracingExt)
+        for (auto& timeline : mSubmissionTimelines)
         {
-            poolSize.pop_back();
+            vk::SemaphoreTypeCreateInfo typeInfo(vk::SemaphoreType::eTimeline, getLatestSubmissionIndex());
+            timeline = mDevice->createSemaphoreUnique(vk::SemaphoreCreateInfo({}, &typeInfo));
         }
-
-        auto& added = mDescriptorPools.emplace_back();
-
-        vk::DescriptorPoolCreateInfo ci(vk::DescriptorPoolCreateFlagBits::eFreeDescriptorSet, kMaxDescriptorNum, poolSize);
-        added.descriptorPool = mDevice->createDescriptorPoolUnique(ci);
-        added.now            = DescriptorPoolAllocationInfo(kMaxDescriptorNum);
     }
 
     // utility----------------------------------------------
@@ -485,13 +841,23 @@ namespace vk2s
 
     std::vector<const char*> Device::getRequiredExtensions()
     {
-        uint32_t glfwExtensionCount = 0;
-        const char** glfwExtensions;
-        glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
+        std::vector<const char*> extensions;
 
-        std::vector<const char*> extensions(glfwExtensions, glfwExtensions + glfwExtensionCount);
+        // headless devices need no surface extensions
+        if (!mHeadless)
+        {
+            uint32_t glfwExtensionCount = 0;
+            const char** glfwExtensions;
+            glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
 
-        if (enableValidationLayers)
+            extensions.assign(glfwExtensions, glfwExtensions + glfwExtensionCount);
+        }
+
+        // debug utils are also used for the labels of profile scopes (seen by capture tools)
+        const auto instanceExtensions = vk::enumerateInstanceExtensionProperties();
+        const bool debugUtilsSupported =
+            std::any_of(instanceExtensions.begin(), instanceExtensions.end(), [](const vk::ExtensionProperties& ext) { return std::string_view(ext.extensionName.data()) == VK_EXT_DEBUG_UTILS_EXTENSION_NAME; });
+        if (enableValidationLayers || debugUtilsSupported)
         {
             extensions.push_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
         }
@@ -539,33 +905,55 @@ namespace vk2s
         uint32_t i = 0;
         for (const auto& queueFamily : queueFamilies)
         {
-            if (queueFamily.queueFlags & vk::QueueFlagBits::eGraphics)
-            {
-                indices.graphicsFamily = i;
-            }
+            const auto flags = queueFamily.queueFlags;
 
-            if (testSurface)
+            if (!indices.isComplete())
             {
-                const auto presentSupport = physDev.getSurfaceSupportKHR(i, testSurface.get());
-                if (presentSupport)
+                if (flags & vk::QueueFlagBits::eGraphics)
+                {
+                    indices.graphicsFamily = i;
+                }
+
+                if (testSurface)
+                {
+                    const auto presentSupport = physDev.getSurfaceSupportKHR(i, testSurface.get());
+                    if (presentSupport)
+                    {
+                        indices.presentFamily = i;
+                    }
+                }
+                else
                 {
-                    indices.presentFamily = i;
+                    // don't care about presenting
+                    indices.presentFamily = indices.graphicsFamily;
                 }
             }
-            else
+
+            // dedicated families (the first one found)
+            if (!indices.computeFamily && (flags & vk::QueueFlagBits::eCompute) && !(flags & vk::QueueFlagBits::eGraphics))
             {
-                // don't care about presenting
-                indices.presentFamily = indices.graphicsFamily;
+                indices.computeFamily = i;
             }
 
-            if (indices.isComplete())
+            if (!indices.transferFamily && (flags & vk::QueueFlagBits::eTransfer) && !(flags & (vk::QueueFlagBits::eGraphics | vk::QueueFlagBits::eCompute)))
             {
-                break;
+                indices.transferFamily = i;
             }
 
             i++;
         }
 
+        // fall back to the general queues
+        if (!indices.computeFamily)
+        {
+            indices.computeFamily = indices.graphicsFamily;
+        }
+
+        if (!indices.transferFamily)
+        {
+            indices.transferFamily = indices.computeFamily;
+        }
+
         return indices;
     }
 
@@ -587,6 +975,10 @@ namespace vk2s
         std::vector<vk::ExtensionProperties> availableExtensions = mDevice.enumerateDeviceExtensionProperties();
 
         std::set<std::string> requiredExtensions(baseDeviceExtensions.begin(), baseDeviceExtensions.end());
+        if (!mHeadless)
+        {
+            requiredExtensions.insert(swapchainDeviceExtensions.begin(), swapchainDeviceExtensions.end());
+        }
 
         for (const auto& extension : availableExtensions)
         {
@@ -622,22 +1014,12 @@ namespace vk2s
 
     uint32_t Device::getVkMemoryTypeIndex(uint32_t requestBits, vk::MemoryPropertyFlags requestProps) const
     {
-        std::uint32_t result = 0;
-        for (std::uint32_t i = 0; i < mPhysMemProps.memoryTypeCount; ++i)
-        {
-            if (requestBits & 1)
-            {
-                const auto& types = mPhysMemProps.memoryTypes[i];
-                if ((types.propertyFlags & requestProps) == requestProps)
-                {
-                    result = i;
-                    break;
-                }
-            }
+        return mMemoryAllocator->findMemoryTypeIndex(requestBits, requestProps);
+    }
 
-            requestBits >>= 1;
-        }
-        return result;
+    MemoryAllocator& Device::getMemoryAllocator()
+    {
+        return *mMemoryAllocator;
     }
 
     Device::Extensions Device::getVkAvailableExtensions() const
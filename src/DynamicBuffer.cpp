@@ -22,21 +22,10 @@ namespace vk2s
 
         mBuffer = vkDevice->createBufferUnique(nbi);
 
-        // for ray tracing
-        vk::MemoryAllocateFlagsInfo allocateFlagsInfo(vk::MemoryAllocateFlagBits::eDeviceAddress);
-
-        vk::MemoryRequirements reqs = vkDevice->getBufferMemoryRequirements(mBuffer.get());
-        vk::MemoryAllocateInfo ai(reqs.size, mDevice.getVkMemoryTypeIndex(reqs.memoryTypeBits, pbs));
-        if (bi.usage & vk::BufferUsageFlagBits::eShaderDeviceAddress)
-        {
-            ai.pNext = &allocateFlagsInfo;
-        }
-
-        mMemory = vkDevice->allocateMemoryUnique(ai);
+        // sub-allocated from a shared block and bound
+        mMemory = mDevice.getMemoryAllocator().allocateForBuffer(mBuffer.get(), nbi.usage, pbs);
         mSize   = nbi.size;
         mOffset = 0;
-
-        vkDevice->bindBufferMemory(mBuffer.get(), mMemory.get(), mOffset);
     }
 
     DynamicBuffer::~DynamicBuffer()
@@ -45,12 +34,30 @@ namespace vk2s
 
     void DynamicBuffer::write(const void* pSrc, const size_t size, const size_t offset)
     {
-        const auto& vkDevice = mDevice.getVkDevice();
-
-        void* p = vkDevice->mapMemory(mMemory.get(), offset, size);
+        std::byte* p = mMemory.getMappedPointer();
         assert(p || !"failed to map memory!");
-        memcpy(p, pSrc, size);
-        vkDevice->unmapMemory(mMemory.get());
+        memcpy(p + offset, pSrc, size);
+        mMemory.flush(offset, size);
+    }
+
+    void* DynamicBuffer::getMappedPointer() const
+    {
+        return mMemory.getMappedPointer();
+    }
+
+    bool DynamicBuffer::isHostCoherent() const
+    {
+        return mMemory.isHostCoherent();
+    }
+
+    void DynamicBuffer::flush(const vk::DeviceSize offset, const vk::DeviceSize size)
+    {
+        mMemory.flush(offset, size);
+    }
+
+    void DynamicBuffer::invalidate(const vk::DeviceSize offset, const vk::DeviceSize size)
+    {
+        mMemory.invalidate(offset, size);
     }
 
     const vk::UniqueBuffer& DynamicBuffer::getVkBuffer()
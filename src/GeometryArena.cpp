@@ -0,0 +1,332 @@
+/*****************************************************************/ /**
+ * @file   GeometryArena.cpp
+ * @brief  source file of GeometryArena class
+ *
+ * @author agent
+ * @date   October 2026
+ *********************************************************************/
+#include "../include/vk2s/GeometryArena.hpp"
+
+#include "../include/vk2s/Device.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <numeric>
+#include <tuple>
+
+namespace vk2s
+{
+    vk::DeviceAddress GeometryArena::Slice::getVkDeviceAddress() const
+    {
+        return buffer->getVkDeviceAddress() + offset;
+    }
+
+    GeometryArena::GeometryArena(Device& device, const uint32_t vertexStride, const vk::DeviceSize blockSize)
+        : mDevice(device)
+        , mVertexStride(vertexStride)
+        , mBlockSize(blockSize)
+    {
+        assert(mVertexStride > 0 || !"the vertex stride must not be 0!");
+        assert(mBlockSize > 0 || !"the block size must not be 0!");
+
+        // vertex slices start at a multiple of the stride (for vertexOffset) and of 4 (for copies)
+        mVertexAlignment = std::lcm<vk::DeviceSize>(mVertexStride, 4);
+
+        mUsage = vk::BufferUsageFlagBits::eVertexBuffer | vk::BufferUsageFlagBits::eIndexBuffer | vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eTransferDst |
+                 vk::BufferUsageFlagBits::eTransferSrc;
+        if (mDevice.getVkAvailableExtensions().useRayTracingExt)
+        {
+            mUsage |= vk::BufferUsageFlagBits::eShaderDeviceAddress | vk::BufferUsageFlagBits::eAccelerationStructureBuildInputReadOnlyKHR;
+        }
+    }
+
+    GeometryArena::~GeometryArena()
+    {
+        // blocks may still be read by submissions in flight
+        for (auto& block : mBlocks)
+        {
+            mDevice.destroyDeferred(block.buffer);
+        }
+    }
+
+    GeometryArena::MeshID GeometryArena::add(const void* pVertices, const uint32_t vertexNum, const uint32_t* pIndices, const uint32_t indexNum)
+    {
+        assert((vertexNum > 0 && indexNum > 0) || !"empty mesh!");
+
+        std::lock_guard lock(mMutex);
+
+        reclaim();
+
+        Entry entry;
+        std::tie(entry.mesh.vertices, entry.vertexBlock) = allocate(vertexNum, mVertexStride, mVertexAlignment);
+        std::tie(entry.mesh.indices, entry.indexBlock)   = allocate(indexNum, sizeof(uint32_t), sizeof(uint32_t));
+
+        auto& uploader = mDevice.getUploader();
+        uploader.enqueue(entry.mesh.vertices.buffer.get(), pVertices, entry.mesh.vertices.getSize(), entry.mesh.vertices.offset);
+        uploader.enqueue(entry.mesh.indices.buffer.get(), pIndices, entry.mesh.indices.getSize(), entry.mesh.indices.offset);
+
+        MeshID id = 0;
+        if (!mFreeIDs.empty())
+        {
+            id = mFreeIDs.back();
+            mFreeIDs.pop_back();
+            mMeshes[id] = entry;
+        }
+        else
+        {
+            id = static_cast<MeshID>(mMeshes.size());
+            mMeshes.emplace_back(entry);
+        }
+
+        ++mStats.meshNum;
+        mStats.usedBytes += entry.mesh.vertices.getSize() + entry.mesh.indices.getSize();
+
+        return id;
+    }
+
+    void GeometryArena::remove(const MeshID id)
+    {
+        std::lock_guard lock(mMutex);
+
+        assert((id < mMeshes.size() && mMeshes[id]) || !"invalid mesh ID!");
+        const Entry& entry = *mMeshes[id];
+
+        // the queued uploads to the slices must be submitted before the slices can be tagged with a submission index
+        // (otherwise they could be reused while the upload is still pending), draws and BLAS builds submitted so far may still read them
+        mDevice.getUploader().submit();
+        const uint64_t submissionIndex = mDevice.getLatestSubmissionIndex();
+        mPendingFrees.emplace_back(PendingFree{ submissionIndex, entry.vertexBlock, entry.mesh.vertices.offset, entry.mesh.vertices.getSize() });
+        mPendingFrees.emplace_back(PendingFree{ submissionIndex, entry.indexBlock, entry.mesh.indices.offset, entry.mesh.indices.getSize() });
+
+        --mStats.meshNum;
+        mStats.usedBytes -= entry.mesh.vertices.getSize() + entry.mesh.indices.getSize();
+
+        mMeshes[id].reset();
+        mFreeIDs.emplace_back(id);
+    }
+
+    GeometryArena::Mesh GeometryArena::get(const MeshID id) const
+    {
+        std::lock_guard lock(mMutex);
+
+        assert((id < mMeshes.size() && mMeshes[id]) || !"invalid mesh ID!");
+        return mMeshes[id]->mesh;
+    }
+
+    bool GeometryArena::compact(const float threshold)
+    {
+        std::lock_guard lock(mMutex);
+
+        if (mStats.reservedBytes == 0 || static_cast<float>(mStats.reservedBytes - mStats.usedBytes) / mStats.reservedBytes <= threshold)
+        {
+            return false;
+        }
+
+        // the copies must see the uploads to the old blocks (submitted to the same queue before)
+        mDevice.getUploader().submit();
+
+        // pack every live slice into new blocks in ID order
+        struct Move
+        {
+            Slice* pSlice;
+            uint32_t* pBlock;
+            vk::DeviceSize alignment;
+        };
+        std::vector<Move> moves;
+        for (auto& entry : mMeshes)
+        {
+            if (entry)
+            {
+                moves.emplace_back(Move{ &entry->mesh.vertices, &entry->vertexBlock, mVertexAlignment });
+                moves.emplace_back(Move{ &entry->mesh.indices, &entry->indexBlock, sizeof(uint32_t) });
+            }
+        }
+
+        std::vector<vk::DeviceSize> newSizes;
+        std::vector<vk::DeviceSize> newHeads;
+        std::vector<std::pair<uint32_t, vk::DeviceSize>> placements;  // (new block, new offset) for each move
+        placements.reserve(moves.size());
+        for (const auto& move : moves)
+        {
+            const vk::DeviceSize size = move.pSlice->getSize();
+            if (size > mBlockSize)
+            {
+                // oversized slices keep a dedicated block
+                placements.emplace_back(static_cast<uint32_t>(newSizes.size()), 0);
+                newSizes.emplace_back(size);
+                newHeads.emplace_back(size);
+                continue;
+            }
+
+            // first fit in the regular blocks
+            bool placed = false;
+            for (size_t i = 0; i < newSizes.size() && !placed; ++i)
+            {
+                const vk::DeviceSize begin = (newHeads[i] + move.alignment - 1) / move.alignment * move.alignment;
+                if (newSizes[i] == mBlockSize && begin + size <= newSizes[i])
+                {
+                    placements.emplace_back(static_cast<uint32_t>(i), begin);
+                    newHeads[i] = begin + size;
+                    placed      = true;
+                }
+            }
+
+            if (!placed)
+            {
+                placements.emplace_back(static_cast<uint32_t>(newSizes.size()), 0);
+                newSizes.emplace_back(mBlockSize);
+                newHeads.emplace_back(size);
+            }
+        }
+
+        std::vector<Block> newBlocks(newSizes.size());
+        for (size_t i = 0; i < newBlocks.size(); ++i)
+        {
+            newBlocks[i].buffer = mDevice.create<Buffer>(vk::BufferCreateInfo({}, newSizes[i], mUsage), vk::MemoryPropertyFlagBits::eDeviceLocal);
+            newBlocks[i].size   = newSizes[i];
+            if (newHeads[i] < newSizes[i])
+            {
+                newBlocks[i].freeRanges.emplace(newHeads[i], newSizes[i] - newHeads[i]);
+            }
+        }
+
+        // record every copy in a single command
+        Handle<Command> command = mDevice.create<Command>(QueueType::eGraphics);
+        command->begin(true);
+        const vk::CommandBuffer commandBuffer = command->getVkCommandBuffer().get();
+        const auto& dispatcher                = mDevice.getVkDispatcher();
+
+        const vk::MemoryBarrier toCopy(vk::AccessFlagBits::eMemoryWrite, vk::AccessFlagBits::eTransferRead);
+        commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eAllCommands, vk::PipelineStageFlagBits::eTransfer, {}, toCopy, {}, {}, dispatcher);
+
+        for (size_t i = 0; i < moves.size(); ++i)
+        {
+            Slice& slice                     = *moves[i].pSlice;
+            const auto [newBlock, newOffset] = placements[i];
+
+            const vk::BufferCopy region(slice.offset, newOffset, slice.getSize());
+            commandBuffer.copyBuffer(mBlocks[*moves[i].pBlock].buffer->getVkBuffer().get(), newBlocks[newBlock].buffer->getVkBuffer().get(), region, dispatcher);
+
+            slice.buffer      = newBlocks[newBlock].buffer;
+            slice.offset      = newOffset;
+            *moves[i].pBlock  = newBlock;
+        }
+
+        const vk::MemoryBarrier toUse(vk::AccessFlagBits::eTransferWrite, vk::AccessFlagBits::eMemoryRead);
+        commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eAllCommands, {}, toUse, {}, {}, dispatcher);
+
+        command->end();
+        command->execute();
+
+        // the old blocks (including the ranges waiting in mPendingFrees) are released after the copies retire
+        mDevice.destroyDeferred(command);
+        for (auto& block : mBlocks)
+        {
+            mDevice.destroyDeferred(block.buffer);
+        }
+        mPendingFrees.clear();
+
+        mBlocks              = std::move(newBlocks);
+        mStats.blockNum      = mBlocks.size();
+        mStats.reservedBytes = std::accumulate(newSizes.begin(), newSizes.end(), vk::DeviceSize(0));
+        ++mStats.compactionNum;
+
+        return true;
+    }
+
+    GeometryArena::Statistics GeometryArena::getStatistics() const
+    {
+        std::lock_guard lock(mMutex);
+        return mStats;
+    }
+
+    std::pair<GeometryArena::Slice, uint32_t> GeometryArena::allocate(const uint32_t count, const uint32_t stride, const vk::DeviceSize alignment)
+    {
+        const vk::DeviceSize size = static_cast<vk::DeviceSize>(count) * stride;
+
+        // first fit
+        for (uint32_t i = 0; i < mBlocks.size(); ++i)
+        {
+            auto& freeRanges = mBlocks[i].freeRanges;
+            for (auto iter = freeRanges.begin(); iter != freeRanges.end(); ++iter)
+            {
+                const auto [rangeOffset, rangeSize] = *iter;
+                const vk::DeviceSize begin          = (rangeOffset + alignment - 1) / alignment * alignment;
+                if (begin + size > rangeOffset + rangeSize)
+                {
+                    continue;
+                }
+
+                freeRanges.erase(iter);
+                if (begin > rangeOffset)
+                {
+                    freeRanges.emplace(rangeOffset, begin - rangeOffset);
+                }
+                if (begin + size < rangeOffset + rangeSize)
+                {
+                    freeRanges.emplace(begin + size, rangeOffset + rangeSize - begin - size);
+                }
+
+                return { Slice{ mBlocks[i].buffer, begin, count, stride }, i };
+            }
+        }
+
+        // no room, meshes larger than the block size get a dedicated block
+        const uint32_t blockIndex = addBlock(std::max(mBlockSize, size));
+        auto& block               = mBlocks[blockIndex];
+        block.freeRanges.clear();
+        if (size < block.size)
+        {
+            block.freeRanges.emplace(size, block.size - size);
+        }
+
+        return { Slice{ block.buffer, 0, count, stride }, blockIndex };
+    }
+
+    uint32_t GeometryArena::addBlock(const vk::DeviceSize size)
+    {
+        auto& block  = mBlocks.emplace_back();
+        block.buffer = mDevice.create<Buffer>(vk::BufferCreateInfo({}, size, mUsage), vk::MemoryPropertyFlagBits::eDeviceLocal);
+        block.size   = size;
+        block.freeRanges.emplace(0, size);
+
+        ++mStats.blockNum;
+        mStats.reservedBytes += size;
+
+        return static_cast<uint32_t>(mBlocks.size() - 1);
+    }
+
+    void GeometryArena::freeRange(const uint32_t blockIndex, const vk::DeviceSize offset, const vk::DeviceSize size)
+    {
+        auto& freeRanges = mBlocks[blockIndex].freeRanges;
+        auto iter        = freeRanges.emplace(offset, size).first;
+
+        // coalesce with the next range
+        if (auto next = std::next(iter); next != freeRanges.end() && iter->first + iter->second == next->first)
+        {
+            iter->second += next->second;
+            freeRanges.erase(next);
+        }
+
+        // coalesce with the previous range
+        if (iter != freeRanges.begin())
+        {
+            if (auto prev = std::prev(iter); prev->first + prev->second == iter->first)
+            {
+                prev->second += iter->second;
+                freeRanges.erase(iter);
+            }
+        }
+    }
+
+    void GeometryArena::reclaim()
+    {
+        const uint64_t completed = mDevice.getCompletedSubmissionIndex();
+        while (!mPendingFrees.empty() && mPendingFrees.front().submissionIndex <= completed)
+        {
+            const auto& pending = mPendingFrees.front();
+            freeRange(pending.blockIndex, pending.offset, pending.size);
+            mPendingFrees.pop_front();
+        }
+    }
+}  // namespace vk2s
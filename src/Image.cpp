@@ -11,6 +11,9 @@
 
 #include <stb_image.h>
 
+#include <algorithm>
+#include <cmath>
+
 namespace vk2s
 {
 
@@ -19,12 +22,8 @@ namespace vk2s
     {
         const auto& vkDevice                       = mDevice.getVkDevice();
 
-        mImage                      = vkDevice->createImageUnique(ii);
-        vk::MemoryRequirements reqs = vkDevice->getImageMemoryRequirements(mImage.get());
-        vk::MemoryAllocateInfo ai(reqs.size, mDevice.getVkMemoryTypeIndex(reqs.memoryTypeBits, pbs));
-        mMemory = vkDevice->allocateMemoryUnique(ai);
-
-        vkDevice->bindImageMemory(mImage.get(), mMemory.get(), 0);
+        mImage  = vkDevice->createImageUnique(ii);
+        mMemory = mDevice.getMemoryAllocator().allocateForImage(mImage.get(), ii.tiling, pbs);
         
         vk::ImageViewCreateInfo viewInfo;
         viewInfo.image            = mImage.get();
@@ -32,7 +31,7 @@ namespace vk2s
         viewInfo.format           = ii.format;
         viewInfo.subresourceRange.aspectMask     = aspectFlags;
         viewInfo.subresourceRange.baseMipLevel   = 0;
-        viewInfo.subresourceRange.levelCount     = 1;
+        viewInfo.subresourceRange.levelCount     = ii.mipLevels;
         viewInfo.subresourceRange.baseArrayLayer = 0;
         viewInfo.subresourceRange.layerCount     = 1;
 
@@ -40,8 +39,10 @@ namespace vk2s
 
         mFormat = ii.format;
 
-        mExtent     = ii.extent;
-        mAspectFlag = aspectFlags;
+        mExtent      = ii.extent;
+        mAspectFlag  = aspectFlags;
+        mMipLevels   = ii.mipLevels;
+        mArrayLayers = ii.arrayLayers;
     }
 
     Image::Image(Device& device, const vk::ImageCreateInfo& ii, const vk::MemoryPropertyFlags pbs, const size_t size, const vk::ImageViewType viewType, const vk::ImageSubresourceRange subresourceRange)
@@ -49,12 +50,8 @@ namespace vk2s
     {
         const auto& vkDevice = mDevice.getVkDevice();
 
-        mImage                      = vkDevice->createImageUnique(ii);
-        vk::MemoryRequirements reqs = vkDevice->getImageMemoryRequirements(mImage.get());
-        vk::MemoryAllocateInfo ai(reqs.size, mDevice.getVkMemoryTypeIndex(reqs.memoryTypeBits, pbs));
-        mMemory = vkDevice->allocateMemoryUnique(ai);
-
-        vkDevice->bindImageMemory(mImage.get(), mMemory.get(), 0);
+        mImage  = vkDevice->createImageUnique(ii);
+        mMemory = mDevice.getMemoryAllocator().allocateForImage(mImage.get(), ii.tiling, pbs);
 
         vk::ImageViewCreateInfo viewInfo;
         viewInfo.image            = mImage.get();
@@ -66,8 +63,10 @@ namespace vk2s
 
         mFormat = ii.format;
 
-        mExtent     = ii.extent;
-        mAspectFlag = subresourceRange.aspectMask;
+        mExtent      = ii.extent;
+        mAspectFlag  = subresourceRange.aspectMask;
+        mMipLevels   = ii.mipLevels;
+        mArrayLayers = ii.arrayLayers;
     }
 
     Image::Image(Device& device, std::string_view path)
@@ -81,22 +80,22 @@ namespace vk2s
         // allocate in RGBA (not actual bpp) to match the format on the GPU side
         const auto size = width * height * static_cast<size_t>(STBI_rgb_alpha);
 
+        // the full mip chain is generated by linear blits (sRGB decoded before filtering) if the format supports them
+        const auto features        = mDevice.getVkPhysicalDevice().getFormatProperties(vk::Format::eR8G8B8A8Srgb).optimalTilingFeatures;
+        const auto blitFeatures    = vk::FormatFeatureFlagBits::eBlitSrc | vk::FormatFeatureFlagBits::eBlitDst | vk::FormatFeatureFlagBits::eSampledImageFilterLinear;
+        const bool generateMipmaps = (features & blitFeatures) == blitFeatures;
+
         vk::ImageCreateInfo ii;
         ii.arrayLayers   = 1;
         ii.extent        = vk::Extent3D(width, height, 1);
         ii.format        = vk::Format::eR8G8B8A8Srgb;
         ii.imageType     = vk::ImageType::e2D;
-        ii.mipLevels     = 1;
-        ii.usage         = vk::ImageUsageFlagBits::eSampled | vk::ImageUsageFlagBits::eTransferDst;
+        ii.mipLevels     = generateMipmaps ? calcMipLevels(width, height) : 1;
+        ii.usage         = vk::ImageUsageFlagBits::eSampled | vk::ImageUsageFlagBits::eTransferDst | vk::ImageUsageFlagBits::eTransferSrc;
         ii.initialLayout = vk::ImageLayout::eUndefined;
 
-        mImage                      = vkDevice->createImageUnique(ii);
-        vk::MemoryRequirements reqs = vkDevice->getImageMemoryRequirements(mImage.get());
-        const auto pbs              = vk::MemoryPropertyFlagBits::eDeviceLocal;
-        vk::MemoryAllocateInfo ai(reqs.size, mDevice.getVkMemoryTypeIndex(reqs.memoryTypeBits, pbs));
-        mMemory = vkDevice->allocateMemoryUnique(ai);
-
-        vkDevice->bindImageMemory(mImage.get(), mMemory.get(), 0);
+        mImage  = vkDevice->createImageUnique(ii);
+        mMemory = mDevice.getMemoryAllocator().allocateForImage(mImage.get(), ii.tiling, vk::MemoryPropertyFlagBits::eDeviceLocal);
 
         vk::ImageViewCreateInfo viewInfo;
         viewInfo.image                           = mImage.get();
@@ -104,15 +103,17 @@ namespace vk2s
         viewInfo.format                          = ii.format;
         viewInfo.subresourceRange.aspectMask     = vk::ImageAspectFlagBits::eColor;
         viewInfo.subresourceRange.baseMipLevel   = 0;
-        viewInfo.subresourceRange.levelCount     = 1;
+        viewInfo.subresourceRange.levelCount     = ii.mipLevels;
         viewInfo.subresourceRange.baseArrayLayer = 0;
         viewInfo.subresourceRange.layerCount     = 1;
 
         mImageView = vkDevice->createImageViewUnique(viewInfo);
 
-        mExtent     = ii.extent;
-        mFormat     = ii.format;
-        mAspectFlag = vk::ImageAspectFlagBits::eColor;
+        mExtent      = ii.extent;
+        mFormat      = ii.format;
+        mAspectFlag  = vk::ImageAspectFlagBits::eColor;
+        mMipLevels   = ii.mipLevels;
+        mArrayLayers = ii.arrayLayers;
 
         write(pData, size);
         stbi_image_free(pData);
@@ -124,40 +125,42 @@ namespace vk2s
 
     void Image::write(const void* pSrc, const size_t size)
     {
-        vk::BufferCreateInfo bi({}, size, vk::BufferUsageFlagBits::eTransferSrc);
-        vk::MemoryPropertyFlags fb(vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
-        UniqueHandle<Buffer> stagingBuffer = mDevice.create<Buffer>(bi, fb);
-        stagingBuffer->write(pSrc, size);
-
-        {  // transfer
-            UniqueHandle<Command> command = mDevice.create<Command>();
-
-            command->begin(true);
-            command->transitionImageLayout(*this, vk::ImageLayout::eUndefined, vk::ImageLayout::eTransferDstOptimal);
-            command->copyBufferToImage(stagingBuffer.get(), *this, mExtent.width, mExtent.height);
-            command->transitionImageLayout(*this, vk::ImageLayout::eTransferDstOptimal, vk::ImageLayout::eShaderReadOnlyOptimal);
-            command->end();
-
-            command->execute();
+        mDevice.waitSubmission(writeAsync(pSrc, size));
+    }
 
-            mDevice.getVkDevice()->waitIdle();
-        }
+    uint64_t Image::writeAsync(const void* pSrc, const size_t size)
+    {
+        // staged in the ring of the uploader, visible to every later submission on the graphics queue
+        auto& uploader = mDevice.getUploader();
+        uploader.enqueue(*this, pSrc, size);
+        return uploader.submit();
     }
 
     void Image::loadFromFile(std::string_view path)
     {
         int width = 0, height = 0, bpp = 0;
         void* pData = reinterpret_cast<void*>(stbi_load(path.data(), &width, &height, &bpp, STBI_rgb_alpha));
-        write(pData, static_cast<size_t>(width * height * bpp));
+        // STBI_rgb_alpha always returns 4 channels, bpp is the channel count of the file
+        write(pData, static_cast<size_t>(width) * height * STBI_rgb_alpha);
         stbi_image_free(pData);
     }
 
+    uint32_t Image::calcMipLevels(const uint32_t width, const uint32_t height)
+    {
+        return static_cast<uint32_t>(std::floor(std::log2(std::max(std::max(width, height), 1u)))) + 1;
+    }
+
     const vk::UniqueImage& Image::getVkImage()
     {
         return mImage;
     }
 
-    const vk::UniqueDeviceMemory& Image::getVkDeviceMemory()
+    vk::DeviceMemory Image::getVkDeviceMemory() const
+    {
+        return mMemory.getVkDeviceMemory();
+    }
+
+    const MemoryAllocation& Image::getMemoryAllocation() const
     {
         return mMemory;
     }
@@ -182,4 +185,19 @@ namespace vk2s
         return mAspectFlag;
     }
 
+    uint32_t Image::getMipLevels() const
+    {
+        return mMipLevels;
+    }
+
+    uint32_t Image::getArrayLayers() const
+    {
+        return mArrayLayers;
+    }
+
+    vk::ImageSubresourceRange Image::getVkSubresourceRange() const
+    {
+        return vk::ImageSubresourceRange(mAspectFlag, 0, mMipLevels, 0, mArrayLayers);
+    }
+
 }  // namespace vk2s
\ No newline at end of file
@@ -0,0 +1,908 @@
+/*****************************************************************/ /**
+ * @file   MemoryAllocator.cpp
+ * @brief  source file of MemoryAllocator class
+ *
+ * @author agent
+ * @date   October 2026
+ *********************************************************************/
+#include "../include/vk2s/MemoryAllocator.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+
+namespace vk2s
+{
+    namespace
+    {
+        /**
+         * @brief  two-level segregated fit allocator of ranges in [0, size)
+         * @detail O(1) allocation and release, adjacent free ranges are always merged
+         */
+        class TLSF
+        {
+        public:
+            //! index indicating no node
+            constexpr static uint32_t kNullNode = 0xFFFFFFFF;
+
+            explicit TLSF(const vk::DeviceSize size)
+                : mUsedSize(0)
+                , mFLBitmap(0)
+                , mSLBitmaps{}
+            {
+                mHeads.fill(kNullNode);
+                const uint32_t node = createNode(0, size);
+                insertFree(node);
+            }
+
+            /**
+             * @brief  allocate a range (returns kNullNode if no free range fits)
+             */
+            uint32_t allocate(const vk::DeviceSize size, const vk::DeviceSize alignment)
+            {
+                // the head of the first list whose ranges are all >= size might fit even with the alignment padding
+                uint32_t node = findFree(size);
+                if (node == kNullNode || !fits(node, size, alignment))
+                {
+                    node = alignment > 1 ? findFree(size + alignment - 1) : kNullNode;
+                    if (node == kNullNode || !fits(node, size, alignment))
+                    {
+                        return kNullNode;
+                    }
+                }
+
+                removeFree(node);
+
+                // split off the alignment padding as a free range
+                const vk::DeviceSize padding = alignUp(mNodes[node].offset, alignment) - mNodes[node].offset;
+                if (padding > 0)
+                {
+                    const uint32_t pad = createNode(mNodes[node].offset, padding);
+                    linkBefore(pad, node);
+                    mNodes[node].offset += padding;
+                    mNodes[node].size -= padding;
+                    insertFree(pad);
+                }
+
+                // split off the rest as a free range
+                if (mNodes[node].size - size >= kMinSplitSize)
+                {
+                    const uint32_t rest = createNode(mNodes[node].offset + size, mNodes[node].size - size);
+                    linkAfter(rest, node);
+                    mNodes[node].size = size;
+                    insertFree(rest);
+                }
+
+                mNodes[node].free = false;
+                mUsedSize += mNodes[node].size;
+
+                return node;
+            }
+
+            /**
+             * @brief  release the range and merge it with the adjacent free ranges
+             */
+            void free(uint32_t node)
+            {
+                assert(!mNodes[node].free || !"double free!");
+                mUsedSize -= mNodes[node].size;
+                mNodes[node].free = true;
+
+                if (const uint32_t next = mNodes[node].nextPhys; next != kNullNode && mNodes[next].free)
+                {
+                    removeFree(next);
+                    mNodes[node].size += mNodes[next].size;
+                    unlink(next);
+                    destroyNode(next);
+                }
+
+                if (const uint32_t prev = mNodes[node].prevPhys; prev != kNullNode && mNodes[prev].free)
+                {
+                    removeFree(prev);
+                    mNodes[prev].size += mNodes[node].size;
+                    unlink(node);
+                    destroyNode(node);
+                    node = prev;
+                }
+
+                insertFree(node);
+            }
+
+            vk::DeviceSize getOffset(const uint32_t node) const
+            {
+                return mNodes[node].offset;
+            }
+
+            vk::DeviceSize getSize(const uint32_t node) const
+            {
+                return mNodes[node].size;
+            }
+
+            vk::DeviceSize getUsedSize() const
+            {
+                return mUsedSize;
+            }
+
+        private:
+            //! log2 of the number of second level lists
+            constexpr static uint32_t kSLShift = 5;
+            //! number of second level lists
+            constexpr static uint32_t kSLCount = 1u << kSLShift;
+            //! log2 of the size below which ranges are linearly segregated in the first list
+            constexpr static uint32_t kSmallShift = 8;
+            //! number of first level lists
+            constexpr static uint32_t kFLCount = 64 - kSmallShift + 1;
+            //! free ranges smaller than this are not split off (left in the allocated range)
+            constexpr static vk::DeviceSize kMinSplitSize = 16;
+
+            struct Node
+            {
+                vk::DeviceSize offset;
+                vk::DeviceSize size;
+                uint32_t prevPhys;
+                uint32_t nextPhys;
+                uint32_t prevFree;
+                uint32_t nextFree;
+                bool free;
+            };
+
+            static vk::DeviceSize alignUp(const vk::DeviceSize value, const vk::DeviceSize alignment)
+            {
+                return (value + alignment - 1) / alignment * alignment;
+            }
+
+            static void mapping(const vk::DeviceSize size, uint32_t& fl, uint32_t& sl)
+            {
+                if (size < (vk::DeviceSize(1) << kSmallShift))
+                {
+                    fl = 0;
+                    sl = static_cast<uint32_t>(size >> (kSmallShift - kSLShift));
+                }
+                else
+                {
+                    const uint32_t f = static_cast<uint32_t>(std::bit_width(size)) - 1;
+                    fl               = f - kSmallShift + 1;
+                    sl               = static_cast<uint32_t>(size >> (f - kSLShift)) & (kSLCount - 1);
+                }
+            }
+
+            bool fits(const uint32_t node, const vk::DeviceSize size, const vk::DeviceSize alignment) const
+            {
+                const auto& n = mNodes[node];
+                return alignUp(n.offset, alignment) + size <= n.offset + n.size;
+            }
+
+            uint32_t findFree(vk::DeviceSize size) const
+            {
+                // round up to the next list so that every range in the found list is >= size
+                if (size >= (vk::DeviceSize(1) << kSmallShift))
+                {
+                    size += (vk::DeviceSize(1) << (std::bit_width(size) - 1 - kSLShift)) - 1;
+                }
+                else
+                {
+                    size += (vk::DeviceSize(1) << (kSmallShift - kSLShift)) - 1;
+                }
+
+                uint32_t fl = 0, sl = 0;
+                mapping(size, fl, sl);
+                if (fl >= kFLCount)
+                {
+                    return kNullNode;
+                }
+
+                uint32_t slMap = mSLBitmaps[fl] & (~0u << sl);
+                if (slMap == 0)
+                {
+                    const uint64_t flMap = fl + 1 < 64 ? mFLBitmap & (~uint64_t(0) << (fl + 1)) : 0;
+                    if (flMap == 0)
+                    {
+                        return kNullNode;
+                    }
+
+                    fl    = static_cast<uint32_t>(std::countr_zero(flMap));
+                    slMap = mSLBitmaps[fl];
+                }
+
+                return mHeads[fl * kSLCount + std::countr_zero(slMap)];
+            }
+
+            void insertFree(const uint32_t node)
+            {
+                uint32_t fl = 0, sl = 0;
+                mapping(mNodes[node].size, fl, sl);
+
+                uint32_t& head          = mHeads[fl * kSLCount + sl];
+                mNodes[node].free       = true;
+                mNodes[node].prevFree   = kNullNode;
+                mNodes[node].nextFree   = head;
+                if (head != kNullNode)
+                {
+                    mNodes[head].prevFree = node;
+                }
+                head = node;
+
+                mFLBitmap |= uint64_t(1) << fl;
+                mSLBitmaps[fl] |= 1u << sl;
+            }
+
+            void removeFree(const uint32_t node)
+            {
+                uint32_t fl = 0, sl = 0;
+                mapping(mNodes[node].size, fl, sl);
+
+                const auto& n = mNodes[node];
+                if (n.prevFree != kNullNode)
+                {
+                    mNodes[n.prevFree].nextFree = n.nextFree;
+                }
+                else
+                {
+                    mHeads[fl * kSLCount + sl] = n.nextFree;
+                }
+                if (n.nextFree != kNullNode)
+                {
+                    mNodes[n.nextFree].prevFree = n.prevFree;
+                }
+
+                if (mHeads[fl * kSLCount + sl] == kNullNode)
+                {
+                    mSLBitmaps[fl] &= ~(1u << sl);
+                    if (mSLBitmaps[fl] == 0)
+                    {
+                        mFLBitmap &= ~(uint64_t(1) << fl);
+                    }
+                }
+            }
+
+            uint32_t createNode(const vk::DeviceSize offset, const vk::DeviceSize size)
+            {
+                const Node node{ offset, size, kNullNode, kNullNode, kNullNode, kNullNode, true };
+                if (!mUnusedNodes.empty())
+                {
+                    const uint32_t index = mUnusedNodes.back();
+                    mUnusedNodes.pop_back();
+                    mNodes[index] = node;
+                    return index;
+                }
+
+                mNodes.emplace_back(node);
+                return static_cast<uint32_t>(mNodes.size() - 1);
+            }
+
+            void destroyNode(const uint32_t node)
+            {
+                mUnusedNodes.emplace_back(node);
+            }
+
+            void linkBefore(const uint32_t node, const uint32_t target)
+            {
+                mNodes[node].prevPhys = mNodes[target].prevPhys;
+                mNodes[node].nextPhys = target;
+                if (mNodes[target].prevPhys != kNullNode)
+                {
+                    mNodes[mNodes[target].prevPhys].nextPhys = node;
+                }
+                mNodes[target].prevPhys = node;
+            }
+
+            void linkAfter(const uint32_t node, const uint32_t target)
+            {
+                mNodes[node].nextPhys = mNodes[target].nextPhys;
+                mNodes[node].prevPhys = target;
+                if (mNodes[target].nextPhys != kNullNode)
+                {
+                    mNodes[mNodes[target].nextPhys].prevPhys = node;
+                }
+                mNodes[target].nextPhys = node;
+            }
+
+            void unlink(const uint32_t node)
+            {
+                const auto& n = mNodes[node];
+                if (n.prevPhys != kNullNode)
+                {
+                    mNodes[n.prevPhys].nextPhys = n.nextPhys;
+                }
+                if (n.nextPhys != kNullNode)
+                {
+                    mNodes[n.nextPhys].prevPhys = n.prevPhys;
+                }
+            }
+
+            //! nodes (ranges) of the block
+            std::vector<Node> mNodes;
+            //! indices of the destroyed nodes to be reused
+            std::vector<uint32_t> mUnusedNodes;
+            //! bytes of the allocated ranges
+            vk::DeviceSize mUsedSize;
+            //! bit i is set if the first level list i has a free range
+            uint64_t mFLBitmap;
+            //! bit j of [i] is set if the list (i, j) has a free range
+            std::array<uint32_t, kFLCount> mSLBitmaps;
+            //! head of the free list of each (first level, second level)
+            std::array<uint32_t, kFLCount * kSLCount> mHeads;
+        };
+    }  // namespace
+
+    /**
+     * @brief  block of device memory managed by TLSF
+     */
+    struct MemoryAllocator::Block
+    {
+        Block(vk::DeviceMemory memory, std::byte* pMapped, const vk::DeviceSize size)
+            : memory(memory)
+            , pMapped(pMapped)
+            , size(size)
+            , tlsf(size)
+        {
+        }
+
+        //! vulkan device memory of the whole block
+        vk::DeviceMemory memory;
+        //! persistently mapped pointer to the block (nullptr if not host visible)
+        std::byte* pMapped;
+        //! byte size of the block
+        vk::DeviceSize size;
+        //! allocator of ranges in the block
+        TLSF tlsf;
+    };
+
+    MemoryAllocation::MemoryAllocation()
+        : mpAllocator(nullptr)
+        , mMemory(nullptr)
+        , mOffset(0)
+        , mSize(0)
+        , mpMapped(nullptr)
+        , mNonCoherent(false)
+        , mMemoryTypeIndex(0)
+        , mListIndex(0)
+        , mpBlock(nullptr)
+        , mNodeIndex(0)
+    {
+    }
+
+    MemoryAllocation::~MemoryAllocation()
+    {
+        release();
+    }
+
+    MemoryAllocation::MemoryAllocation(MemoryAllocation&& other) noexcept
+        : MemoryAllocation()
+    {
+        *this = std::move(other);
+    }
+
+    MemoryAllocation& MemoryAllocation::operator=(MemoryAllocation&& other) noexcept
+    {
+        if (this != &other)
+        {
+            release();
+
+            mpAllocator      = other.mpAllocator;
+            mMemory          = other.mMemory;
+            mOffset          = other.mOffset;
+            mSize            = other.mSize;
+            mpMapped         = other.mpMapped;
+            mNonCoherent     = other.mNonCoherent;
+            mMemoryTypeIndex = other.mMemoryTypeIndex;
+            mListIndex       = other.mListIndex;
+            mpBlock          = other.mpBlock;
+            mNodeIndex       = other.mNodeIndex;
+
+            other.mpAllocator = nullptr;
+            other.mMemory     = nullptr;
+            other.mpMapped    = nullptr;
+            other.mpBlock     = nullptr;
+        }
+
+        return *this;
+    }
+
+    void MemoryAllocation::release()
+    {
+        if (mpAllocator)
+        {
+            mpAllocator->free(*this);
+            mpAllocator = nullptr;
+            mMemory     = nullptr;
+            mpMapped    = nullptr;
+            mpBlock     = nullptr;
+        }
+    }
+
+    vk::DeviceMemory MemoryAllocation::getVkDeviceMemory() const
+    {
+        return mMemory;
+    }
+
+    vk::DeviceSize MemoryAllocation::getOffset() const
+    {
+        return mOffset;
+    }
+
+    vk::DeviceSize MemoryAllocation::getSize() const
+    {
+        return mSize;
+    }
+
+    uint32_t MemoryAllocation::getMemoryTypeIndex() const
+    {
+        return mMemoryTypeIndex;
+    }
+
+    std::byte* MemoryAllocation::getMappedPointer() const
+    {
+        return mpMapped;
+    }
+
+    bool MemoryAllocation::isHostCoherent() const
+    {
+        return !mNonCoherent;
+    }
+
+    void MemoryAllocation::flush(const vk::DeviceSize offset, const vk::DeviceSize size) const
+    {
+        if (mNonCoherent)
+        {
+            mpAllocator->mDevice.flushMappedMemoryRanges(mpAllocator->getMappedRange(*this, offset, size));
+        }
+    }
+
+    void MemoryAllocation::invalidate(const vk::DeviceSize offset, const vk::DeviceSize size) const
+    {
+        if (mNonCoherent)
+        {
+            mpAllocator->mDevice.invalidateMappedMemoryRanges(mpAllocator->getMappedRange(*this, offset, size));
+        }
+    }
+
+    bool MemoryAllocation::isDedicated() const
+    {
+        return mpAllocator && !mpBlock;
+    }
+
+    MemoryAllocation::operator bool() const noexcept
+    {
+        return mpAllocator != nullptr;
+    }
+
+    MemoryAllocator::MemoryAllocator(vk::PhysicalDevice physicalDevice, vk::Device device, const bool useDeviceAddress, const bool useMemoryBudget, const vk::DeviceSize blockSize)
+        : mPhysicalDevice(physicalDevice)
+        , mDevice(device)
+        , mMemProps(physicalDevice.getMemoryProperties())
+        , mDeviceAddressAlignment(1)
+        , mUseDeviceAddress(useDeviceAddress)
+        , mUseMemoryBudget(useMemoryBudget)
+        , mBlockSize(blockSize)
+        , mDedicatedThreshold(blockSize / 2)
+        , mTypePolicy(TypePolicy::eFirstMatch)
+        , mBlockNum(0)
+        , mDedicatedAllocationNum(0)
+        , mAllocationNum(0)
+        , mReservedBytes(0)
+        , mUsedBytes(0)
+    {
+        for (auto& counter : mTypeCounters)
+        {
+            counter.allocationNum.store(0, std::memory_order_relaxed);
+            counter.reservedBytes.store(0, std::memory_order_relaxed);
+            counter.usedBytes.store(0, std::memory_order_relaxed);
+        }
+
+        const auto limits       = physicalDevice.getProperties().limits;
+        mBufferImageGranularity = limits.bufferImageGranularity;
+        mNonCoherentAtomSize    = limits.nonCoherentAtomSize;
+
+        // device address is used with ray tracing, whose scratch buffers must be aligned to minAccelerationStructureScratchOffsetAlignment
+        if (mUseDeviceAddress)
+        {
+            const auto props        = physicalDevice.getProperties2<vk::PhysicalDeviceProperties2, vk::PhysicalDeviceAccelerationStructurePropertiesKHR>();
+            mDeviceAddressAlignment = std::max<vk::DeviceSize>(1, props.get<vk::PhysicalDeviceAccelerationStructurePropertiesKHR>().minAccelerationStructureScratchOffsetAlignment);
+        }
+    }
+
+    MemoryAllocator::~MemoryAllocator()
+    {
+        for (auto& list : mBlockLists)
+        {
+            for (auto& pBlock : list.blocks)
+            {
+                assert(pBlock->tlsf.getUsedSize() == 0 || !"device memory is still in use!");
+                mDevice.freeMemory(pBlock->memory);
+            }
+        }
+    }
+
+    MemoryAllocation MemoryAllocator::allocateForBuffer(vk::Buffer buffer, const vk::BufferUsageFlags usage, const vk::MemoryPropertyFlags requiredProps)
+    {
+        const auto reqs2 = mDevice.getBufferMemoryRequirements2<vk::MemoryRequirements2, vk::MemoryDedicatedRequirements>(vk::BufferMemoryRequirementsInfo2(buffer));
+
+        auto reqs                 = reqs2.get<vk::MemoryRequirements2>().memoryRequirements;
+        const auto& dedicatedReqs = reqs2.get<vk::MemoryDedicatedRequirements>();
+        if (usage & vk::BufferUsageFlagBits::eShaderDeviceAddress)
+        {
+            reqs.alignment = std::max(reqs.alignment, mDeviceAddressAlignment);
+        }
+
+        const bool dedicated = dedicatedReqs.requiresDedicatedAllocation || dedicatedReqs.prefersDedicatedAllocation || reqs.size >= mDedicatedThreshold.load(std::memory_order_relaxed);
+
+        MemoryAllocation allocation = allocate(reqs, requiredProps, false, dedicated, vk::MemoryDedicatedAllocateInfo({}, buffer));
+        mDevice.bindBufferMemory(buffer, allocation.getVkDeviceMemory(), allocation.getOffset());
+
+        return allocation;
+    }
+
+    MemoryAllocation MemoryAllocator::allocateForImage(vk::Image image, const vk::ImageTiling tiling, const vk::MemoryPropertyFlags requiredProps)
+    {
+        const auto reqs2 = mDevice.getImageMemoryRequirements2<vk::MemoryRequirements2, vk::MemoryDedicatedRequirements>(vk::ImageMemoryRequirementsInfo2(image));
+
+        const auto& reqs          = reqs2.get<vk::MemoryRequirements2>().memoryRequirements;
+        const auto& dedicatedReqs = reqs2.get<vk::MemoryDedicatedRequirements>();
+
+        const bool dedicated = dedicatedReqs.requiresDedicatedAllocation || dedicatedReqs.prefersDedicatedAllocation || reqs.size >= mDedicatedThreshold.load(std::memory_order_relaxed);
+
+        MemoryAllocation allocation = allocate(reqs, requiredProps, tiling == vk::ImageTiling::eOptimal, dedicated, vk::MemoryDedicatedAllocateInfo(image, {}));
+        mDevice.bindImageMemory(image, allocation.getVkDeviceMemory(), allocation.getOffset());
+
+        return allocation;
+    }
+
+    uint32_t MemoryAllocator::findMemoryTypeIndex(const uint32_t typeBits, const vk::MemoryPropertyFlags requiredProps) const
+    {
+        const auto candidates = getMemoryTypeCandidates(typeBits, requiredProps);
+        return candidates.empty() ? 0 : candidates.front();
+    }
+
+    void MemoryAllocator::setTypePolicy(const TypePolicy policy)
+    {
+        mTypePolicy.store(policy, std::memory_order_relaxed);
+    }
+
+    MemoryAllocator::TypePolicy MemoryAllocator::getTypePolicy() const
+    {
+        return mTypePolicy.load(std::memory_order_relaxed);
+    }
+
+    void MemoryAllocator::setDedicatedThreshold(const vk::DeviceSize threshold)
+    {
+        mDedicatedThreshold.store(threshold, std::memory_order_relaxed);
+    }
+
+    MemoryAllocator::Statistics MemoryAllocator::getStatistics() const
+    {
+        Statistics stats;
+        stats.blockNum               = mBlockNum.load(std::memory_order_relaxed);
+        stats.dedicatedAllocationNum = mDedicatedAllocationNum.load(std::memory_order_relaxed);
+        stats.allocationNum          = mAllocationNum.load(std::memory_order_relaxed);
+        stats.reservedBytes          = mReservedBytes.load(std::memory_order_relaxed);
+        stats.usedBytes              = mUsedBytes.load(std::memory_order_relaxed);
+
+        return stats;
+    }
+
+    std::vector<MemoryAllocator::TypeUsage> MemoryAllocator::getTypeUsages() const
+    {
+        std::vector<TypeUsage> usages(mMemProps.memoryTypeCount);
+        for (uint32_t i = 0; i < mMemProps.memoryTypeCount; ++i)
+        {
+            auto& usage         = usages[i];
+            usage.typeIndex     = i;
+            usage.heapIndex     = mMemProps.memoryTypes[i].heapIndex;
+            usage.propertyFlags = mMemProps.memoryTypes[i].propertyFlags;
+            usage.allocationNum = mTypeCounters[i].allocationNum.load(std::memory_order_relaxed);
+            usage.reservedBytes = mTypeCounters[i].reservedBytes.load(std::memory_order_relaxed);
+            usage.usedBytes     = mTypeCounters[i].usedBytes.load(std::memory_order_relaxed);
+        }
+
+        return usages;
+    }
+
+    std::vector<MemoryAllocator::HeapBudget> MemoryAllocator::getHeapBudgets() const
+    {
+        std::vector<HeapBudget> budgets(mMemProps.memoryHeapCount);
+        for (uint32_t i = 0; i < mMemProps.memoryHeapCount; ++i)
+        {
+            budgets[i].heapIndex = i;
+            budgets[i].flags     = mMemProps.memoryHeaps[i].flags;
+            budgets[i].size      = mMemProps.memoryHeaps[i].size;
+        }
+
+        for (const auto& usage : getTypeUsages())
+        {
+            budgets[usage.heapIndex].reservedBytes += usage.reservedBytes;
+            budgets[usage.heapIndex].usedBytes += usage.usedBytes;
+        }
+
+        if (mUseMemoryBudget)
+        {
+            const auto props2 = mPhysicalDevice.getMemoryProperties2<vk::PhysicalDeviceMemoryProperties2, vk::PhysicalDeviceMemoryBudgetPropertiesEXT>();
+            const auto& props = props2.get<vk::PhysicalDeviceMemoryBudgetPropertiesEXT>();
+            for (auto& budget : budgets)
+            {
+                budget.budget     = props.heapBudget[budget.heapIndex];
+                budget.usage      = props.heapUsage[budget.heapIndex];
+                budget.fromDriver = true;
+            }
+        }
+        else
+        {
+            // same heuristic as common allocators: other processes and the driver also need a part of the heap
+            for (auto& budget : budgets)
+            {
+                budget.budget = budget.size * 8 / 10;
+                budget.usage  = budget.reservedBytes;
+            }
+        }
+
+        return budgets;
+    }
+
+    vk::DeviceSize MemoryAllocator::getAvailableBudget(const vk::MemoryPropertyFlags requiredProps) const
+    {
+        const auto candidates = getMemoryTypeCandidates(~0u, requiredProps);
+        if (candidates.empty())
+        {
+            return 0;
+        }
+
+        const auto& budget = getHeapBudgets()[mMemProps.memoryTypes[candidates.front()].heapIndex];
+        return budget.budget > budget.usage ? budget.budget - budget.usage : 0;
+    }
+
+    void MemoryAllocator::writeJson(std::ostream& os) const
+    {
+        const auto stats = getStatistics();
+
+        os << "{\n";
+        os << "  \"statistics\": { \"blockNum\": " << stats.blockNum << ", \"dedicatedAllocationNum\": " << stats.dedicatedAllocationNum << ", \"allocationNum\": " << stats.allocationNum
+           << ", \"reservedBytes\": " << stats.reservedBytes << ", \"usedBytes\": " << stats.usedBytes << " },\n";
+
+        os << "  \"heaps\": [";
+        const auto budgets = getHeapBudgets();
+        for (size_t i = 0; i < budgets.size(); ++i)
+        {
+            const auto& b = budgets[i];
+            os << (i == 0 ? "\n" : ",\n");
+            os << "    { \"heapIndex\": " << b.heapIndex << ", \"deviceLocal\": " << ((b.flags & vk::MemoryHeapFlagBits::eDeviceLocal) ? "true" : "false") << ", \"size\": " << b.size
+               << ", \"budget\": " << b.budget << ", \"usage\": " << b.usage << ", \"reservedBytes\": " << b.reservedBytes << ", \"usedBytes\": " << b.usedBytes
+               << ", \"fromDriver\": " << (b.fromDriver ? "true" : "false") << " }";
+        }
+        os << "\n  ],\n";
+
+        os << "  \"types\": [";
+        const auto usages = getTypeUsages();
+        for (size_t i = 0; i < usages.size(); ++i)
+        {
+            const auto& u = usages[i];
+            os << (i == 0 ? "\n" : ",\n");
+            os << "    { \"typeIndex\": " << u.typeIndex << ", \"heapIndex\": " << u.heapIndex << ", \"propertyFlags\": \"" << vk::to_string(u.propertyFlags) << "\", \"allocationNum\": " << u.allocationNum
+               << ", \"reservedBytes\": " << u.reservedBytes << ", \"usedBytes\": " << u.usedBytes << " }";
+        }
+        os << "\n  ]\n";
+        os << "}\n";
+    }
+
+    MemoryAllocation MemoryAllocator::allocate(const vk::MemoryRequirements& reqs, const vk::MemoryPropertyFlags requiredProps, const bool optimal, const bool dedicated, const vk::MemoryDedicatedAllocateInfo& dedicatedInfo)
+    {
+        const auto candidates = getMemoryTypeCandidates(reqs.memoryTypeBits, requiredProps);
+        assert(!candidates.empty() || !"no memory type satisfies the requested properties!");
+
+        // fall back to the next preferred type if the heap is exhausted (e.g. small BAR heap)
+        for (size_t i = 0; i + 1 < candidates.size(); ++i)
+        {
+            try
+            {
+                return allocateFromType(candidates[i], reqs, optimal, dedicated, dedicatedInfo);
+            }
+            catch (const vk::OutOfDeviceMemoryError&)
+            {
+            }
+        }
+
+        return allocateFromType(candidates.empty() ? 0 : candidates.back(), reqs, optimal, dedicated, dedicatedInfo);
+    }
+
+    MemoryAllocation MemoryAllocator::allocateFromType(const uint32_t typeIndex, const vk::MemoryRequirements& reqs, const bool optimal, const bool dedicated, const vk::MemoryDedicatedAllocateInfo& dedicatedInfo)
+    {
+        const auto typeFlags = mMemProps.memoryTypes[typeIndex].propertyFlags;
+
+        // flush / invalidate ranges of non-coherent memory must be aligned to nonCoherentAtomSize
+        vk::DeviceSize alignment = reqs.alignment;
+        vk::DeviceSize size      = reqs.size;
+        const bool nonCoherent   = (typeFlags & vk::MemoryPropertyFlagBits::eHostVisible) && !(typeFlags & vk::MemoryPropertyFlagBits::eHostCoherent);
+        if (nonCoherent)
+        {
+            alignment = std::max(alignment, mNonCoherentAtomSize);
+            size      = (size + mNonCoherentAtomSize - 1) / mNonCoherentAtomSize * mNonCoherentAtomSize;
+        }
+
+        MemoryAllocation allocation;
+        allocation.mMemoryTypeIndex = typeIndex;
+        allocation.mSize            = size;
+        allocation.mNonCoherent     = nonCoherent;
+
+        if (!dedicated && size <= getBlockSize(typeIndex))
+        {
+            // linear and optimal resources share blocks only if they can't conflict on a granularity page
+            const uint32_t listIndex = typeIndex * 2 + (optimal && mBufferImageGranularity > 1 ? 1 : 0);
+            auto& list               = mBlockLists[listIndex];
+
+            std::lock_guard lock(list.mutex);
+
+            Block* pTarget = nullptr;
+            uint32_t node  = TLSF::kNullNode;
+            for (auto& pBlock : list.blocks)
+            {
+                node = pBlock->tlsf.allocate(size, alignment);
+                if (node != TLSF::kNullNode)
+                {
+                    pTarget = pBlock.get();
+                    break;
+                }
+            }
+
+            if (!pTarget)
+            {
+                const vk::DeviceSize blockSize = getBlockSize(typeIndex);
+                const auto [memory, pMapped]   = allocateVkMemory(typeIndex, blockSize, nullptr);
+                pTarget                        = list.blocks.emplace_back(std::make_unique<Block>(memory, pMapped, blockSize)).get();
+                node                           = pTarget->tlsf.allocate(size, alignment);
+                assert(node != TLSF::kNullNode);
+                mBlockNum.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            allocation.mListIndex = listIndex;
+            allocation.mpBlock    = pTarget;
+            allocation.mNodeIndex = node;
+            allocation.mMemory    = pTarget->memory;
+            allocation.mOffset    = pTarget->tlsf.getOffset(node);
+            allocation.mpMapped   = pTarget->pMapped ? pTarget->pMapped + allocation.mOffset : nullptr;
+        }
+        else
+        {
+            const auto [memory, pMapped] = allocateVkMemory(typeIndex, size, dedicated ? &dedicatedInfo : nullptr);
+            allocation.mMemory           = memory;
+            allocation.mOffset           = 0;
+            allocation.mpMapped          = pMapped;
+            mDedicatedAllocationNum.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        // owned from here (nothing to return if vulkan allocation threw above)
+        allocation.mpAllocator = this;
+        mAllocationNum.fetch_add(1, std::memory_order_relaxed);
+        mUsedBytes.fetch_add(size, std::memory_order_relaxed);
+        mTypeCounters[typeIndex].allocationNum.fetch_add(1, std::memory_order_relaxed);
+        mTypeCounters[typeIndex].usedBytes.fetch_add(size, std::memory_order_relaxed);
+
+        return allocation;
+    }
+
+    std::pair<vk::DeviceMemory, std::byte*> MemoryAllocator::allocateVkMemory(const uint32_t typeIndex, const vk::DeviceSize size, const vk::MemoryDedicatedAllocateInfo* pDedicatedInfo)
+    {
+        vk::MemoryAllocateInfo ai(size, typeIndex);
+        vk::MemoryAllocateFlagsInfo allocateFlagsInfo(vk::MemoryAllocateFlagBits::eDeviceAddress);
+        vk::MemoryDedicatedAllocateInfo dedicatedInfo;
+
+        const void** ppNext = &ai.pNext;
+        if (mUseDeviceAddress)
+        {
+            *ppNext = &allocateFlagsInfo;
+            ppNext  = &allocateFlagsInfo.pNext;
+        }
+        if (pDedicatedInfo)
+        {
+            dedicatedInfo = *pDedicatedInfo;
+            *ppNext       = &dedicatedInfo;
+        }
+
+        const vk::DeviceMemory memory = mDevice.allocateMemory(ai);
+        mReservedBytes.fetch_add(size, std::memory_order_relaxed);
+        mTypeCounters[typeIndex].reservedBytes.fetch_add(size, std::memory_order_relaxed);
+
+        std::byte* pMapped = nullptr;
+        if (mMemProps.memoryTypes[typeIndex].propertyFlags & vk::MemoryPropertyFlagBits::eHostVisible)
+        {
+            pMapped = static_cast<std::byte*>(mDevice.mapMemory(memory, 0, VK_WHOLE_SIZE));
+        }
+
+        return { memory, pMapped };
+    }
+
+    void MemoryAllocator::free(MemoryAllocation& allocation)
+    {
+        auto& counter = mTypeCounters[allocation.mMemoryTypeIndex];
+        mAllocationNum.fetch_sub(1, std::memory_order_relaxed);
+        mUsedBytes.fetch_sub(allocation.mSize, std::memory_order_relaxed);
+        counter.allocationNum.fetch_sub(1, std::memory_order_relaxed);
+        counter.usedBytes.fetch_sub(allocation.mSize, std::memory_order_relaxed);
+
+        if (!allocation.mpBlock)  // dedicated
+        {
+            mDevice.freeMemory(allocation.mMemory);
+            mReservedBytes.fetch_sub(allocation.mSize, std::memory_order_relaxed);
+            counter.reservedBytes.fetch_sub(allocation.mSize, std::memory_order_relaxed);
+            mDedicatedAllocationNum.fetch_sub(1, std::memory_order_relaxed);
+            return;
+        }
+
+        auto& list    = mBlockLists[allocation.mListIndex];
+        Block* pBlock = static_cast<Block*>(allocation.mpBlock);
+
+        std::lock_guard lock(list.mutex);
+        pBlock->tlsf.free(allocation.mNodeIndex);
+
+        // release empty blocks, but keep one per list to avoid allocating again right away
+        if (pBlock->tlsf.getUsedSize() == 0 && list.blocks.size() > 1)
+        {
+            auto iter = std::find_if(list.blocks.begin(), list.blocks.end(), [pBlock](const auto& p) { return p.get() == pBlock; });
+            mDevice.freeMemory(pBlock->memory);
+            mReservedBytes.fetch_sub(pBlock->size, std::memory_order_relaxed);
+            counter.reservedBytes.fetch_sub(pBlock->size, std::memory_order_relaxed);
+            mBlockNum.fetch_sub(1, std::memory_order_relaxed);
+            list.blocks.erase(iter);
+        }
+    }
+
+    vk::MappedMemoryRange MemoryAllocator::getMappedRange(const MemoryAllocation& allocation, const vk::DeviceSize offset, const vk::DeviceSize size) const
+    {
+        assert(offset <= allocation.mSize || !"the range is out of the allocation!");
+
+        // the allocation itself is aligned to nonCoherentAtomSize, so the widened range stays inside it
+        const vk::DeviceSize allocationEnd = allocation.mOffset + allocation.mSize;
+        const vk::DeviceSize begin         = (allocation.mOffset + offset) / mNonCoherentAtomSize * mNonCoherentAtomSize;
+        const vk::DeviceSize end           = size == VK_WHOLE_SIZE ? allocationEnd : std::min(allocationEnd, (allocation.mOffset + offset + size + mNonCoherentAtomSize - 1) / mNonCoherentAtomSize * mNonCoherentAtomSize);
+
+        return vk::MappedMemoryRange(allocation.mMemory, begin, end - begin);
+    }
+
+    std::vector<uint32_t> MemoryAllocator::getMemoryTypeCandidates(const uint32_t typeBits, const vk::MemoryPropertyFlags requiredProps) const
+    {
+        std::vector<uint32_t> candidates;
+        for (uint32_t i = 0; i < mMemProps.memoryTypeCount; ++i)
+        {
+            if ((typeBits & (1u << i)) && (mMemProps.memoryTypes[i].propertyFlags & requiredProps) == requiredProps)
+            {
+                candidates.emplace_back(i);
+            }
+        }
+
+        if (mTypePolicy.load(std::memory_order_relaxed) == TypePolicy::eFirstMatch)
+        {
+            return candidates;
+        }
+
+        // host visible memory without host cache is written sequentially by CPU and read by GPU, so device local (ReBAR) is preferred
+        vk::MemoryPropertyFlags preferredProps;
+        if ((requiredProps & vk::MemoryPropertyFlagBits::eHostVisible) && !(requiredProps & vk::MemoryPropertyFlagBits::eHostCached))
+        {
+            preferredProps |= vk::MemoryPropertyFlagBits::eDeviceLocal;
+        }
+
+        const auto score = [&](const uint32_t typeIndex)
+        {
+            const auto& type = mMemProps.memoryTypes[typeIndex];
+            int result       = 0;
+            if ((type.propertyFlags & preferredProps) == preferredProps && (!preferredProps || mMemProps.memoryHeaps[type.heapIndex].size > kReBARHeapThreshold))
+            {
+                result += 64;
+            }
+
+            // fewer unrequested properties (e.g. host cached, device coherent) is better
+            result -= std::popcount(static_cast<uint32_t>(type.propertyFlags & ~(requiredProps | preferredProps)));
+
+            return result;
+        };
+
+        std::stable_sort(candidates.begin(), candidates.end(), [&](const uint32_t a, const uint32_t b) { return score(a) > score(b); });
+
+        return candidates;
+    }
+
+    vk::DeviceSize MemoryAllocator::getBlockSize(const uint32_t typeIndex) const
+    {
+        // small heaps get smaller blocks so that a few blocks don't exhaust them
+        const vk::DeviceSize heapSize = mMemProps.memoryHeaps[mMemProps.memoryTypes[typeIndex].heapIndex].size;
+        return heapSize <= 1024ull * 1024 * 1024 ? std::min(mBlockSize, heapSize / 8) : mBlockSize;
+    }
+}  // namespace vk2s
@@ -39,7 +39,14 @@ namespace vk2s
         vk::GraphicsPipelineCreateInfo pipelineInfo({}, shaderStages, &info.inputState, &info.inputAssembly, {}, &info.viewportState, &info.rasterizer, &info.multiSampling, &info.depthStencil, &info.colorBlending, &info.dynamicStates,
                                                     mLayout.get(), info.renderPass->getVkRenderPass().get(), 0, {}, {});
 
-        vk::ResultValue<vk::UniquePipeline> result = vkDevice->createGraphicsPipelineUnique({}, pipelineInfo);
+        vk::PipelineCreationFeedback feedback;
+        vk::PipelineCreationFeedbackCreateInfo feedbackInfo(&feedback);
+        pipelineInfo.pNext = &feedbackInfo;
+
+        auto& pipelineCache = mDevice.getPipelineCache();
+
+        vk::ResultValue<vk::UniquePipeline> result = vkDevice->createGraphicsPipelineUnique(pipelineCache.getVkPipelineCache().get(), pipelineInfo);
+        pipelineCache.recordCreation(feedback);
         if (result.result == vk::Result::eSuccess)
         {
             mPipeline = std::move(result.value);
@@ -71,10 +78,16 @@ namespace vk2s
 
         vk::PipelineShaderStageCreateInfo ssci({}, vk::ShaderStageFlagBits::eCompute, info.cs->getVkShaderModule().get(), info.cs->getEntryPoint().c_str());
 
+        vk::PipelineCreationFeedback feedback;
+        vk::PipelineCreationFeedbackCreateInfo feedbackInfo(&feedback);
+
         vk::ComputePipelineCreateInfo ci;
-        ci.setStage(ssci).setLayout(mLayout.get());
+        ci.setStage(ssci).setLayout(mLayout.get()).setPNext(&feedbackInfo);
 
-        vk::ResultValue<vk::UniquePipeline> result = vkDevice->createComputePipelineUnique({}, ci);
+        auto& pipelineCache = mDevice.getPipelineCache();
+
+        vk::ResultValue<vk::UniquePipeline> result = vkDevice->createComputePipelineUnique(pipelineCache.getVkPipelineCache().get(), ci);
+        pipelineCache.recordCreation(feedback);
         if (result.result == vk::Result::eSuccess)
         {
             mPipeline = std::move(result.value);
@@ -143,7 +156,14 @@ namespace vk2s
             rtPipelineCI.flags = vk::PipelineCreateFlagBits::eRayTracingAllowMotionNV;
         }
 
-        vk::ResultValue<vk::UniquePipeline> result = vkDevice->createRayTracingPipelineKHRUnique({}, {}, rtPipelineCI);
+        vk::PipelineCreationFeedback feedback;
+        vk::PipelineCreationFeedbackCreateInfo feedbackInfo(&feedback);
+        rtPipelineCI.pNext = &feedbackInfo;
+
+        auto& pipelineCache = mDevice.getPipelineCache();
+
+        vk::ResultValue<vk::UniquePipeline> result = vkDevice->createRayTracingPipelineKHRUnique({}, pipelineCache.getVkPipelineCache().get(), rtPipelineCI);
+        pipelineCache.recordCreation(feedback);
         if (result.result == vk::Result::eSuccess)
         {
             mPipeline = std::move(result.value);
@@ -0,0 +1,236 @@
+/*****************************************************************/ /**
+ * @file   PipelineCache.cpp
+ * @brief  source file of PipelineCache class
+ *
+ * @author agent
+ * @date   October 2026
+ *********************************************************************/
+#include "../include/vk2s/PipelineCache.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#if defined(_WIN32)
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace vk2s
+{
+    namespace
+    {
+        //! ID of this process (keeps the temporary files of processes saving the same path apart)
+        uint64_t getProcessID()
+        {
+#if defined(_WIN32)
+            return static_cast<uint64_t>(_getpid());
+#else
+            return static_cast<uint64_t>(getpid());
+#endif
+        }
+    }  // namespace
+
+    PipelineCache::PipelineCache(vk::PhysicalDevice physicalDevice, vk::Device device, const std::filesystem::path& path)
+        : mDevice(device)
+        , mProps(physicalDevice.getProperties())
+        , mPath(path)
+    {
+        const auto data = mPath.empty() ? std::vector<std::byte>() : readFile(mPath);
+
+        mPipelineCache = mDevice.createPipelineCacheUnique(vk::PipelineCacheCreateInfo({}, data.size(), data.data()));
+
+        mStats.loaded      = !data.empty();
+        mStats.loadedBytes = data.size();
+    }
+
+    PipelineCache::~PipelineCache()
+    {
+        try
+        {
+            save();
+        }
+        catch (const std::exception& e)
+        {
+            std::cerr << "failed to save the pipeline cache : " << e.what() << "\n";
+        }
+    }
+
+    const vk::UniquePipelineCache& PipelineCache::getVkPipelineCache() const
+    {
+        return mPipelineCache;
+    }
+
+    void PipelineCache::setPath(const std::filesystem::path& path)
+    {
+        mPath = path;
+        if (mPath.empty())
+        {
+            return;
+        }
+
+        const auto data = readFile(mPath);
+        if (data.empty())
+        {
+            return;
+        }
+
+        auto loaded = mDevice.createPipelineCacheUnique(vk::PipelineCacheCreateInfo({}, data.size(), data.data()));
+        mDevice.mergePipelineCaches(mPipelineCache.get(), loaded.get());
+
+        std::lock_guard lock(mMutex);
+        mStats.loaded = true;
+        mStats.loadedBytes += data.size();
+    }
+
+    const std::filesystem::path& PipelineCache::getPath() const
+    {
+        return mPath;
+    }
+
+    bool PipelineCache::save()
+    {
+        if (mPath.empty())
+        {
+            return false;
+        }
+
+        // merge what other processes may have written since startup into a temporary cache,
+        // the destination of a merge must be externally synchronized and Pipelines may be created with mPipelineCache meanwhile
+        const auto onDisk = readFile(mPath);
+        auto merged       = mDevice.createPipelineCacheUnique(vk::PipelineCacheCreateInfo({}, onDisk.size(), onDisk.data()));
+        mDevice.mergePipelineCaches(merged.get(), mPipelineCache.get());
+
+        const auto raw = mDevice.getPipelineCacheData(merged.get());
+        std::vector<std::byte> data(raw.size());
+        std::memcpy(data.data(), raw.data(), raw.size());
+
+        const FileHeader header = makeHeader(data);
+
+        // write to a temporary file next to the target and rename it (readers never see a partial file)
+        std::filesystem::path tmpPath = mPath;
+        tmpPath += ".tmp" + std::to_string(getProcessID()) + "_" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count());
+        {
+            std::ofstream ofs(tmpPath, std::ios::binary | std::ios::trunc);
+            if (!ofs)
+            {
+                return false;
+            }
+
+            ofs.write(reinterpret_cast<const char*>(&header), sizeof(FileHeader));
+            ofs.write(reinterpret_cast<const char*>(data.data()), data.size());
+            if (!ofs)
+            {
+                ofs.close();
+                std::error_code ec;
+                std::filesystem::remove(tmpPath, ec);
+                return false;
+            }
+        }
+
+        std::error_code ec;
+        std::filesystem::rename(tmpPath, mPath, ec);
+        if (ec)
+        {
+            std::cerr << "failed to save the pipeline cache to " << mPath << " : " << ec.message() << "\n";
+            std::filesystem::remove(tmpPath, ec);
+            return false;
+        }
+
+        return true;
+    }
+
+    void PipelineCache::recordCreation(const vk::PipelineCreationFeedback& feedback)
+    {
+        if (!(feedback.flags & vk::PipelineCreationFeedbackFlagBits::eValid))
+        {
+            return;
+        }
+
+        std::lock_guard lock(mMutex);
+
+        const auto duration = std::chrono::nanoseconds(feedback.duration);
+        ++mStats.pipelineNum;
+        if (feedback.flags & vk::PipelineCreationFeedbackFlagBits::eApplicationPipelineCacheHit)
+        {
+            ++mStats.cacheHitNum;
+            mStats.hitTime += duration;
+        }
+        else
+        {
+            mStats.missTime += duration;
+        }
+    }
+
+    PipelineCache::Statistics PipelineCache::getStatistics() const
+    {
+        std::lock_guard lock(mMutex);
+        return mStats;
+    }
+
+    std::vector<std::byte> PipelineCache::readFile(const std::filesystem::path& path) const
+    {
+        std::ifstream ifs(path, std::ios::binary);
+        if (!ifs)
+        {
+            return {};
+        }
+
+        FileHeader header{};
+        if (!ifs.read(reinterpret_cast<char*>(&header), sizeof(FileHeader)))
+        {
+            return {};
+        }
+
+        // data from another device, driver or vk2s version is useless (and may crash some drivers)
+        if (header.magic != kMagic || header.version != kFileVersion || header.vendorID != mProps.vendorID || header.deviceID != mProps.deviceID || header.driverVersion != mProps.driverVersion ||
+            std::memcmp(header.pipelineCacheUUID, mProps.pipelineCacheUUID.data(), VK_UUID_SIZE) != 0)
+        {
+            return {};
+        }
+
+        std::error_code ec;
+        const auto fileSize = std::filesystem::file_size(path, ec);
+        if (ec || fileSize != sizeof(FileHeader) + header.dataSize)
+        {
+            return {};
+        }
+
+        std::vector<std::byte> data(header.dataSize);
+        if (!ifs.read(reinterpret_cast<char*>(data.data()), data.size()) || computeChecksum(data) != header.checksum)
+        {
+            return {};
+        }
+
+        return data;
+    }
+
+    PipelineCache::FileHeader PipelineCache::makeHeader(const std::vector<std::byte>& data) const
+    {
+        FileHeader header{};
+        header.magic         = kMagic;
+        header.version       = kFileVersion;
+        header.vendorID      = mProps.vendorID;
+        header.deviceID      = mProps.deviceID;
+        header.driverVersion = mProps.driverVersion;
+        std::memcpy(header.pipelineCacheUUID, mProps.pipelineCacheUUID.data(), VK_UUID_SIZE);
+        header.dataSize = data.size();
+        header.checksum = computeChecksum(data);
+
+        return header;
+    }
+
+    uint64_t PipelineCache::computeChecksum(const std::vector<std::byte>& data)
+    {
+        uint64_t hash = 14695981039346656037ull;
+        for (const auto b : data)
+        {
+            hash = (hash ^ static_cast<uint8_t>(b)) * 1099511628211ull;
+        }
+
+        return hash;
+    }
+}  // namespace vk2s
@@ -0,0 +1,253 @@
+/*****************************************************************/ /**
+ * @file   PoolResource.cpp
+ * @brief  source file of memory resources for Pool pages
+ *
+ * @author agent
+ * @date   October 2026
+ *********************************************************************/
+#include "../include/vk2s/PoolResource.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <new>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#elif defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+namespace vk2s
+{
+    namespace
+    {
+        std::byte* alignUp(std::byte* ptr, const size_t alignment)
+        {
+            const auto address = reinterpret_cast<std::uintptr_t>(ptr);
+            return ptr + (((address + alignment - 1) & ~(static_cast<std::uintptr_t>(alignment) - 1)) - address);
+        }
+    }  // namespace
+
+    ArenaResource::ArenaResource(const size_t chunkSize, std::pmr::memory_resource* pUpstream)
+        : mpUpstream(pUpstream ? pUpstream : std::pmr::new_delete_resource())
+        , mChunkSize(chunkSize)
+        , mpCurrent(nullptr)
+        , mpEnd(nullptr)
+    {
+        assert(mChunkSize > 0 || !"invalid chunk size!");
+    }
+
+    ArenaResource::~ArenaResource()
+    {
+        release();
+    }
+
+    void ArenaResource::release()
+    {
+        std::lock_guard lock(mMutex);
+
+        for (const auto& chunk : mChunks)
+        {
+            mpUpstream->deallocate(chunk.ptr, chunk.size, chunk.alignment);
+        }
+
+        mChunks.clear();
+        mpCurrent = nullptr;
+        mpEnd     = nullptr;
+    }
+
+    size_t ArenaResource::getReservedSize() const
+    {
+        std::lock_guard lock(mMutex);
+
+        size_t size = 0;
+        for (const auto& chunk : mChunks)
+        {
+            size += chunk.size;
+        }
+
+        return size;
+    }
+
+    void* ArenaResource::do_allocate(size_t bytes, size_t alignment)
+    {
+        std::lock_guard lock(mMutex);
+
+        std::byte* ptr = mpCurrent ? alignUp(mpCurrent, alignment) : nullptr;
+        if (!ptr || ptr + bytes > mpEnd)
+        {
+            // start a new chunk (requests larger than the chunk size get a chunk of their own)
+            const size_t size       = std::max(mChunkSize, bytes);
+            const size_t chunkAlign = std::max(alignment, alignof(std::max_align_t));
+            void* chunk             = mpUpstream->allocate(size, chunkAlign);
+            mChunks.emplace_back(Chunk{ chunk, size, chunkAlign });
+
+            ptr   = static_cast<std::byte*>(chunk);
+            mpEnd = ptr + size;
+        }
+
+        mpCurrent = ptr + bytes;
+
+        return ptr;
+    }
+
+    void ArenaResource::do_deallocate(void* ptr, size_t bytes, size_t alignment)
+    {
+        // released all at once by release()
+    }
+
+    bool ArenaResource::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+    {
+        return this == &other;
+    }
+
+    HugePageResource::HugePageResource(const size_t regionSize)
+        : mRegionSize(std::max(kHugePageSize, (regionSize + kHugePageSize - 1) / kHugePageSize * kHugePageSize))
+        , mpCurrent(nullptr)
+        , mpEnd(nullptr)
+    {
+    }
+
+    HugePageResource::~HugePageResource()
+    {
+        for (const auto& region : mRegions)
+        {
+            releaseRegion(region.ptr, region.size);
+        }
+    }
+
+    size_t HugePageResource::getReservedSize() const
+    {
+        std::lock_guard lock(mMutex);
+
+        size_t size = 0;
+        for (const auto& region : mRegions)
+        {
+            size += region.size;
+        }
+
+        return size;
+    }
+
+    void* HugePageResource::do_allocate(size_t bytes, size_t alignment)
+    {
+        assert(alignment <= kHugePageSize || !"alignment larger than a huge page is not supported!");
+
+        const size_t blockAlign = std::max(alignment, alignof(std::max_align_t));
+        const size_t blockSize  = (bytes + blockAlign - 1) / blockAlign * blockAlign;
+
+        std::lock_guard lock(mMutex);
+
+        // reuse a freed block of the same size
+        if (auto iter = mFreeBlocks.find(blockSize); iter != mFreeBlocks.end())
+        {
+            auto& blocks = iter->second;
+            for (auto block = blocks.rbegin(); block != blocks.rend(); ++block)
+            {
+                if (reinterpret_cast<std::uintptr_t>(*block) % blockAlign == 0)
+                {
+                    std::byte* ptr = *block;
+                    blocks.erase(std::next(block).base());
+                    return ptr;
+                }
+            }
+        }
+
+        std::byte* ptr = mpCurrent ? alignUp(mpCurrent, blockAlign) : nullptr;
+        if (!ptr || ptr + blockSize > mpEnd)
+        {
+            // requests larger than the region size get a region of their own
+            const size_t size = std::max(mRegionSize, (blockSize + kHugePageSize - 1) / kHugePageSize * kHugePageSize);
+            ptr               = reserveRegion(size);
+            mRegions.emplace_back(Region{ ptr, size });
+
+            if (size != mRegionSize)
+            {
+                return ptr;
+            }
+
+            mpEnd = ptr + size;
+        }
+
+        mpCurrent = ptr + blockSize;
+
+        return ptr;
+    }
+
+    void HugePageResource::do_deallocate(void* ptr, size_t bytes, size_t alignment)
+    {
+        const size_t blockAlign = std::max(alignment, alignof(std::max_align_t));
+        const size_t blockSize  = (bytes + blockAlign - 1) / blockAlign * blockAlign;
+
+        std::lock_guard lock(mMutex);
+        mFreeBlocks[blockSize].emplace_back(static_cast<std::byte*>(ptr));
+    }
+
+    bool HugePageResource::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+    {
+        return this == &other;
+    }
+
+    std::byte* HugePageResource::reserveRegion(const size_t size)
+    {
+#if defined(_WIN32)
+        // large pages require SeLockMemoryPrivilege, fall back to normal pages if not permitted
+        const SIZE_T largePageSize = GetLargePageMinimum();
+        if (largePageSize != 0 && size % largePageSize == 0)
+        {
+            if (void* ptr = VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE))
+            {
+                return static_cast<std::byte*>(ptr);
+            }
+        }
+
+        void* ptr = VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+        if (!ptr)
+        {
+            throw std::bad_alloc();
+        }
+
+        return static_cast<std::byte*>(ptr);
+#elif defined(__linux__)
+        // over-reserve by a huge page to align the region to the huge page boundary, then trim both ends
+        void* raw = mmap(nullptr, size + kHugePageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (raw == MAP_FAILED)
+        {
+            throw std::bad_alloc();
+        }
+
+        std::byte* ptr        = alignUp(static_cast<std::byte*>(raw), kHugePageSize);
+        const size_t headSize = ptr - static_cast<std::byte*>(raw);
+        if (headSize > 0)
+        {
+            munmap(raw, headSize);
+        }
+        if (kHugePageSize - headSize > 0)
+        {
+            munmap(ptr + size, kHugePageSize - headSize);
+        }
+
+        // only a hint, the region is still usable without transparent huge pages
+        madvise(ptr, size, MADV_HUGEPAGE);
+
+        return ptr;
+#else
+        return static_cast<std::byte*>(::operator new(size, std::align_val_t(kHugePageSize)));
+#endif
+    }
+
+    void HugePageResource::releaseRegion(std::byte* ptr, const size_t size)
+    {
+#if defined(_WIN32)
+        VirtualFree(ptr, 0, MEM_RELEASE);
+#elif defined(__linux__)
+        munmap(ptr, size);
+#else
+        ::operator delete(ptr, std::align_val_t(kHugePageSize));
+#endif
+    }
+}  // namespace vk2s
@@ -0,0 +1,262 @@
+/*****************************************************************/ /**
+ * @file   Profiler.cpp
+ * @brief  source file of Profiler class
+ *
+ * @author agent
+ * @date   October 2026
+ *********************************************************************/
+#include "../include/vk2s/Profiler.hpp"
+
+#include "../include/vk2s/Device.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <iomanip>
+#include <map>
+#include <optional>
+
+namespace vk2s
+{
+    Profiler::Profiler(Device& device, const uint32_t frameLatency, const uint32_t maxScopeNum)
+        : mDevice(device)
+        , mMaxScopeNum(maxScopeNum)
+        , mFrameIndex(0)
+    {
+        assert(frameLatency > 0 || !"frame latency must be at least 1!");
+
+        const auto& physicalDevice = mDevice.getVkPhysicalDevice();
+        const auto& vkDevice       = mDevice.getVkDevice();
+
+        mTimestampPeriod = static_cast<double>(physicalDevice.getProperties().limits.timestampPeriod);
+
+        const bool statisticsSupported = physicalDevice.getFeatures().pipelineStatisticsQuery == VK_TRUE;
+        for (const auto& props : physicalDevice.getQueueFamilyProperties())
+        {
+            // kPipelineStatisticFlags contains graphics counters, which compute-only queues must not query (VUID-vkCmdBeginQuery-queryType-00804)
+            const bool statistics = statisticsSupported && (props.queueFlags & vk::QueueFlagBits::eGraphics);
+            mQueueFamilySupports.emplace_back(props.timestampValidBits, statistics);
+        }
+
+        mUseDebugLabel = VULKAN_HPP_DEFAULT_DISPATCHER.vkCmdBeginDebugUtilsLabelEXT != nullptr && VULKAN_HPP_DEFAULT_DISPATCHER.vkCmdEndDebugUtilsLabelEXT != nullptr;
+
+        mFrames.resize(frameLatency);
+        for (auto& frame : mFrames)
+        {
+            frame.timestampPool = vkDevice->createQueryPoolUnique(vk::QueryPoolCreateInfo({}, vk::QueryType::eTimestamp, mMaxScopeNum * 2));
+            if (statisticsSupported)
+            {
+                frame.statisticsPool = vkDevice->createQueryPoolUnique(vk::QueryPoolCreateInfo({}, vk::QueryType::ePipelineStatistics, mMaxScopeNum, kPipelineStatisticFlags));
+            }
+
+            frame.scopes.reserve(mMaxScopeNum);
+            // queries must be reset before the first use
+            resetFrame(frame);
+        }
+    }
+
+    Profiler::~Profiler()
+    {
+        // query pools are released with the frames
+    }
+
+    void Profiler::beginFrame()
+    {
+        std::lock_guard lock(mMutex);
+
+        // every submission issued so far may contain the scopes of the current frame
+        mFrames[mFrameIndex].submissionIndex = mDevice.getLatestSubmissionIndex();
+        mFrameIndex                          = (mFrameIndex + 1) % mFrames.size();
+
+        auto& frame = mFrames[mFrameIndex];
+        if (!frame.scopes.empty())
+        {
+            // usually retired long ago, waits only if the GPU is more than kFrameLatency frames behind
+            mDevice.waitSubmission(frame.submissionIndex);
+            collect(frame);
+            resetFrame(frame);
+        }
+    }
+
+    uint32_t Profiler::beginScope(const vk::CommandBuffer commandBuffer, const uint32_t queueFamilyIndex, std::string_view name, const bool pipelineStatistics)
+    {
+        if (mUseDebugLabel)
+        {
+            const std::string label(name);
+            commandBuffer.beginDebugUtilsLabelEXT(vk::DebugUtilsLabelEXT(label.c_str()), mDevice.getVkDispatcher());
+        }
+
+        assert(queueFamilyIndex < mQueueFamilySupports.size() || !"invalid queue family index!");
+        const auto [timestampValidBits, statisticsSupported] = mQueueFamilySupports[queueFamilyIndex];
+        if (timestampValidBits == 0)
+        {
+            // only labeled
+            return kInvalidScope;
+        }
+
+        std::lock_guard lock(mMutex);
+
+        auto& frame = mFrames[mFrameIndex];
+        if (frame.scopes.size() >= mMaxScopeNum)
+        {
+            return kInvalidScope;
+        }
+
+        const uint32_t index         = static_cast<uint32_t>(frame.scopes.size());
+        const bool statistics        = pipelineStatistics && statisticsSupported && frame.statisticsPool;
+        const uint64_t timestampMask = timestampValidBits >= 64 ? UINT64_MAX : (1ull << timestampValidBits) - 1;
+        frame.scopes.emplace_back(Scope{ std::string(name), statistics, timestampMask });
+
+        const auto& dispatcher = mDevice.getVkDispatcher();
+        commandBuffer.writeTimestamp(vk::PipelineStageFlagBits::eTopOfPipe, frame.timestampPool.get(), index * 2, dispatcher);
+        if (statistics)
+        {
+            commandBuffer.beginQuery(frame.statisticsPool.get(), index, {}, dispatcher);
+        }
+
+        return index;
+    }
+
+    void Profiler::endScope(const vk::CommandBuffer commandBuffer, const uint32_t scopeIndex)
+    {
+        if (scopeIndex != kInvalidScope)
+        {
+            std::lock_guard lock(mMutex);
+
+            auto& frame = mFrames[mFrameIndex];
+            assert(scopeIndex < frame.scopes.size() || !"the scope must be ended in the frame it began!");
+
+            const auto& dispatcher = mDevice.getVkDispatcher();
+            if (frame.scopes[scopeIndex].statistics)
+            {
+                commandBuffer.endQuery(frame.statisticsPool.get(), scopeIndex, dispatcher);
+            }
+            commandBuffer.writeTimestamp(vk::PipelineStageFlagBits::eBottomOfPipe, frame.timestampPool.get(), scopeIndex * 2 + 1, dispatcher);
+        }
+
+        if (mUseDebugLabel)
+        {
+            commandBuffer.endDebugUtilsLabelEXT(mDevice.getVkDispatcher());
+        }
+    }
+
+    std::vector<Profiler::ScopeResult> Profiler::getResults() const
+    {
+        std::lock_guard lock(mMutex);
+
+        std::vector<ScopeResult> rtn;
+        rtn.reserve(mHistories.size());
+        for (const auto& [name, history] : mHistories)
+        {
+            rtn.emplace_back(history.result);
+        }
+
+        std::sort(rtn.begin(), rtn.end(), [](const ScopeResult& l, const ScopeResult& r) { return l.name < r.name; });
+
+        return rtn;
+    }
+
+    void Profiler::print(std::ostream& os) const
+    {
+        for (const auto& result : getResults())
+        {
+            os << result.name << ": " << std::fixed << std::setprecision(3) << result.lastMs << " ms (avg " << result.averageMs << " ms)";
+            if (result.hasStatistics)
+            {
+                const auto& s = result.statistics;
+                os << " [vertices " << s.inputAssemblyVertices << ", primitives " << s.inputAssemblyPrimitives << ", VS " << s.vertexShaderInvocations << ", clipping " << s.clippingPrimitives << ", FS "
+                   << s.fragmentShaderInvocations << ", CS " << s.computeShaderInvocations << "]";
+            }
+            os << "\n";
+        }
+    }
+
+    void Profiler::collect(Frame& frame)
+    {
+        const auto& vkDevice    = mDevice.getVkDevice();
+        const uint32_t scopeNum = static_cast<uint32_t>(frame.scopes.size());
+
+        // value and availability of each query
+        std::vector<uint64_t> timestamps(scopeNum * 2 * 2);
+        const auto timestampRes = vkDevice->getQueryPoolResults(frame.timestampPool.get(), 0, scopeNum * 2, timestamps.size() * sizeof(uint64_t), timestamps.data(), sizeof(uint64_t) * 2,
+                                                                vk::QueryResultFlagBits::e64 | vk::QueryResultFlagBits::eWithAvailability);
+        assert(timestampRes == vk::Result::eSuccess || timestampRes == vk::Result::eNotReady || !"failed to get timestamp query results!");
+
+        std::vector<uint64_t> statistics;
+        if (frame.statisticsPool)
+        {
+            statistics.resize(scopeNum * (kPipelineStatisticNum + 1));
+            const auto statisticsRes = vkDevice->getQueryPoolResults(frame.statisticsPool.get(), 0, scopeNum, statistics.size() * sizeof(uint64_t), statistics.data(),
+                                                                     sizeof(uint64_t) * (kPipelineStatisticNum + 1), vk::QueryResultFlagBits::e64 | vk::QueryResultFlagBits::eWithAvailability);
+            assert(statisticsRes == vk::Result::eSuccess || statisticsRes == vk::Result::eNotReady || !"failed to get pipeline statistics query results!");
+        }
+
+        // scopes sharing a name in a frame (e.g. recorded in a loop) are summed up
+        std::map<std::string_view, std::pair<double, std::optional<PipelineStatistics>>> frameResults;
+        for (uint32_t i = 0; i < scopeNum; ++i)
+        {
+            const auto& scope = frame.scopes[i];
+
+            // scopes recorded to commands that were never submitted are not available
+            const uint64_t* begin = &timestamps[i * 4];
+            const uint64_t* end   = &timestamps[i * 4 + 2];
+            if (begin[1] == 0 || end[1] == 0)
+            {
+                continue;
+            }
+
+            auto& [ms, stats] = frameResults[scope.name];
+            ms += static_cast<double>((end[0] - begin[0]) & scope.timestampMask) * mTimestampPeriod * 1e-6;
+
+            const uint64_t* counters = statistics.empty() ? nullptr : &statistics[i * (kPipelineStatisticNum + 1)];
+            if (scope.statistics && counters[kPipelineStatisticNum] != 0)
+            {
+                if (!stats)
+                {
+                    stats.emplace();
+                }
+                stats->inputAssemblyVertices += counters[0];
+                stats->inputAssemblyPrimitives += counters[1];
+                stats->vertexShaderInvocations += counters[2];
+                stats->clippingPrimitives += counters[3];
+                stats->fragmentShaderInvocations += counters[4];
+                stats->computeShaderInvocations += counters[5];
+            }
+        }
+
+        for (const auto& [name, result] : frameResults)
+        {
+            const auto& [ms, stats] = result;
+
+            auto& history = mHistories[std::string(name)];
+            history.samples.emplace_back(ms);
+            history.sum += ms;
+            if (history.samples.size() > kAverageWindow)
+            {
+                history.sum -= history.samples.front();
+                history.samples.pop_front();
+            }
+
+            history.result.name      = name;
+            history.result.lastMs    = ms;
+            history.result.averageMs = history.sum / history.samples.size();
+            ++history.result.sampleNum;
+            history.result.hasStatistics = stats.has_value();
+            history.result.statistics    = stats.value_or(PipelineStatistics());
+        }
+    }
+
+    void Profiler::resetFrame(Frame& frame)
+    {
+        const auto& vkDevice = mDevice.getVkDevice();
+
+        // reset from the host (hostQueryReset), no command buffer is needed
+        vkDevice->resetQueryPool(frame.timestampPool.get(), 0, mMaxScopeNum * 2);
+        if (frame.statisticsPool)
+        {
+            vkDevice->resetQueryPool(frame.statisticsPool.get(), 0, mMaxScopeNum);
+        }
+
+        frame.scopes.clear();
+        frame.submissionIndex = 0;
+    }
+}  // namespace vk2s
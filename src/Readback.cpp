@@ -0,0 +1,245 @@
+/*****************************************************************/ /**
+ * @file   Readback.cpp
+ * @brief  source file of Readback class
+ *
+ * @author agent
+ * @date   October 2026
+ *********************************************************************/
+#include "../include/vk2s/Readback.hpp"
+
+#include "../include/vk2s/Device.hpp"
+#include "../include/vk2s/Compiler.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <stdexcept>
+
+namespace vk2s
+{
+    Readback::Readback(Device& device, const uint32_t slotNum, const vk::DeviceSize slotSize)
+        : mDevice(device)
+        , mLastTicket(0)
+    {
+        // host cached memory makes reading on the CPU fast, but isn't guaranteed to exist
+        const auto memProps = mDevice.getVkPhysicalDevice().getMemoryProperties();
+        const auto cached   = vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCached;
+        const bool hasCached =
+            std::any_of(memProps.memoryTypes.begin(), memProps.memoryTypes.begin() + memProps.memoryTypeCount, [&](const vk::MemoryType& type) { return (type.propertyFlags & cached) == cached; });
+        mSlotMemProps = hasCached ? cached : vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent;
+
+        for (uint32_t i = 0; i < slotNum; ++i)
+        {
+            auto& slot   = mSlots.emplace_back();
+            slot.command = mDevice.create<Command>(QueueType::eGraphics);
+            if (slotSize > 0)
+            {
+                slot.buffer   = mDevice.create<Buffer>(vk::BufferCreateInfo({}, slotSize, vk::BufferUsageFlagBits::eTransferDst), mSlotMemProps);
+                slot.capacity = slotSize;
+            }
+        }
+        mStats.slotNum = mSlots.size();
+    }
+
+    Readback::~Readback()
+    {
+        // copies may still be in flight
+        for (auto& slot : mSlots)
+        {
+            mDevice.destroyDeferred(slot.buffer);
+            mDevice.destroyDeferred(slot.command);
+        }
+    }
+
+    Readback::Ticket Readback::readbackAsync(Buffer& src, const vk::DeviceSize offset, const vk::DeviceSize size)
+    {
+        const vk::DeviceSize range = size == VK_WHOLE_SIZE ? src.getSize() - offset : size;
+        assert(offset + range <= src.getSize() || !"the readback is out of the buffer!");
+
+        const vk::Buffer vkSrc = src.getVkBuffer().get();
+        const auto& dispatcher = mDevice.getVkDispatcher();
+
+        std::lock_guard lock(mMutex);
+
+        return submit(acquireSlot(range), range,
+                      [&](vk::CommandBuffer commandBuffer, vk::Buffer dst)
+                      {
+                          // writes submitted before (on the same queue) become visible to the copy
+                          const vk::MemoryBarrier barrier(vk::AccessFlagBits::eMemoryWrite, vk::AccessFlagBits::eTransferRead);
+                          commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eAllCommands, vk::PipelineStageFlagBits::eTransfer, {}, barrier, {}, {}, dispatcher);
+                          commandBuffer.copyBuffer(vkSrc, dst, vk::BufferCopy(offset, 0, range), dispatcher);
+                      });
+    }
+
+    Readback::Ticket Readback::readbackAsync(Image& src, const vk::ImageLayout layout)
+    {
+        assert(layout != vk::ImageLayout::eUndefined || !"the contents of an image in eUndefined can't be read back!");
+
+        const auto extent          = src.getVkExtent();
+        const vk::DeviceSize size  = static_cast<vk::DeviceSize>(extent.width) * extent.height * extent.depth * Compiler::getSizeOfFormat(src.getVkFormat());
+        const vk::Image vkSrc      = src.getVkImage().get();
+        const auto aspect          = src.getVkAspectFlag();
+        const bool needsTransition = layout != vk::ImageLayout::eTransferSrcOptimal && layout != vk::ImageLayout::eGeneral;
+        const auto& dispatcher     = mDevice.getVkDispatcher();
+
+        std::lock_guard lock(mMutex);
+
+        return submit(acquireSlot(size), size,
+                      [&](vk::CommandBuffer commandBuffer, vk::Buffer dst)
+                      {
+                          const vk::ImageSubresourceRange range(aspect, 0, 1, 0, 1);
+                          const vk::ImageLayout copyLayout = needsTransition ? vk::ImageLayout::eTransferSrcOptimal : layout;
+
+                          // writes submitted before (on the same queue) become visible to the copy
+                          const vk::ImageMemoryBarrier toCopy(vk::AccessFlagBits::eMemoryWrite, vk::AccessFlagBits::eTransferRead, layout, copyLayout, VK_QUEUE_FAMILY_IGNORED, VK_QUEUE_FAMILY_IGNORED, vkSrc, range);
+                          commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eAllCommands, vk::PipelineStageFlagBits::eTransfer, {}, {}, {}, toCopy, dispatcher);
+
+                          vk::BufferImageCopy region;
+                          region.bufferOffset                    = 0;
+                          region.bufferRowLength                 = 0;
+                          region.bufferImageHeight               = 0;
+                          region.imageSubresource.aspectMask     = aspect;
+                          region.imageSubresource.mipLevel       = 0;
+                          region.imageSubresource.baseArrayLayer = 0;
+                          region.imageSubresource.layerCount     = 1;
+                          region.imageOffset                     = vk::Offset3D(0, 0, 0);
+                          region.imageExtent                     = extent;
+                          commandBuffer.copyImageToBuffer(vkSrc, copyLayout, dst, region, dispatcher);
+
+                          if (needsTransition)
+                          {
+                              const vk::ImageMemoryBarrier toOriginal(vk::AccessFlagBits::eTransferRead, vk::AccessFlagBits::eMemoryRead | vk::AccessFlagBits::eMemoryWrite, copyLayout, layout, VK_QUEUE_FAMILY_IGNORED,
+                                                                      VK_QUEUE_FAMILY_IGNORED, vkSrc, range);
+                              commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eAllCommands, {}, {}, {}, toOriginal, dispatcher);
+                          }
+                      });
+    }
+
+    bool Readback::isReady(const Ticket ticket) const
+    {
+        std::lock_guard lock(mMutex);
+
+        const auto iter = std::find_if(mSlots.begin(), mSlots.end(), [ticket](const Slot& slot) { return ticket != 0 && slot.ticket == ticket; });
+        assert(iter != mSlots.end() || !"invalid readback ticket!");
+
+        return iter != mSlots.end() && iter->submissionIndex <= mDevice.getCompletedSubmissionIndex();
+    }
+
+    void Readback::wait(const Ticket ticket)
+    {
+        uint64_t submissionIndex = 0;
+        {
+            std::lock_guard lock(mMutex);
+            submissionIndex = findSlot(ticket).submissionIndex;
+        }
+
+        mDevice.waitSubmission(submissionIndex);
+    }
+
+    void Readback::read(const Ticket ticket, const std::function<void(std::span<const std::byte>)>& readFunc)
+    {
+        // the slot is owned by the ticket until it is released, so it isn't reused or grown while the lock is released
+        Slot* pSlot              = nullptr;
+        uint64_t submissionIndex = 0;
+        {
+            std::lock_guard lock(mMutex);
+            pSlot           = &findSlot(ticket);
+            submissionIndex = pSlot->submissionIndex;
+        }
+
+        // wait without the lock so that the other tickets and new readbacks don't stall behind the GPU
+        if (submissionIndex > mDevice.getCompletedSubmissionIndex())
+        {
+            mDevice.waitSubmission(submissionIndex);
+
+            std::lock_guard lock(mMutex);
+            ++mStats.stallNum;
+        }
+
+        // recycles the slot even if readFunc throws
+        struct SlotRelease
+        {
+            ~SlotRelease()
+            {
+                std::lock_guard lock(mutex);
+                stats.readBytes += slot.size;
+                slot.ticket = 0;
+            }
+
+            std::mutex& mutex;
+            Statistics& stats;
+            Slot& slot;
+        } release{ mMutex, mStats, *pSlot };
+
+        // host cached memory may not be coherent
+        pSlot->buffer->invalidate(0, pSlot->size);
+        readFunc(std::span<const std::byte>(static_cast<const std::byte*>(pSlot->buffer->getMappedPointer()), static_cast<size_t>(pSlot->size)));
+    }
+
+    Readback::Statistics Readback::getStatistics() const
+    {
+        std::lock_guard lock(mMutex);
+        return mStats;
+    }
+
+    Readback::Slot& Readback::acquireSlot(const vk::DeviceSize size)
+    {
+        auto iter = std::find_if(mSlots.begin(), mSlots.end(), [](const Slot& slot) { return slot.ticket == 0; });
+        if (iter == mSlots.end())
+        {
+            // every slot is waiting to be read, add one instead of stalling
+            auto& added   = mSlots.emplace_back();
+            added.command = mDevice.create<Command>(QueueType::eGraphics);
+            iter          = std::prev(mSlots.end());
+            ++mStats.slotNum;
+        }
+
+        auto& slot = *iter;
+        if (slot.capacity < size)
+        {
+            // a free slot has been read, so its previous copy is retired
+            if (slot.buffer)
+            {
+                mDevice.destroy(slot.buffer);
+            }
+
+            slot.buffer   = mDevice.create<Buffer>(vk::BufferCreateInfo({}, size, vk::BufferUsageFlagBits::eTransferDst), mSlotMemProps);
+            slot.capacity = size;
+        }
+
+        return slot;
+    }
+
+    Readback::Slot& Readback::findSlot(const Ticket ticket)
+    {
+        const auto iter = std::find_if(mSlots.begin(), mSlots.end(), [ticket](const Slot& slot) { return slot.ticket == ticket; });
+        if (ticket == 0 || iter == mSlots.end())
+        {
+            throw std::runtime_error("invalid readback ticket!");
+        }
+
+        return *iter;
+    }
+
+    Readback::Ticket Readback::submit(Slot& slot, const vk::DeviceSize size, const std::function<void(vk::CommandBuffer, vk::Buffer)>& recordFunc)
+    {
+        slot.command->reset();
+        slot.command->begin(true);
+        const vk::CommandBuffer commandBuffer = slot.command->getVkCommandBuffer().get();
+
+        recordFunc(commandBuffer, slot.buffer->getVkBuffer().get());
+
+        // make the copy visible to the host
+        const vk::MemoryBarrier barrier(vk::AccessFlagBits::eTransferWrite, vk::AccessFlagBits::eHostRead);
+        commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eHost, {}, barrier, {}, {}, mDevice.getVkDispatcher());
+
+        slot.command->end();
+        slot.command->execute();
+
+        slot.ticket          = ++mLastTicket;
+        slot.size            = size;
+        slot.submissionIndex = slot.command->getLastSubmissionIndex();
+        ++mStats.requestNum;
+
+        return slot.ticket;
+    }
+}  // namespace vk2s
@@ -13,10 +13,19 @@ namespace vk2s
 {
     Semaphore::Semaphore(Device& device)
         : mDevice(device)
+        , mTimeline(false)
     {
         mSemaphore = mDevice.getVkDevice()->createSemaphoreUnique(vk::SemaphoreCreateInfo{});
     }
 
+    Semaphore::Semaphore(Device& device, const uint64_t initialValue)
+        : mDevice(device)
+        , mTimeline(true)
+    {
+        vk::SemaphoreTypeCreateInfo typeInfo(vk::SemaphoreType::eTimeline, initialValue);
+        mSemaphore = mDevice.getVkDevice()->createSemaphoreUnique(vk::SemaphoreCreateInfo({}, &typeInfo));
+    }
+
     Semaphore::~Semaphore()
     {
 
@@ -27,4 +36,29 @@ namespace vk2s
         return mSemaphore;
     }
 
+    bool Semaphore::isTimeline() const
+    {
+        return mTimeline;
+    }
+
+    uint64_t Semaphore::getValue() const
+    {
+        assert(mTimeline || !"binary semaphore has no counter!");
+        return mDevice.getVkDevice()->getSemaphoreCounterValue(mSemaphore.get());
+    }
+
+    void Semaphore::signal(const uint64_t value)
+    {
+        assert(mTimeline || !"binary semaphore can't be signaled from the host!");
+        mDevice.getVkDevice()->signalSemaphore(vk::SemaphoreSignalInfo(mSemaphore.get(), value));
+    }
+
+    bool Semaphore::wait(const uint64_t value, const uint64_t timeout) const
+    {
+        assert(mTimeline || !"binary semaphore can't be waited on the host!");
+        const auto res = mDevice.getVkDevice()->waitSemaphores(vk::SemaphoreWaitInfo({}, mSemaphore.get(), value), timeout);
+
+        return res == vk::Result::eSuccess;
+    }
+
 }  // namespace vk2s
\ No newline at end of file
@@ -72,7 +72,9 @@ namespace vk2s
         mSBTInfo.hit.size          = regionHit;
         mSBTInfo.hit.stride        = hitShaderEntrySize;
 
-        std::byte* dst = static_cast<std::byte*>(vkDevice->mapMemory(mShaderBindingTable->getVkDeviceMemory().get(), 0, mShaderBindingTable->getSize()));
+        // host visible memory is persistently mapped by MemoryAllocator
+        std::byte* dst = mShaderBindingTable->getMemoryAllocation().getMappedPointer();
+        assert(dst || !"failed to map memory!");
         {
             // write the entry of ray generation shader
             memcpy(dst, shaderHandleStorage.data(), handleSize);
@@ -102,8 +104,6 @@ namespace vk2s
             //mSBTInfo.callable.size          = regionCallable;
             //mSBTInfo.callable.stride        = callableShaderEntrySize;
         }
-
-        vkDevice->unmapMemory(mShaderBindingTable->getVkDeviceMemory().get());
     }
 
     // for additional entry writing
@@ -167,7 +167,9 @@ namespace vk2s
         mSBTInfo.hit.size          = regionHit;
         mSBTInfo.hit.stride        = hitShaderEntrySize;
 
-        std::byte* dst = static_cast<std::byte*>(vkDevice->mapMemory(mShaderBindingTable->getVkDeviceMemory().get(), 0, mShaderBindingTable->getSize()));
+        // host visible memory is persistently mapped by MemoryAllocator
+        std::byte* dst = mShaderBindingTable->getMemoryAllocation().getMappedPointer();
+        assert(dst || !"failed to map memory!");
         {
             std::byte* pStart = dst;
 
@@ -213,7 +215,6 @@ namespace vk2s
             }
         }
 
-        vkDevice->unmapMemory(mShaderBindingTable->getVkDeviceMemory().get());
     }
 
     ShaderBindingTable::~ShaderBindingTable()
@@ -0,0 +1,393 @@
+/*****************************************************************/ /**
+ * @file   TextureResidency.cpp
+ * @brief  source file of TextureResidency class
+ *
+ * @author agent
+ * @date   October 2026
+ *********************************************************************/
+#include "../include/vk2s/TextureResidency.hpp"
+
+#include "../include/vk2s/Device.hpp"
+#include "../include/vk2s/Compiler.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <memory>
+
+namespace vk2s
+{
+    namespace
+    {
+        //! whether the format can be downsampled on the host (8bit 4 channels) and whether its color channels are sRGB encoded
+        std::pair<bool, bool> getDownsampleSupport(const vk::Format format)
+        {
+            switch (format)
+            {
+            case vk::Format::eR8G8B8A8Unorm:
+            case vk::Format::eB8G8R8A8Unorm:
+                return { true, false };
+            case vk::Format::eR8G8B8A8Srgb:
+            case vk::Format::eB8G8R8A8Srgb:
+                return { true, true };
+            default:
+                return { false, false };
+            }
+        }
+
+        //! sRGB encoded 8bit value to linear
+        float decodeSRGB(const uint8_t value)
+        {
+            static const auto table = []()
+            {
+                std::array<float, 256> rtn;
+                for (size_t i = 0; i < rtn.size(); ++i)
+                {
+                    const float c = static_cast<float>(i) / 255.f;
+                    rtn[i]        = c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+                }
+                return rtn;
+            }();
+
+            return table[value];
+        }
+
+        //! linear to sRGB encoded 8bit value
+        uint8_t encodeSRGB(const float value)
+        {
+            const float c = value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.f / 2.4f) - 0.055f;
+            return static_cast<uint8_t>(std::clamp(c * 255.f + 0.5f, 0.f, 255.f));
+        }
+    }  // namespace
+
+    TextureResidency::TextureResidency(Device& device, const vk::DeviceSize budget, const uint32_t fallbackSize)
+        : mDevice(device)
+        , mFallbackSize(std::max(fallbackSize, 1u))
+        , mBudget(budget)
+        , mStreamBytesPerFrame(kDefaultStreamBytesPerFrame)
+        , mFrame(0)
+    {
+        // mid grey, used for formats that can't be downsampled
+        const uint8_t neutral[4] = { 128, 128, 128, 255 };
+        mNeutralFallback         = createImage(1, 1, vk::Format::eR8G8B8A8Unorm, neutral, sizeof(neutral));
+        mStats.fallbackBytes     = sizeof(neutral);
+    }
+
+    TextureResidency::~TextureResidency()
+    {
+        // Images may still be referenced by frames in flight
+        for (auto& entry : mEntries)
+        {
+            if (entry.image)
+            {
+                mDevice.destroyDeferred(entry.image);
+            }
+            if (entry.fallback)
+            {
+                mDevice.destroyDeferred(entry.fallback);
+            }
+        }
+
+        mDevice.destroyDeferred(mNeutralFallback);
+    }
+
+    uint32_t TextureResidency::add(const uint32_t width, const uint32_t height, const vk::Format format, Loader loader, const bool resident)
+    {
+        const vk::DeviceSize size = static_cast<vk::DeviceSize>(width) * height * Compiler::getSizeOfFormat(format);
+
+        // the mip chain is generated by linear blits if the format supports them, as Image does for files
+        const auto features         = mDevice.getVkPhysicalDevice().getFormatProperties(format).optimalTilingFeatures;
+        const auto blitFeatures     = vk::FormatFeatureFlagBits::eBlitSrc | vk::FormatFeatureFlagBits::eBlitDst | vk::FormatFeatureFlagBits::eSampledImageFilterLinear;
+        const uint32_t mipLevels    = (features & blitFeatures) == blitFeatures ? Image::calcMipLevels(width, height) : 1;
+        vk::DeviceSize residentSize = 0;
+        for (uint32_t level = 0; level < mipLevels; ++level)
+        {
+            residentSize += static_cast<vk::DeviceSize>(std::max(width >> level, 1u)) * std::max(height >> level, 1u) * Compiler::getSizeOfFormat(format);
+        }
+
+        Handle<Image> fallback;
+        vk::DeviceSize fallbackBytes = 0;
+        if (const auto [downsample, srgb] = getDownsampleSupport(format); downsample && (width > mFallbackSize || height > mFallbackSize))
+        {
+            const auto texels = loader();
+            assert(texels.size() >= size || !"the loader returned fewer texels than the texture size!");
+
+            // box filter over power of 2 blocks, color channels are averaged in linear space
+            uint32_t scale = 1;
+            while (width / scale > mFallbackSize || height / scale > mFallbackSize)
+            {
+                scale *= 2;
+            }
+            const uint32_t fw = std::max(width / scale, 1u);
+            const uint32_t fh = std::max(height / scale, 1u);
+
+            std::vector<uint8_t> downsampled(fw * fh * 4);
+            const auto* pSrc = reinterpret_cast<const uint8_t*>(texels.data());
+            for (uint32_t y = 0; y < fh; ++y)
+            {
+                for (uint32_t x = 0; x < fw; ++x)
+                {
+                    std::array<float, 4> sum{};
+                    uint32_t count = 0;
+                    for (uint32_t sy = y * scale; sy < std::min((y + 1) * scale, height); ++sy)
+                    {
+                        for (uint32_t sx = x * scale; sx < std::min((x + 1) * scale, width); ++sx)
+                        {
+                            const uint8_t* pTexel = pSrc + (static_cast<size_t>(sy) * width + sx) * 4;
+                            for (uint32_t c = 0; c < 4; ++c)
+                            {
+                                sum[c] += srgb && c < 3 ? decodeSRGB(pTexel[c]) : pTexel[c] / 255.f;
+                            }
+                            ++count;
+                        }
+                    }
+
+                    uint8_t* pDst = &downsampled[(y * fw + x) * 4];
+                    for (uint32_t c = 0; c < 4; ++c)
+                    {
+                        const float average = sum[c] / count;
+                        pDst[c]             = srgb && c < 3 ? encodeSRGB(average) : static_cast<uint8_t>(std::clamp(average * 255.f + 0.5f, 0.f, 255.f));
+                    }
+                }
+            }
+
+            fallback      = createImage(fw, fh, format, downsampled.data(), downsampled.size());
+            fallbackBytes = downsampled.size();
+        }
+        else if (downsample)
+        {
+            // small enough to be its own fallback
+            const auto texels = loader();
+            fallback          = createImage(width, height, format, texels.data(), static_cast<size_t>(size));
+            fallbackBytes     = size;
+        }
+
+        uint32_t id = 0;
+        {
+            std::lock_guard lock(mMutex);
+
+            id                  = static_cast<uint32_t>(mEntries.size());
+            auto& entry         = mEntries.emplace_back();
+            entry.width         = width;
+            entry.height        = height;
+            entry.format        = format;
+            entry.loader        = std::move(loader);
+            entry.size          = size;
+            entry.mipLevels     = mipLevels;
+            entry.residentSize  = residentSize;
+            entry.fallback      = fallback;
+            entry.lastUsedFrame = mFrame;
+            entry.requested     = false;
+
+            ++mStats.textureNum;
+            mStats.fallbackBytes += fallbackBytes;
+        }
+
+        if (resident)
+        {
+            stream(id);
+        }
+
+        return id;
+    }
+
+    uint32_t TextureResidency::add(std::span<const std::byte> texels, const uint32_t width, const uint32_t height, const vk::Format format, const bool resident)
+    {
+        auto pTexels = std::make_shared<const std::vector<std::byte>>(texels.begin(), texels.end());
+        return add(width, height, format, [pTexels]() { return *pTexels; }, resident);
+    }
+
+    Handle<Image> TextureResidency::use(const uint32_t id)
+    {
+        std::lock_guard lock(mMutex);
+
+        assert(id < mEntries.size() || !"invalid texture ID!");
+        auto& entry         = mEntries[id];
+        entry.lastUsedFrame = mFrame;
+
+        if (entry.image)
+        {
+            mLRU.splice(mLRU.begin(), mLRU, entry.lruIter);
+            return entry.image;
+        }
+
+        entry.requested = true;
+        return entry.fallback ? entry.fallback : mNeutralFallback;
+    }
+
+    bool TextureResidency::isResident(const uint32_t id) const
+    {
+        std::lock_guard lock(mMutex);
+
+        assert(id < mEntries.size() || !"invalid texture ID!");
+        return static_cast<bool>(mEntries[id].image);
+    }
+
+    bool TextureResidency::update()
+    {
+        std::unique_lock lock(mMutex);
+
+        const vk::DeviceSize budget = computeBudget();
+        mStats.budgetBytes          = budget;
+
+        bool changed = false;
+
+        // textures used in frames in flight can't be evicted
+        const auto evictable = [&]() { return !mLRU.empty() && mFrame - mEntries[mLRU.back()].lastUsedFrame >= kMinIdleFrames; };
+
+        // stream the requested textures, most recently used first
+        std::vector<uint32_t> requests;
+        for (uint32_t id = 0; id < mEntries.size(); ++id)
+        {
+            if (mEntries[id].requested && !mEntries[id].image)
+            {
+                requests.emplace_back(id);
+            }
+        }
+        std::sort(requests.begin(), requests.end(), [&](const uint32_t l, const uint32_t r) { return mEntries[l].lastUsedFrame > mEntries[r].lastUsedFrame; });
+
+        vk::DeviceSize streamedBytes = 0;
+        for (const auto id : requests)
+        {
+            const vk::DeviceSize residentSize = mEntries[id].residentSize;
+            if (streamedBytes > 0 && streamedBytes + residentSize > mStreamBytesPerFrame)
+            {
+                break;
+            }
+
+            while (mStats.residentBytes + residentSize > budget && evictable())
+            {
+                evict(mLRU.back());
+                changed = true;
+            }
+
+            if (mStats.residentBytes + residentSize > budget)
+            {
+                // stays on the fallback until something becomes evictable (requested again by the next use())
+                mEntries[id].requested = false;
+                continue;
+            }
+
+            // use() keeps returning the fallback while the texture loads
+            lock.unlock();
+            stream(id);
+            lock.lock();
+
+            streamedBytes += residentSize;
+            changed = true;
+        }
+
+        // the budget may have shrunk (e.g. other processes or resources took the heap)
+        while (mStats.residentBytes > budget && evictable())
+        {
+            evict(mLRU.back());
+            changed = true;
+        }
+
+        ++mFrame;
+
+        return changed;
+    }
+
+    void TextureResidency::setBudget(const vk::DeviceSize budget)
+    {
+        std::lock_guard lock(mMutex);
+        mBudget = budget;
+    }
+
+    void TextureResidency::setStreamBytesPerFrame(const vk::DeviceSize bytes)
+    {
+        std::lock_guard lock(mMutex);
+        mStreamBytesPerFrame = bytes;
+    }
+
+    TextureResidency::Statistics TextureResidency::getStatistics() const
+    {
+        std::lock_guard lock(mMutex);
+        return mStats;
+    }
+
+    Handle<Image> TextureResidency::createImage(const uint32_t width, const uint32_t height, const vk::Format format, const void* pTexels, const size_t size, const uint32_t mipLevels)
+    {
+        vk::ImageCreateInfo ci;
+        ci.arrayLayers   = 1;
+        ci.extent        = vk::Extent3D(width, height, 1);
+        ci.format        = format;
+        ci.imageType     = vk::ImageType::e2D;
+        ci.mipLevels     = mipLevels;
+        ci.usage         = vk::ImageUsageFlagBits::eSampled | vk::ImageUsageFlagBits::eTransferDst;
+        if (mipLevels > 1)
+        {
+            // read by the blits generating the mip chain
+            ci.usage |= vk::ImageUsageFlagBits::eTransferSrc;
+        }
+        ci.initialLayout = vk::ImageLayout::eUndefined;
+
+        Handle<Image> image = mDevice.create<Image>(ci, vk::MemoryPropertyFlagBits::eDeviceLocal, size, vk::ImageAspectFlagBits::eColor);
+        // streamed in without stalling, the first draw reading it is submitted after the upload on the graphics queue
+        image->writeAsync(pTexels, size);
+
+        return image;
+    }
+
+    void TextureResidency::stream(const uint32_t id)
+    {
+        // copied out so that add() may grow mEntries while the texture loads
+        Loader loader;
+        uint32_t width = 0, height = 0, mipLevels = 1;
+        vk::Format format   = vk::Format::eUndefined;
+        vk::DeviceSize size = 0;
+        {
+            std::lock_guard lock(mMutex);
+
+            const auto& entry = mEntries[id];
+            loader            = entry.loader;
+            width             = entry.width;
+            height            = entry.height;
+            format            = entry.format;
+            size              = entry.size;
+            mipLevels         = entry.mipLevels;
+        }
+
+        // disk I/O, decoding and staging run without the lock
+        const auto texels = loader();
+        assert(texels.size() >= size || !"the loader returned fewer texels than the texture size!");
+        Handle<Image> image = createImage(width, height, format, texels.data(), static_cast<size_t>(size), mipLevels);
+
+        std::lock_guard lock(mMutex);
+
+        auto& entry     = mEntries[id];
+        entry.image     = image;
+        entry.requested = false;
+        entry.lruIter   = mLRU.emplace(mLRU.begin(), id);
+
+        mStats.residentBytes += entry.residentSize;
+        ++mStats.residentNum;
+        ++mStats.streamNum;
+    }
+
+    void TextureResidency::evict(const uint32_t id)
+    {
+        auto& entry = mEntries[id];
+
+        mDevice.destroyDeferred(entry.image);
+        mLRU.erase(entry.lruIter);
+
+        mStats.residentBytes -= entry.residentSize;
+        --mStats.residentNum;
+        ++mStats.evictionNum;
+    }
+
+    vk::DeviceSize TextureResidency::computeBudget() const
+    {
+        if (mBudget != 0)
+        {
+            return mBudget;
+        }
+
+        // what is resident now plus most of what the device local heap can still take (the rest is left for other resources)
+        const vk::DeviceSize available = mDevice.getMemoryAllocator().getAvailableBudget(vk::MemoryPropertyFlagBits::eDeviceLocal);
+        return mStats.residentBytes + available / 10 * 9;
+    }
+}  // namespace vk2s
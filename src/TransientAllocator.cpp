@@ -0,0 +1,146 @@
+/*****************************************************************/ /**
+ * @file   TransientAllocator.cpp
+ * @brief  source file of TransientAllocator class
+ *
+ * @author agent
+ * @date   October 2026
+ *********************************************************************/
+#include "../include/vk2s/TransientAllocator.hpp"
+
+#include "../include/vk2s/Device.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <stdexcept>
+
+namespace vk2s
+{
+    TransientAllocator::TransientAllocator(Device& device, const vk::BufferUsageFlags usage, const vk::DeviceSize ringSize, const vk::DeviceSize bindingRange)
+        : mDevice(device)
+        , mHead(0)
+        , mTail(0)
+        , mFrameBegin(0)
+    {
+        assert(ringSize >= bindingRange || !"the ring must be larger than the binding range!");
+
+        const auto limits = mDevice.getVkPhysicalDevice().getProperties().limits;
+        mAlignment        = 1;
+        if (usage & vk::BufferUsageFlagBits::eUniformBuffer)
+        {
+            mAlignment = std::max(mAlignment, limits.minUniformBufferOffsetAlignment);
+        }
+        if (usage & vk::BufferUsageFlagBits::eStorageBuffer)
+        {
+            mAlignment = std::max(mAlignment, limits.minStorageBufferOffsetAlignment);
+        }
+
+        // DynamicBuffer aligns the blocks only to minUniformBufferOffsetAlignment, the ring wraps at a block boundary so it must be aligned to mAlignment too
+        const vk::DeviceSize blockSize = mDevice.align(bindingRange, static_cast<uint32_t>(mAlignment));
+
+        // one extra block at the end keeps bindingRange bytes readable from the last offsets of the ring
+        const uint32_t blockNum = static_cast<uint32_t>((ringSize + blockSize - 1) / blockSize) + 1;
+        mBuffer                 = mDevice.create<DynamicBuffer>(vk::BufferCreateInfo({}, blockSize * blockNum, usage), vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent, blockNum);
+
+        mBindingRange = mBuffer->getBlockSize();
+        mRingSize     = mBindingRange * (blockNum - 1);
+        assert(mRingSize % mAlignment == 0 || !"the ring size is not aligned to the dynamic offset alignment!");
+        mpMapped      = static_cast<std::byte*>(mBuffer->getMappedPointer());
+        assert(mpMapped || !"failed to map memory!");
+    }
+
+    TransientAllocator::~TransientAllocator()
+    {
+        // may still be read by frames in flight
+        mDevice.destroyDeferred(mBuffer);
+    }
+
+    void TransientAllocator::beginFrame()
+    {
+        std::lock_guard lock(mMutex);
+
+        // every submission reading the previous frame has been issued by now
+        if (mHead != mFrameBegin)
+        {
+            mFrameRanges.emplace_back(FrameRange{ mDevice.getLatestSubmissionIndex(), mHead });
+        }
+        mFrameBegin       = mHead;
+        mStats.frameBytes = 0;
+
+        reclaim();
+    }
+
+    TransientAllocator::Allocation TransientAllocator::allocate(const vk::DeviceSize size)
+    {
+        assert(size <= mBindingRange || !"the allocation is larger than the binding range!");
+
+        std::lock_guard lock(mMutex);
+
+        bool reclaimed = false;
+        while (true)
+        {
+            // an allocation never wraps around the end of the ring
+            uint64_t begin = (mHead + mAlignment - 1) / mAlignment * mAlignment;
+            if (begin % mRingSize + size > mRingSize)
+            {
+                begin = (begin / mRingSize + 1) * mRingSize;
+            }
+
+            if (begin + size - mTail <= mRingSize)
+            {
+                mHead = begin + size;
+
+                ++mStats.allocationNum;
+                mStats.frameBytes += size;
+                mStats.peakFrameBytes = std::max(mStats.peakFrameBytes, mStats.frameBytes);
+
+                const vk::DeviceSize offset = begin % mRingSize;
+                return Allocation{ mBuffer, offset, mpMapped + offset };
+            }
+
+            if (!reclaimed)
+            {
+                reclaim();
+                reclaimed = true;
+                continue;
+            }
+
+            if (mFrameRanges.empty())
+            {
+                throw std::runtime_error("the transient ring is too small for the allocations of a frame!");
+            }
+
+            mDevice.waitSubmission(mFrameRanges.front().submissionIndex);
+            ++mStats.stallNum;
+            reclaim();
+        }
+    }
+
+    Handle<DynamicBuffer> TransientAllocator::getBuffer() const
+    {
+        return mBuffer;
+    }
+
+    TransientAllocator::Statistics TransientAllocator::getStatistics() const
+    {
+        std::lock_guard lock(mMutex);
+        return mStats;
+    }
+
+    void TransientAllocator::reclaim()
+    {
+        const uint64_t completed = mDevice.getCompletedSubmissionIndex();
+        while (!mFrameRanges.empty() && mFrameRanges.front().submissionIndex <= completed)
+        {
+            mTail = mFrameRanges.front().end;
+            mFrameRanges.pop_front();
+        }
+
+        // the ring is empty, start from its beginning
+        if (mFrameRanges.empty() && mFrameBegin == mHead)
+        {
+            mHead       = 0;
+            mTail       = 0;
+            mFrameBegin = 0;
+        }
+    }
+}  // namespace vk2s
@@ -0,0 +1,397 @@
+/*****************************************************************/ /**
+ * @file   Uploader.cpp
+ * @brief  source file of Uploader class
+ *
+ * @author agent
+ * @date   October 2026
+ *********************************************************************/
+#include "../include/vk2s/Uploader.hpp"
+
+#include "../include/vk2s/Device.hpp"
+#include "../include/vk2s/Compiler.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <numeric>
+#include <stdexcept>
+
+namespace vk2s
+{
+    namespace
+    {
+        //! staging offsets of image copies must be a multiple of both 4 and the texel size
+        vk::DeviceSize getStagingAlignment(const vk::Format format)
+        {
+            const vk::DeviceSize texelSize = std::max(Compiler::getSizeOfFormat(format), 1u);
+            return std::lcm<vk::DeviceSize>(4, texelSize);
+        }
+    }  // namespace
+
+    Uploader::Uploader(Device& device, const vk::DeviceSize ringSize)
+        : mDevice(device)
+        , mRingSize(ringSize)
+        , mHead(0)
+        , mTail(0)
+        , mSubmittedHead(0)
+    {
+        assert(mRingSize > 0 || !"the ring size must not be 0!");
+    }
+
+    Uploader::~Uploader()
+    {
+        // called after Device::waitIdle(), nothing is in flight
+        for (auto& buffer : mOversizedBuffers)
+        {
+            mDevice.destroy(buffer);
+        }
+
+        for (auto& command : mCommands)
+        {
+            mDevice.destroy(command);
+        }
+
+        if (mRing)
+        {
+            mDevice.destroy(mRing);
+        }
+    }
+
+    void Uploader::enqueue(Buffer& dst, const void* pSrc, const vk::DeviceSize size, const vk::DeviceSize dstOffset)
+    {
+        assert(dstOffset + size <= dst.getSize() || !"the upload is out of the buffer!");
+
+        std::lock_guard lock(mMutex);
+
+        const auto [src, srcOffset] = stage(pSrc, size, 4);
+        mBufferCopies.emplace_back(BufferCopy{ src, dst.getVkBuffer().get(), vk::BufferCopy(srcOffset, dstOffset, size) });
+
+        ++mStats.bufferUploadNum;
+        mStats.uploadedBytes += size;
+    }
+
+    void Uploader::enqueue(Image& dst, const void* pSrc, const vk::DeviceSize size, const vk::ImageLayout finalLayout)
+    {
+        validateImageUpload(dst, size, 0, 0, true);
+
+        std::lock_guard lock(mMutex);
+
+        const auto [src, srcOffset] = stage(pSrc, size, getStagingAlignment(dst.getVkFormat()));
+        queueImageCopy(dst, src, srcOffset, 0, 0, true, finalLayout);
+
+        ++mStats.imageUploadNum;
+        mStats.uploadedBytes += size;
+    }
+
+    uint64_t Uploader::uploadBatch(std::span<const ImageUpload> uploads, const Handle<Fence>& signalFence)
+    {
+        assert(!uploads.empty() || !"empty upload batch!");
+
+        // pack every subresource into a single staging range
+        std::vector<vk::DeviceSize> offsets;
+        offsets.reserve(uploads.size());
+        vk::DeviceSize totalSize     = 0;
+        vk::DeviceSize baseAlignment = 4;
+        for (const auto& upload : uploads)
+        {
+            // a failure past allocateStaging() would leave the staging range and the queued copies half written
+            validateImageUpload(upload.image.get(), upload.size, upload.mipLevel, upload.arrayLayer, upload.generateMipmaps);
+
+            const vk::DeviceSize alignment = getStagingAlignment(upload.image->getVkFormat());
+            totalSize                      = (totalSize + alignment - 1) / alignment * alignment;
+            baseAlignment                  = std::lcm(baseAlignment, alignment);
+            offsets.emplace_back(totalSize);
+            totalSize += upload.size;
+        }
+
+        std::lock_guard lock(mMutex);
+
+        const auto [pStaging, baseOffset] = allocateStaging(totalSize, baseAlignment);
+        const vk::Buffer src              = pStaging->getVkBuffer().get();
+        for (size_t i = 0; i < uploads.size(); ++i)
+        {
+            const auto& upload = uploads[i];
+            pStaging->write(upload.pData, upload.size, baseOffset + offsets[i]);
+            queueImageCopy(upload.image.get(), src, baseOffset + offsets[i], upload.mipLevel, upload.arrayLayer, upload.generateMipmaps, upload.finalLayout);
+
+            ++mStats.imageUploadNum;
+            mStats.uploadedBytes += upload.size;
+        }
+
+        return submitInternal(signalFence);
+    }
+
+    uint64_t Uploader::submit()
+    {
+        std::lock_guard lock(mMutex);
+        return submitInternal();
+    }
+
+    bool Uploader::isCompleted(const uint64_t submissionIndex) const
+    {
+        return submissionIndex <= mDevice.getCompletedSubmissionIndex();
+    }
+
+    Uploader::Statistics Uploader::getStatistics() const
+    {
+        std::lock_guard lock(mMutex);
+        return mStats;
+    }
+
+    void Uploader::validateImageUpload(Image& dst, const vk::DeviceSize size, const uint32_t mipLevel, const uint32_t arrayLayer, const bool generateMipmaps) const
+    {
+        // the GPU would read past the staged data or write to a missing subresource, so these are rejected in release builds too
+        if (mipLevel >= dst.getMipLevels())
+        {
+            throw std::runtime_error("the mip level of the upload is out of the image!");
+        }
+
+        if (arrayLayer >= dst.getArrayLayers())
+        {
+            throw std::runtime_error("the array layer of the upload is out of the image!");
+        }
+
+        const auto extent              = dst.getVkExtent();
+        const vk::DeviceSize texelSize = Compiler::getSizeOfFormat(dst.getVkFormat());
+        const vk::DeviceSize texelNum  = static_cast<vk::DeviceSize>(std::max(extent.width >> mipLevel, 1u)) * std::max(extent.height >> mipLevel, 1u) * std::max(extent.depth >> mipLevel, 1u);
+        if (texelSize != 0 && size < texelSize * texelNum)
+        {
+            throw std::runtime_error("the upload is smaller than the subresource!");
+        }
+
+        if (generateMipmaps && mipLevel == 0 && dst.getMipLevels() > 1)
+        {
+            const auto features = mDevice.getVkPhysicalDevice().getFormatProperties(dst.getVkFormat()).optimalTilingFeatures;
+            if (!(features & vk::FormatFeatureFlagBits::eBlitSrc) || !(features & vk::FormatFeatureFlagBits::eBlitDst))
+            {
+                throw std::runtime_error("the format of the image doesn't support blits for generating mip levels!");
+            }
+        }
+    }
+
+    std::pair<vk::Buffer, vk::DeviceSize> Uploader::stage(const void* pSrc, const vk::DeviceSize size, const vk::DeviceSize alignment)
+    {
+        const auto [pBuffer, offset] = allocateStaging(size, alignment);
+        pBuffer->write(pSrc, size, offset);
+
+        return { pBuffer->getVkBuffer().get(), offset };
+    }
+
+    std::pair<Buffer*, vk::DeviceSize> Uploader::allocateStaging(const vk::DeviceSize size, const vk::DeviceSize alignment)
+    {
+        const vk::MemoryPropertyFlags hostMemProps = vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent;
+
+        if (size > mRingSize)
+        {
+            Handle<Buffer> buffer = mDevice.create<Buffer>(vk::BufferCreateInfo({}, size, vk::BufferUsageFlagBits::eTransferSrc), hostMemProps);
+            mOversizedBuffers.emplace_back(buffer);
+            ++mStats.oversizedNum;
+
+            return { &buffer.get(), 0 };
+        }
+
+        if (!mRing)
+        {
+            mRing = mDevice.create<Buffer>(vk::BufferCreateInfo({}, mRingSize, vk::BufferUsageFlagBits::eTransferSrc), hostMemProps);
+        }
+
+        while (true)
+        {
+            // a range never wraps around the end of the ring
+            uint64_t begin = (mHead + alignment - 1) / alignment * alignment;
+            if (begin % mRingSize + size > mRingSize)
+            {
+                begin = (begin / mRingSize + 1) * mRingSize;
+            }
+
+            if (begin + size - mTail <= mRingSize)
+            {
+                mHead = begin + size;
+                return { &mRing.get(), begin % mRingSize };
+            }
+
+            // every range left after reclaim() is still read by the GPU
+            reclaim();
+            if (!mInFlightRanges.empty())
+            {
+                // the queued uploads must be submitted before their space can be recycled
+                if (mSubmittedHead != mHead)
+                {
+                    submitInternal();
+                }
+
+                mDevice.waitSubmission(mInFlightRanges.front().submissionIndex);
+                ++mStats.stallNum;
+                reclaim();
+            }
+            else if (mSubmittedHead != mHead)
+            {
+                submitInternal();
+            }
+        }
+    }
+
+    void Uploader::queueImageCopy(Image& dst, const vk::Buffer src, const vk::DeviceSize srcOffset, const uint32_t mipLevel, const uint32_t arrayLayer, const bool generateMipmaps, const vk::ImageLayout finalLayout)
+    {
+        // the other mip levels are generated by blits from the first one (linear filtering if supported), blit support is checked by validateImageUpload()
+        const uint32_t mipLevels = generateMipmaps && mipLevel == 0 ? dst.getMipLevels() : 1;
+        vk::Filter filter        = vk::Filter::eNearest;
+        if (mipLevels > 1)
+        {
+            const auto features = mDevice.getVkPhysicalDevice().getFormatProperties(dst.getVkFormat()).optimalTilingFeatures;
+            if (features & vk::FormatFeatureFlagBits::eSampledImageFilterLinear)
+            {
+                filter = vk::Filter::eLinear;
+            }
+        }
+
+        const auto extent = dst.getVkExtent();
+
+        vk::BufferImageCopy region;
+        region.bufferOffset                    = srcOffset;
+        region.bufferRowLength                 = 0;
+        region.bufferImageHeight               = 0;
+        region.imageSubresource.aspectMask     = dst.getVkAspectFlag();
+        region.imageSubresource.mipLevel       = mipLevel;
+        region.imageSubresource.baseArrayLayer = arrayLayer;
+        region.imageSubresource.layerCount     = 1;
+        region.imageOffset                     = vk::Offset3D(0, 0, 0);
+        region.imageExtent                     = vk::Extent3D(std::max(extent.width >> mipLevel, 1u), std::max(extent.height >> mipLevel, 1u), std::max(extent.depth >> mipLevel, 1u));
+
+        mImageCopies.emplace_back(ImageCopy{ src, dst.getVkImage().get(), region, finalLayout, mipLevels, filter });
+    }
+
+    void Uploader::reclaim()
+    {
+        const uint64_t completed = mDevice.getCompletedSubmissionIndex();
+        while (!mInFlightRanges.empty() && mInFlightRanges.front().submissionIndex <= completed)
+        {
+            mTail = mInFlightRanges.front().end;
+            mInFlightRanges.pop_front();
+        }
+
+        // the ring is empty, start from its beginning so that any range up to the ring size fits
+        if (mInFlightRanges.empty() && mSubmittedHead == mHead)
+        {
+            mHead          = 0;
+            mTail          = 0;
+            mSubmittedHead = 0;
+        }
+    }
+
+    uint64_t Uploader::submitInternal(const Handle<Fence>& signalFence)
+    {
+        if (mBufferCopies.empty() && mImageCopies.empty())
+        {
+            // a range allocated without queueing a copy is never read by the GPU, so reclaim() may recycle it
+            mSubmittedHead = mHead;
+            return 0;
+        }
+
+        // reuse a command the GPU has retired
+        const uint64_t completed = mDevice.getCompletedSubmissionIndex();
+        auto iter                = std::find_if(mCommands.begin(), mCommands.end(), [completed](const Handle<Command>& command) { return command->getLastSubmissionIndex() <= completed; });
+        Handle<Command> command  = iter != mCommands.end() ? *iter : mCommands.emplace_back(mDevice.create<Command>(QueueType::eGraphics));
+
+        std::vector<vk::ImageMemoryBarrier> toTransferBarriers;
+        std::vector<vk::ImageMemoryBarrier> toFinalBarriers;
+        toTransferBarriers.reserve(mImageCopies.size());
+        toFinalBarriers.reserve(mImageCopies.size() * 2);
+        uint32_t maxMipLevels = 1;
+        for (const auto& copy : mImageCopies)
+        {
+            const auto aspect    = copy.region.imageSubresource.aspectMask;
+            const uint32_t base  = copy.region.imageSubresource.mipLevel;
+            const uint32_t layer = copy.region.imageSubresource.baseArrayLayer;
+            toTransferBarriers.emplace_back(vk::AccessFlagBits::eNone, vk::AccessFlagBits::eTransferWrite, vk::ImageLayout::eUndefined, vk::ImageLayout::eTransferDstOptimal, VK_QUEUE_FAMILY_IGNORED, VK_QUEUE_FAMILY_IGNORED,
+                                            copy.dst, vk::ImageSubresourceRange(aspect, base, copy.mipLevels, layer, 1));
+
+            // the levels but the last one are read by the blits generating the mip chain
+            if (copy.mipLevels > 1)
+            {
+                toFinalBarriers.emplace_back(vk::AccessFlagBits::eTransferRead, vk::AccessFlagBits::eMemoryRead, vk::ImageLayout::eTransferSrcOptimal, copy.finalLayout, VK_QUEUE_FAMILY_IGNORED, VK_QUEUE_FAMILY_IGNORED,
+                                             copy.dst, vk::ImageSubresourceRange(aspect, base, copy.mipLevels - 1, layer, 1));
+            }
+            toFinalBarriers.emplace_back(vk::AccessFlagBits::eTransferWrite, vk::AccessFlagBits::eMemoryRead, vk::ImageLayout::eTransferDstOptimal, copy.finalLayout, VK_QUEUE_FAMILY_IGNORED, VK_QUEUE_FAMILY_IGNORED, copy.dst,
+                                         vk::ImageSubresourceRange(aspect, base + copy.mipLevels - 1, 1, layer, 1));
+
+            maxMipLevels = std::max(maxMipLevels, copy.mipLevels);
+        }
+
+        command->reset();
+        command->begin(true);
+        const vk::CommandBuffer commandBuffer = command->getVkCommandBuffer().get();
+        const auto& dispatcher                = mDevice.getVkDispatcher();
+
+        // earlier submissions on the queue may still read (or write) the destinations, the copies must wait for them
+        const vk::MemoryBarrier toCopy(vk::AccessFlagBits::eMemoryRead | vk::AccessFlagBits::eMemoryWrite, vk::AccessFlagBits::eTransferWrite);
+        commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eAllCommands, vk::PipelineStageFlagBits::eTransfer, {}, toCopy, {}, toTransferBarriers, dispatcher);
+
+        for (const auto& copy : mBufferCopies)
+        {
+            commandBuffer.copyBuffer(copy.src, copy.dst, copy.region, dispatcher);
+        }
+
+        for (const auto& copy : mImageCopies)
+        {
+            commandBuffer.copyBufferToImage(copy.src, copy.dst, vk::ImageLayout::eTransferDstOptimal, copy.region, dispatcher);
+        }
+
+        // generate the mip chains level by level, batching the barriers and blits of every image
+        std::vector<vk::ImageMemoryBarrier> toBlitBarriers;
+        for (uint32_t level = 1; level < maxMipLevels; ++level)
+        {
+            toBlitBarriers.clear();
+            for (const auto& copy : mImageCopies)
+            {
+                if (level < copy.mipLevels)
+                {
+                    toBlitBarriers.emplace_back(vk::AccessFlagBits::eTransferWrite, vk::AccessFlagBits::eTransferRead, vk::ImageLayout::eTransferDstOptimal, vk::ImageLayout::eTransferSrcOptimal, VK_QUEUE_FAMILY_IGNORED,
+                                                VK_QUEUE_FAMILY_IGNORED, copy.dst,
+                                                vk::ImageSubresourceRange(copy.region.imageSubresource.aspectMask, level - 1, 1, copy.region.imageSubresource.baseArrayLayer, 1));
+                }
+            }
+            commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eTransfer, {}, {}, {}, toBlitBarriers, dispatcher);
+
+            for (const auto& copy : mImageCopies)
+            {
+                if (level < copy.mipLevels)
+                {
+                    // blits of sRGB formats decode to linear before filtering and encode after
+                    const auto& extent   = copy.region.imageExtent;
+                    const auto aspect    = copy.region.imageSubresource.aspectMask;
+                    const uint32_t layer = copy.region.imageSubresource.baseArrayLayer;
+
+                    vk::ImageBlit blit;
+                    blit.srcSubresource = vk::ImageSubresourceLayers(aspect, level - 1, layer, 1);
+                    blit.srcOffsets[1]  = vk::Offset3D(std::max(extent.width >> (level - 1), 1u), std::max(extent.height >> (level - 1), 1u), std::max(extent.depth >> (level - 1), 1u));
+                    blit.dstSubresource = vk::ImageSubresourceLayers(aspect, level, layer, 1);
+                    blit.dstOffsets[1]  = vk::Offset3D(std::max(extent.width >> level, 1u), std::max(extent.height >> level, 1u), std::max(extent.depth >> level, 1u));
+                    commandBuffer.blitImage(copy.dst, vk::ImageLayout::eTransferSrcOptimal, copy.dst, vk::ImageLayout::eTransferDstOptimal, blit, copy.filter, dispatcher);
+                }
+            }
+        }
+
+        // make the copies visible to every later command on the queue
+        const vk::MemoryBarrier memoryBarrier(vk::AccessFlagBits::eTransferWrite, vk::AccessFlagBits::eMemoryRead | vk::AccessFlagBits::eMemoryWrite);
+        commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eAllCommands, {}, memoryBarrier, {}, toFinalBarriers, dispatcher);
+
+        command->end();
+        command->execute(signalFence);
+
+        const uint64_t submissionIndex = command->getLastSubmissionIndex();
+        mInFlightRanges.emplace_back(InFlightRange{ submissionIndex, mHead });
+        mSubmittedHead = mHead;
+
+        for (auto& buffer : mOversizedBuffers)
+        {
+            mDevice.destroyDeferred(buffer);
+        }
+
+        mOversizedBuffers.clear();
+        mBufferCopies.clear();
+        mImageCopies.clear();
+        ++mStats.submitNum;
+
+        return submissionIndex;
+    }
+}  // namespace vk2s
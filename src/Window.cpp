@@ -22,6 +22,8 @@ namespace vk2s
         , mWindowName(windowName)
         , mDevice(device)
     {
+        assert(!mDevice.isHeadless() || !"Window can't be created with a headless Device!");
+
         initWindow(fullScreen);
         createSurface();
         createSwapChain();
@@ -31,7 +33,7 @@ namespace vk2s
 
     Window::~Window()
     {
-        mDevice.getVkDevice()->waitIdle();
+        mDevice.waitIdle();
         glfwDestroyWindow(mpWindow);
     }
 
@@ -58,7 +60,7 @@ namespace vk2s
             mWindowHeight = static_cast<uint32_t>(h);
         }
 
-        mDevice.getVkDevice()->waitIdle();
+        mDevice.waitIdle();
 
         // destroy swapchain explicitly
         mSwapChain.reset();
@@ -121,7 +123,11 @@ namespace vk2s
 
         vk::PresentInfoKHR presentInfo(waitSem.getVkSemaphore().get(), mSwapChain.get(), frameBufferIndex);
 
-        const auto res = mDevice.getVkGraphicsQueue().presentKHR(presentInfo);
+        vk::Result res = vk::Result::eSuccess;
+        {
+            std::lock_guard lock(mDevice.getVkQueueMutex());
+            res = mDevice.getVkGraphicsQueue().presentKHR(presentInfo);
+        }
 
         return (res == vk::Result::eErrorOutOfDateKHR || res == vk::Result::eSuboptimalKHR || mResized);
     }
@@ -269,18 +275,22 @@ namespace vk2s
         const auto sourceStage      = vk::PipelineStageFlagBits::eAllCommands;
         const auto destinationStage = vk::PipelineStageFlagBits::eAllCommands;
 
-        commandBuffer.begin(vk::CommandBufferBeginInfo(vk::CommandBufferUsageFlagBits::eOneTimeSubmit));
+        const auto& dispatcher = mDevice.getVkDispatcher();
+        commandBuffer.begin(vk::CommandBufferBeginInfo(vk::CommandBufferUsageFlagBits::eOneTimeSubmit), dispatcher);
         for (auto& swapChainImage : mSwapChainImages)
         {
             barrier.image = swapChainImage;
-            commandBuffer.pipelineBarrier(sourceStage, destinationStage, {}, {}, {}, barrier);
+            commandBuffer.pipelineBarrier(sourceStage, destinationStage, {}, {}, {}, barrier, dispatcher);
         }
-        commandBuffer.end();
+        commandBuffer.end(dispatcher);
         vk::SubmitInfo submitInfo(nullptr, nullptr, commandBuffer, nullptr);
 
-        mDevice.getVkGraphicsQueue().submit(submitInfo);
+        {
+            std::lock_guard lock(mDevice.getVkQueueMutex());
+            mDevice.getVkGraphicsQueue().submit(submitInfo, {}, dispatcher);
+        }
 
-        vkDevice->waitIdle();
+        mDevice.waitIdle();
         vkDevice->freeCommandBuffers(vkCommandPool.get(), commandBuffer);
     }
 